@@ -45,8 +45,7 @@
 
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Vector.h>
-#include <SkelCL/Zip.h>
-#include <SkelCL/Reduce.h>
+#include <SkelCL/ZipReduce.h>
 
 using namespace skelcl;
 
@@ -102,8 +101,8 @@ int main(int argc, char** argv)
 
   skelcl::init(skelcl::nDevices(deviceCount).deviceType(deviceType));
 
-  Zip<int(int,int)> mult("int func(int x, int y){ return x*y; }");
-  Reduce<int(int)>   sum("int func(int x, int y){ return x+y; }", "0");
+  ZipReduce<int(int,int)> dot("int func(int x, int y){ return x*y; }",
+                              "int func(int x, int y){ return x+y; }", "0");
 
   Vector<int> A(size);
   Vector<int> B(size);
@@ -111,7 +110,7 @@ int main(int argc, char** argv)
   init(A.begin(), A.end());
   init(B.begin(), B.end());
 
-  Vector<int> C = sum( mult(A, B) );
+  Vector<int> C = dot(A, B);
 
   LOG_INFO("skelcl: ", C.front());
 
@@ -42,10 +42,20 @@
 #define ALLPAIRS_H
 
 #include <istream>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef __CL_ENABLE_EXCEPTIONS
+
+#include "detail/DeviceBuffer.h"
 #include "detail/Skeleton.h"
 #include "detail/Program.h"
+#include "detail/Tuning.h"
 
 namespace skelcl {
 
@@ -104,6 +114,23 @@ template<typename> class AllPairs;
 /// Passing a Zip<Tout(Tleft, Tright)> and Reduce<T(T)> skeleton yields a better
 /// runtime than defining a function as source code, as local memory is used
 /// automatically.
+/// If the Zip skeleton only multiplies and the Reduce skeleton only adds their
+/// arguments, i.e. a matrix multiplication of float or double matrices is
+/// performed, a register blocked kernel specialized for this case is used.
+///
+/// On multiple devices every device computes a block of rows of the output
+/// matrix: the left matrix and the output use the Block distribution, the
+/// right matrix is copied to all devices and reused by later executions as
+/// long as it is not modified. If the output has too few rows for this, e.g.
+/// when it is much wider than high, every device computes a block of columns
+/// instead: both inputs are copied to all devices and the blocks are gathered
+/// on the host once the execution finished.
+///
+/// If the environment variable SKELCL_AUTOTUNE is set, the kernel variant and
+/// its tile parameters are selected by benchmarking candidate configurations
+/// on the first execution for a device and a class of matrix shapes. The
+/// fastest configuration is persisted (see detail/Tuning.h) and reused by
+/// later executions.
 ///
 /// \tparam Tleft  Type of the left input data of the skeleton.
 /// \tparam Tright Type of the right input data of the skeleton.
@@ -225,18 +252,63 @@ public:
                            Args&&... args);
 
 private:
+  // blocks holds the output buffer of every device if blocks of columns are
+  // computed and is empty otherwise
+  template <typename... Args>
+  void execute(Matrix<Tout>& output,
+               const std::vector<detail::DeviceBuffer>& blocks,
+               const Matrix<Tleft>& left, const Matrix<Tright>& right,
+               Args&&... args);
+
+  template <typename... Args>
+  cl::Event launch(const detail::tuning::AllPairsConfig& config,
+                   const detail::Device& device,
+                   const detail::DeviceBuffer& outputBuffer,
+                   const Matrix<Tleft>& left, const Matrix<Tright>& right,
+                   cl_uint firstColumn, cl_uint columns, Args&&... args);
+
+  template <typename... Args>
+  const detail::tuning::AllPairsConfig&
+    configFor(const detail::Device& device,
+              const detail::DeviceBuffer& outputBuffer,
+              const Matrix<Tleft>& left, const Matrix<Tright>& right,
+              cl_uint firstColumn, cl_uint columns, Args&&... args);
+
   template <typename... Args>
-  void execute(Matrix<Tout>& output, const Matrix<Tleft>& left,
-               const Matrix<Tright>& right, Args&&... args);
+  detail::tuning::AllPairsConfig
+    tune(const detail::Device& device,
+         const detail::DeviceBuffer& outputBuffer,
+         const Matrix<Tleft>& left, const Matrix<Tright>& right,
+         cl_uint firstColumn, cl_uint columns, Args&&... args);
 
-  detail::Program createAndBuildProgramSpecial() const;
+  const detail::Program& program(const detail::tuning::AllPairsConfig& config);
+
+  std::string sourceHash() const;
+
+  bool isMatrixMultiplication() const;
+
+  detail::Program createAndBuildProgramSpecial(
+      const detail::tuning::AllPairsConfig& config) const;
 
   detail::Program createAndBuildProgramGeneral() const;
 
-  void prepareInput(const Matrix<Tleft>& left, const Matrix<Tright>& right);
+  bool splitByColumns(const Matrix<Tleft>& left,
+                      const Matrix<Tright>& right) const;
+
+  void prepareInput(const Matrix<Tleft>& left, const Matrix<Tright>& right,
+                    bool byColumns);
+
+  void gatherColumns(const Matrix<Tout>& output,
+                     const std::vector<detail::DeviceBuffer>& blocks) const;
+
+  static std::pair<unsigned int, unsigned int>
+    columnRange(size_t width, size_t index, size_t devices);
+
+  static std::vector<detail::DeviceBuffer>
+    createColumnBlocks(const Matrix<Tout>& output);
 
   void prepareOutput(Matrix<Tout>& output, const Matrix<Tleft>& left,
-                     const Matrix<Tright>& right);
+                     const Matrix<Tright>& right, bool byColumns);
 
   // used by special implementation
   std::string _srcReduce;
@@ -250,10 +322,13 @@ private:
   std::string _funcUser;
 
   // used by both implementations
-  unsigned int _C;
-  unsigned int _R;
-  unsigned int _S;
+  detail::tuning::AllPairsConfig _config;
   detail::Program _program;
+
+  // programs built for tuned configurations of the special implementation
+  std::map<std::string, std::unique_ptr<detail::Program>> _tunedPrograms;
+  // tuned configurations by device and shape class
+  std::map<std::string, detail::tuning::AllPairsConfig> _tunedConfigs;
 };
 
 } // namespace skelcl
@@ -0,0 +1,163 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file Convolution.h
+///
+#ifndef CONVOLUTION_H_
+#define CONVOLUTION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "detail/Padding.h"
+#include "detail/Skeleton.h"
+#include "detail/Program.h"
+
+namespace skelcl {
+
+/// \cond
+/// Don't show this forward declarations in doxygen
+template <typename> class Matrix;
+template <typename> class Out;
+
+template <typename> class Convolution;
+/// \endcond
+
+///
+/// \defgroup convolution Convolution Skeleton
+///
+/// \brief The Convolution skeleton applies a separable filter to a Matrix on
+///        one or more devices.
+///
+/// \ingroup skeletons
+///
+
+///
+/// \brief This class implements the Convolution skeleton, which applies a
+///        separable filter, e.g. a Gaussian blur, to a Matrix.
+///
+/// On creation the skeleton is customized with two vectors of coefficients,
+/// one for the rows and one for the columns. Both have to consist of an odd
+/// number of elements, 2*r+1 coefficients define a filter with radius r in the
+/// corresponding direction. The coefficients are compiled into the kernel as
+/// __constant arrays.
+///
+/// More formally: When rc and cc are the row and column coefficients with
+/// radii rx and ry, the skeleton computes for every element of the Matrix m:
+///
+///   out[y][x] = sum_j cc[j] * (sum_i rc[i] * m[y+j-ry][x+i-rx])
+///
+/// This is computed in two passes: the first one filters each row using a one
+/// dimensional tile of the row in local memory, the second one filters each
+/// column of the result. Therefore, every element requires O(rx + ry)
+/// operations instead of O(rx * ry) as with the MapOverlap skeleton.
+/// Accesses outside of the Matrix are handled according to the Padding mode.
+///
+/// \tparam Tin   The type of the elements stored in the input Matrix.
+/// \tparam Tout  The type of the coefficients and of the elements stored in
+///               the output Matrix.
+///
+/// \ingroup skeletons
+/// \ingroup convolution
+///
+template <typename Tin, typename Tout>
+class Convolution<Tout(Tin)> : public detail::Skeleton {
+public:
+  ///
+  /// \brief Constructor taking the coefficients for the rows and the columns
+  ///        and the Padding mode as arguments.
+  ///
+  /// \param rowCoefficients    The 2*rx+1 coefficients applied along each row.
+  /// \param columnCoefficients The 2*ry+1 coefficients applied along each
+  ///                           column.
+  /// \param padding  The Padding mode for handling out of bound accesses.
+  /// \param neutral_element The neutral element used by the NEUTRAL mode.
+  ///
+  Convolution<Tout(Tin)>(const std::vector<Tout>& rowCoefficients,
+                         const std::vector<Tout>& columnCoefficients,
+                         detail::Padding padding = detail::Padding::NEAREST,
+                         Tin neutral_element = Tin());
+
+  ///
+  /// \brief Executes the skeleton on the provided input Matrix. The
+  ///        resulting data is stored in a newly created output Matrix and
+  ///        the Matrix is returned.
+  ///
+  /// \param in     The input Matrix which is filtered.
+  ///
+  /// \return A newly created Matrix storing the filtered elements.
+  ///
+  Matrix<Tout> operator()(const Matrix<Tin>& in);
+
+  ///
+  /// \brief Executes the skeleton on the provided input Matrix. The
+  ///        resulting data is stored in the provided output Matrix and a
+  ///        reference to this Matrix is returned.
+  ///
+  /// \param output The output Matrix in which the resulting data is stored.
+  ///               The utility function skelcl::out() can be used to create
+  ///               the required wrapper.
+  /// \param in     The input Matrix which is filtered.
+  ///
+  /// \return A reference to the provided output Matrix.
+  ///
+  Matrix<Tout>& operator()(Out<Matrix<Tout>> output, const Matrix<Tin>& in);
+
+private:
+  void execute(Matrix<Tout>& output, Matrix<Tout>& temp,
+               const Matrix<Tin>& in);
+
+  detail::Program createAndBuildProgram() const;
+
+  void prepareInput(const Matrix<Tin>& in);
+
+  void prepareOutput(Matrix<Tout>& output, const Matrix<Tin>& in);
+
+  static std::string coefficientsToString(const std::vector<Tout>& c);
+
+  std::vector<Tout> _rowCoefficients;
+  std::vector<Tout> _columnCoefficients;
+  unsigned int _rowRadius;
+  unsigned int _columnRadius;
+  detail::Padding _padding;
+  Tin _neutral_element;
+  detail::Program _program;
+};
+
+} // namespace skelcl
+
+#include "detail/ConvolutionDef.h"
+
+#endif // CONVOLUTION_H_
@@ -45,6 +45,7 @@
 #include "detail/Distribution.h"
 #include "detail/BlockDistribution.h"
 #include "detail/OLDistribution.h"
+#include "detail/OverlapDistribution.h"
 #include "detail/CopyDistribution.h"
 #include "detail/SingleDistribution.h"
 
@@ -360,6 +361,30 @@ std::unique_ptr<Distribution<C<T>>>
             new Distribution<C<T>>(dist) );
 }
 #else
+// The OverlapDistribution is only available for vectors
+template <typename OutT, typename InT>
+struct OverlapConverter {
+  static std::unique_ptr<Distribution<OutT>>
+    cloneAndConvert(const Distribution<InT>& /*dist*/)
+  {
+    return nullptr;
+  }
+};
+
+template <typename T, typename U>
+struct OverlapConverter<Vector<T>, Vector<U>> {
+  static std::unique_ptr<Distribution<Vector<T>>>
+    cloneAndConvert(const Distribution<Vector<U>>& dist)
+  {
+    auto overlap = dynamic_cast<const OverlapDistribution<Vector<U>>*>(&dist);
+    if (overlap != nullptr) {
+      return std::unique_ptr<Distribution<Vector<T>>>(
+        new OverlapDistribution<Vector<T>>(*overlap));
+    }
+    return nullptr;
+  }
+};
+
 // This solution works in visual studio, but does not enforce, that OutT and
 // InT are of the same container type ...
 template <typename OutT, typename InT>
@@ -394,6 +419,12 @@ std::unique_ptr<Distribution<OutT>>
         new OLDistribution<OutT>(*ol));
     }
 
+    // overlap distribution (vectors only)
+    auto overlap = OverlapConverter<OutT, InT>::cloneAndConvert(dist);
+    if (overlap != nullptr) {
+      return overlap;
+    }
+
     // default distribution
     return std::unique_ptr<Distribution<OutT>>(
       new Distribution<OutT>(dist));
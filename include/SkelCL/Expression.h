@@ -0,0 +1,163 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file Expression.h
+///
+
+#ifndef EXPRESSION_H_
+#define EXPRESSION_H_
+
+#include <functional>
+#include <memory>
+
+#include "Distributions.h"
+#include "detail/ExpressionNode.h"
+
+namespace skelcl {
+
+/// \cond
+/// Don't show this forward declarations in doxygen
+template <typename> class Out;
+template <typename> class Vector;
+/// \endcond
+
+///
+/// \brief An Expression is the lazily evaluated result of a chain of
+///        element-wise skeleton calls.
+///
+/// Calling a Map or Zip skeleton with an Expression as input does not launch
+/// a kernel, but returns a new Expression recording the call. When the result
+/// is consumed, i.e. eval() is called or the Expression is converted into a
+/// Vector (e.g. when it is passed to a skeleton which can not be fused, like
+/// Reduce or Scan), the user-defined functions of all recorded calls are
+/// composed into a single kernel. This kernel reads the input vectors once
+/// and writes only the final result, without creating any intermediate
+/// vectors.
+///
+/// Lazy evaluation is enabled by wrapping a vector using skelcl::lazy():
+///
+/// \code
+/// Vector<float> c = mult( add(lazy(a), b), b );
+/// \endcode
+///
+/// All vectors read by an Expression have to have the same size and have to
+/// exist until the Expression is evaluated. Additional arguments are not
+/// supported for lazily evaluated skeleton calls.
+///
+/// \tparam T The type of the elements computed by the expression.
+///
+/// \ingroup skeletons
+///
+template <typename T>
+class Expression {
+public:
+  ///
+  /// \brief Creates an expression reading the given vector.
+  ///
+  /// \param vector The vector read when the expression is evaluated.
+  ///
+  Expression(const Vector<T>& vector);
+
+  ///
+  /// \brief Creates an expression from a node of the expression graph. This
+  ///        constructor is used by the skeletons.
+  ///
+  /// \param node      The node computing the elements of the expression.
+  /// \param reference The expression of the first operand of node. The result
+  ///                  is distributed like the vectors read by this
+  ///                  expression.
+  ///
+  template <typename U>
+  Expression(detail::ExpressionNode::ptr_type node,
+             const Expression<U>& reference);
+
+  ///
+  /// \brief Returns the number of elements computed by the expression.
+  ///
+  size_t size() const;
+
+  ///
+  /// \brief Evaluates the expression using a single fused kernel and returns
+  ///        the result in a newly created vector.
+  ///
+  Vector<T> eval() const;
+
+  ///
+  /// \brief Evaluates the expression using a single fused kernel and stores
+  ///        the result in the given output vector.
+  ///
+  /// \param output The vector in which the result is stored.
+  ///
+  /// \return A reference to the output vector.
+  ///
+  Vector<T>& eval(Out<Vector<T>> output) const;
+
+  ///
+  /// \brief Evaluates the expression. Allows to pass an Expression wherever
+  ///        a Vector is expected.
+  ///
+  operator Vector<T>() const;
+
+  ///
+  /// \brief Returns the root node of the expression graph.
+  ///
+  const detail::ExpressionNode::ptr_type& node() const;
+
+private:
+  template <typename> friend class Expression;
+
+  typedef std::unique_ptr<detail::Distribution<Vector<T>>> distribution_ptr;
+
+  detail::ExpressionNode::ptr_type  _node;
+  std::function<distribution_ptr()> _distribution;
+};
+
+///
+/// \brief Wraps the given vector in an Expression, so that the skeleton calls
+///        using it as input are evaluated lazily and fused into a single
+///        kernel.
+///
+/// \param vector The vector to be wrapped. It has to exist until the
+///               expression is evaluated.
+///
+/// \return An expression reading the given vector.
+///
+template <typename T>
+Expression<T> lazy(const Vector<T>& vector);
+
+} // namespace skelcl
+
+#include "detail/ExpressionDef.h"
+
+#endif // EXPRESSION_H_
@@ -217,6 +217,14 @@ public:
   ///
   std::vector<IndexPoint>& hostBuffer() const;
 
+  ///
+  /// \brief This function should never be called as it only exists for
+  ///        compatibility reasons with the Matrix class.
+  ///
+  /// This function will always fail with an assertion.
+  ///
+  IndexPoint* hostData() const;
+
   ///
   /// \brief This function should never be called as it only exists for
   ///        compatibility reasons with the Matrix class.
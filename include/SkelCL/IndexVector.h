@@ -222,6 +222,14 @@ public:
   ///
   std::vector<Index>& hostBuffer() const;
 
+  ///
+  /// \brief This function should never be called as it only exists for
+  ///        compatibility reasons with the Matrix class.
+  ///
+  /// This function will always fail with an assertion.
+  ///
+  Index* hostData() const;
+
   ///
   /// \brief This function should never be called as it only exists for
   ///        compatibility reasons with the Matrix class.
@@ -42,6 +42,8 @@
 
 #include <istream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "detail/MapHelper.h"
 #include "detail/Skeleton.h"
@@ -54,6 +56,7 @@ namespace skelcl {
 class Index;
 class IndexPoint;
 class Source;
+template <typename> class Expression;
 template <typename> class Out;
 namespace detail { class Program; }
 
@@ -188,6 +191,11 @@ public:
   /// \param args   The values of the arguments which are passed to the
   ///               user-defined function in addition to the input container.
   ///
+  /// If the input container is too large to be stored on the devices (see
+  /// detail::streaming::isRequired()), it is streamed in chunks from the host
+  /// to the devices and the results are streamed back directly into the host
+  /// memory of the output container.
+  ///
   /// \return       A reference to the provided output container. This container
   ///               contains the elements which gets computed after invoking the
   ///               user-defined function on the input container and the
@@ -199,6 +207,69 @@ public:
                       const C<Tin>&  input,
                       Args&&... args) const;
 
+  ///
+  /// \brief Records the invocation of the skeleton on the provided lazily
+  ///        evaluated input, without launching a kernel.
+  ///
+  /// The user-defined function is fused with the functions of all other
+  /// skeleton calls recorded in the returned expression when it is evaluated.
+  /// See Expression for details.
+  ///
+  /// \param input The lazily evaluated input.
+  ///
+  /// \return An expression computing the result of this skeleton call.
+  ///
+  Expression<Tout> operator()(const Expression<Tin>& input) const;
+
+  ///
+  /// \brief Executes the skeleton on every container of a batch of
+  ///        (typically small) input containers with a single kernel launch.
+  ///
+  /// Invoking the skeleton once per container pays the costs for setting up
+  /// buffers, transferring data and launching a kernel for every container,
+  /// which dominates the runtime for containers of only a few thousand
+  /// elements. Here all input containers are packed into one container,
+  /// the skeleton is executed once on it and the results are unpacked into
+  /// the output containers using a table of the offsets of the individual
+  /// containers inside the packed one.
+  ///
+  /// \tparam C     The incomplete type of the containers used as input and
+  ///               output. C is either Vector or Matrix.
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input containers.
+  ///
+  /// \param outputs The output containers. The vector is resized to hold one
+  ///                output container for every input container and every
+  ///                output container is resized to match its input container.
+  /// \param inputs  The input containers on which the user-defined function
+  ///                is invoked.
+  /// \param args    The values of the arguments which are passed to the
+  ///                user-defined function in addition to the input
+  ///                containers. They are the same for all containers of the
+  ///                batch.
+  ///
+  /// \return A reference to the provided output containers.
+  ///
+  template <template <typename> class C,
+            typename... Args>
+  std::vector<C<Tout>>& batch(std::vector<C<Tout>>& outputs,
+                              const std::vector<C<Tin>>& inputs,
+                              Args&&... args) const;
+
+  ///
+  /// \brief Return the source code of the user defined function.
+  ///
+  /// \return The source code of the user defined function.
+  ///
+  const std::string& source() const;
+
+  ///
+  /// \brief Return the name of the user defined function.
+  ///
+  /// \return The name of the user defined function.
+  ///
+  const std::string& func() const;
+
 private:
   template <template <typename> class C,
             typename... Args>
@@ -206,8 +277,17 @@ private:
                const C<Tin>& input,
                Args&&... args) const;
 
+  template <template <typename> class C,
+            typename... Args>
+  void executeStreaming(C<Tout>& output,
+                        const C<Tin>& input,
+                        Args&&... args) const;
+
   detail::Program createAndBuildProgram(const std::string& source,
                                         const std::string& funcName) const;
+
+  const std::string _source;
+  const std::string _funcName;
 };
 
 /// 
@@ -285,6 +365,95 @@ private:
                                         const std::string& funcName) const;
 };
 
+///
+/// \brief  This version of the Map<Tout(Tin)> skeleton is used, when the
+///         user-defined function produces several values per input element,
+///         which are stored in separate output containers.
+///
+/// On creation the Map skeleton is customized with source code defining a
+/// function taking the input element followed by one pointer per output. The
+/// function writes its results through these pointers, e.g. for
+/// Map<std::tuple<float, float>(float)>:
+///
+/// \code
+/// void func(float x, float* lo, float* hi) { *lo = floor(x); *hi = ceil(x); }
+/// \endcode
+///
+/// The input container is read only once and every output container is
+/// written with coalesced accesses, instead of invoking one Map skeleton per
+/// output.
+///
+/// As all skeletons, this Map skeleton allows for passing additional
+/// arguments, which are passed to the user-defined function after the output
+/// pointers.
+///
+/// \tparam Tin   The type of the elements stored in the input container.
+/// \tparam Touts The types of the elements stored in the output containers.
+///
+/// \ingroup skeletons
+/// \ingroup map
+///
+template<typename Tin, typename... Touts>
+class Map<std::tuple<Touts...>(Tin)> : public detail::Skeleton {
+public:
+  ///
+  /// \brief Constructor taking the source code used of the user-defined
+  ///        function as argument.
+  ///
+  /// \param source   The source code of the user-defined function.
+  /// \param funcName The name of the user-defined function which should be
+  ///                 invoked by the Map skeleton
+  ///
+  Map<std::tuple<Touts...>(Tin)>(const Source& source,
+                                 const std::string& funcName
+                                                    = std::string("func"));
+
+  ///
+  /// \brief Executes the skeleton on the provided input container. The
+  ///        resulting data is stored in the provided output containers.
+  ///
+  /// \tparam C     The incomplete type of the containers used as input and
+  ///               outputs. C is either Vector or Matrix.
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param outputs The output containers, one for every type in Touts,
+  ///                created with skelcl::out().
+  /// \param input   The input container on which the user-defined function
+  ///                is invoked.
+  /// \param args    The values of the arguments which are passed to the
+  ///                user-defined function in addition to the input container.
+  ///
+  template <template <typename> class C,
+            typename... Args>
+  void operator()(Out<C<Touts>>... outputs,
+                  const C<Tin>& input,
+                  Args&&... args) const;
+
+private:
+  template <template <typename> class C,
+            typename... Args>
+  void execute(const C<Tin>& input,
+               Out<C<Touts>>... outputs,
+               Args&&... args) const;
+
+  template <template <typename> class C>
+  void prepareInput(const C<Tin>& input) const;
+
+  template <template <typename> class C>
+  void prepareOutputs(const C<Tin>& input) const;
+
+  template <template <typename> class C, typename T, typename... Ts>
+  void prepareOutputs(const C<Tin>& input,
+                      Out<C<T>> output,
+                      Out<C<Ts>>... outputs) const;
+
+  detail::Program createAndBuildProgram(const std::string& source,
+                                        const std::string& funcName) const;
+
+  const detail::Program _program;
+};
+
 /// 
 /// \brief  This version of the Map<Tout(Tin)> skeleton is executed over an
 ///         one-dimensional index space defined by an IndexVector.
@@ -40,6 +40,7 @@
 #define MapOverlap_H_
 
 #include <istream>
+#include <memory>
 #include <string>
 
 #include "detail/Padding.h"
@@ -52,6 +53,8 @@ namespace skelcl {
 /// Don't show this forward declarations in doxygen
 template <typename> class Matrix;
 template <typename> class Out;
+template <typename> class Vector;
+template <typename> class Volume;
 
 template <typename> class MapOverlap;
 /// \endcond
@@ -84,7 +87,15 @@ template <typename> class MapOverlap;
 /// f is the provided unary function, and r is the overlap range, the MapOverlap
 /// skeleton performs the calculation f(c[i-r], .., c[i], .., c[i+r]) for
 /// every i in 0 .. n-1. If an out of bound access of c occurs the Padding mode
-/// defines the behavior.
+/// defines the behavior. With CLAMP, MIRROR, and PERIODIC the out of bound
+/// index is remapped inside the kernel, so that no padding elements have to be
+/// created on the host.
+///
+/// For a Matrix the user-defined function receives an input_matrix_t and
+/// accesses the neighborhood with getData(f, x, y). For a Vector it receives a
+/// pointer into local memory pointing to the current element, so that the
+/// neighborhood can be accessed as f[-r] .. f[r]. For a Volume it receives an
+/// input_volume_t and accesses the neighborhood with getData(f, x, y, z).
 ///
 /// As all skeletons, the MapOverlap skeleton allows for passing additional
 /// arguments, i.e. arguments besides the input container, to the user defined
@@ -169,22 +180,195 @@ public:
   Matrix<Tout>& operator()(Out<Matrix<Tout>> output, const Matrix<Tin>& in,
                            Args&&... args);
 
+  ///
+  /// \brief Executes the skeleton on the provided input Vector. The
+  ///        resulting data is stored in a newly created output Vector and
+  ///        the Vector is returned.
+  ///
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param in     The input Vector on which the user-defined function is
+  ///               invoked.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \return A newly created Vector storing the elements which get computed
+  ///         after invoking the user-defined function on the input Vector
+  ///         and the additionally provided arguments.
+  ///
+  template <typename... Args>
+  Vector<Tout> operator()(const Vector<Tin>& in, Args&&... args);
+
+  ///
+  /// \brief Executes the skeleton on the provided input Vector. The
+  ///        resulting data is stored in the provided output Vector and a
+  ///        reference to this Vector is returned.
+  ///
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param output The output Vector in which the resulting data is stored.
+  ///               The utility function skelcl::out() can be used to create
+  ///               the required wrapper.
+  /// \param in     The input Vector on which the user-defined function is
+  ///               invoked.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \return A reference to the provided output Vector.
+  ///
+  template <typename... Args>
+  Vector<Tout>& operator()(Out<Vector<Tout>> output, const Vector<Tin>& in,
+                           Args&&... args);
+
+  ///
+  /// \brief Executes the skeleton on the provided input Volume. The
+  ///        resulting data is stored in a newly created output Volume and
+  ///        the Volume is returned.
+  ///
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param in     The input Volume on which the user-defined function is
+  ///               invoked.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \return A newly created Volume storing the elements which get computed
+  ///         after invoking the user-defined function on the input Volume
+  ///         and the additionally provided arguments.
+  ///
+  template <typename... Args>
+  Volume<Tout> operator()(const Volume<Tin>& in, Args&&... args);
+
+  ///
+  /// \brief Executes the skeleton on the provided input Volume. The
+  ///        resulting data is stored in the provided output Volume and a
+  ///        reference to this Volume is returned.
+  ///
+  /// The Volume is split into slabs of slices between the devices. Every
+  /// work-group loads a two dimensional tile of a slice into local memory and
+  /// streams along the slices of its slab, keeping the 2*overlap_range+1
+  /// slices accessed by the user-defined function in local memory, so that
+  /// every slice is read only once from global memory.
+  ///
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param output The output Volume in which the resulting data is stored.
+  ///               The utility function skelcl::out() can be used to create
+  ///               the required wrapper.
+  /// \param in     The input Volume on which the user-defined function is
+  ///               invoked.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \return A reference to the provided output Volume.
+  ///
+  template <typename... Args>
+  Volume<Tout>& operator()(Out<Volume<Tout>> output, const Volume<Tin>& in,
+                           Args&&... args);
+
+  ///
+  /// \brief Applies the skeleton iterations times to the provided input
+  ///        Matrix, feeding the result of every step into the next one. The
+  ///        final result is stored in the provided output Matrix and a
+  ///        reference to this Matrix is returned.
+  ///
+  /// The input is uploaded once. Afterwards the data stays on the devices
+  /// and the skeleton alternates between two device buffers. Between two
+  /// kernel launches only the boundary rows are exchanged between
+  /// neighbouring devices, instead of distributing the whole Matrix again.
+  /// Every launch performs timeSteps() steps, see setTimeSteps().
+  /// The input Matrix is not modified. This function can only be used if the
+  /// element types of the input and output Matrix are the same.
+  ///
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input container.
+  ///
+  /// \param iterations The number of times the skeleton is applied.
+  /// \param output The output Matrix in which the resulting data is stored.
+  /// \param in     The input Matrix on which the first step is performed.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in every step.
+  ///
+  /// \return A reference to the output Matrix storing the elements computed
+  ///         by the last step.
+  ///
+  template <typename... Args>
+  Matrix<Tout>& iterate(unsigned int iterations, Out<Matrix<Tout>> output,
+                        const Matrix<Tin>& in, Args&&... args);
+
+  ///
+  /// \brief Sets the number of steps performed by iterate() in a single
+  ///        kernel launch.
+  ///
+  /// With more than one step per launch a time-skewed kernel is used, which
+  /// loads a tile with a halo of steps * overlap_range elements into local
+  /// memory and applies the user-defined function repeatedly to it before
+  /// writing the result back to global memory. The halo exchanged between
+  /// devices grows accordingly, but is only exchanged once per launch.
+  ///
+  /// \param steps The number of steps per kernel launch. Must be at least 1.
+  ///
+  void setTimeSteps(unsigned int steps);
+
+  ///
+  /// \brief Returns the number of steps performed by iterate() in a single
+  ///        kernel launch.
+  ///
+  /// \return The number of steps per kernel launch.
+  ///
+  unsigned int timeSteps() const;
+
 private:
   template <typename... Args>
   void execute(Matrix<Tout>& output, const Matrix<Tin>& in, Args&&... args);
 
-  detail::Program createAndBuildProgram() const;
+  template <typename... Args>
+  void execute(Vector<Tout>& output, const Vector<Tin>& in, Args&&... args);
+
+  template <typename... Args>
+  void execute(Volume<Tout>& output, const Volume<Tin>& in, Args&&... args);
+
+  template <typename... Args>
+  void executeTemporal(Matrix<Tout>& output, const Matrix<Tin>& in,
+                       unsigned int steps, Args&&... args);
+
+  detail::Program createAndBuildProgram(unsigned int timeSteps) const;
+
+  detail::Program createAndBuildVectorProgram() const;
+
+  detail::Program createAndBuildVolumeProgram() const;
 
-  void prepareInput(const Matrix<Tin>& in);
+  void prepareInput(const Matrix<Tin>& in, unsigned int haloRows);
+
+  void prepareInput(const Vector<Tin>& in);
+
+  void prepareInput(const Volume<Tin>& in);
+
+  void prepareOutput(Vector<Tout>& output, const Vector<Tin>& in);
 
   void prepareOutput(Matrix<Tout>& output, const Matrix<Tin>& in);
 
+  void prepareOutput(Volume<Tout>& output, const Volume<Tin>& in);
+
+  void exchangeHalo(const Matrix<Tout>& matrix, unsigned int haloRows,
+                    bool updatePadding) const;
+
   std::string _userSource;
   std::string _funcName;
   unsigned int _overlap_range;
   detail::Padding _padding;
   Tin _neutral_element;
-  detail::Program _program;
+  unsigned int _time_steps;
+  // the programs are built on first use, as the user-defined function is
+  // written either for a Matrix, a Vector, or a Volume
+  std::unique_ptr<detail::Program> _program;
+  std::unique_ptr<detail::Program> _temporalProgram;
+  std::unique_ptr<detail::Program> _vectorProgram;
+  std::unique_ptr<detail::Program> _volumeProgram;
 };
 
 } //namespace skelcl
@@ -0,0 +1,180 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapReduce.h
+///
+
+#ifndef MAP_REDUCE_H_
+#define MAP_REDUCE_H_
+
+#include <istream>
+#include <string>
+
+#include "Source.h"
+
+#include "detail/Program.h"
+#include "detail/Skeleton.h"
+
+namespace skelcl {
+
+/// \cond
+/// Don't show this forward declarations in doxygen
+template <typename> class Out;
+template <typename> class Vector;
+
+template <typename> class MapReduce;
+/// \endcond
+
+///
+/// \defgroup mapreduce MapReduce Skeleton
+///
+/// \brief The MapReduce skeleton describes a calculation on a Vector performed
+///        in parallel on a device. A unary user-defined function is applied to
+///        every item of the input Vector and the results are reduced to a
+///        scalar value using a binary user-defined function.
+///
+/// \ingroup skeletons
+///
+
+///
+/// \brief An instance of the MapReduce class describes a fused map and
+///        reduction calculation customized by a unary and a binary
+///        user-defined function.
+///
+/// More formally: When v is a Vector of length n with items v[0] .. v[n-1],
+/// f is the provided unary and + the provided binary function, the MapReduce
+/// skeleton calculates the output value y as follows:
+/// y = f(v[0]) + f(v[1]) + ... + f(v[n-1]).
+/// The binary function has to be associative and commutative.
+///
+/// In contrast to a Map followed by a Reduce no intermediate Vector is
+/// created, as f is applied while the items are accumulated.
+///
+/// \tparam Tin  Type of the input data of the skeleton.
+/// \tparam Tout Type of the output data of the skeleton.
+///
+/// \ingroup skeletons
+/// \ingroup mapreduce
+///
+template <typename Tin, typename Tout>
+class MapReduce<Tout(Tin)> : public detail::Skeleton {
+public:
+  ///
+  /// \brief Constructor taking the source code of the unary and the binary
+  ///        function used to customize the MapReduce skeleton.
+  ///
+  /// \param mapSource    Source code defining the unary function.
+  ///
+  /// \param reduceSource Source code defining the binary function.
+  ///
+  /// \param id           Identity for the binary function. It is the result
+  ///                     for an empty input.
+  ///
+  /// \param mapFunc      Name of the unary function defined in mapSource.
+  ///
+  /// \param reduceFunc   Name of the binary function defined in reduceSource.
+  ///
+  MapReduce(const Source& mapSource, const Source& reduceSource,
+            const std::string& id = "0",
+            const std::string& mapFunc = "func",
+            const std::string& reduceFunc = "func");
+
+  ///
+  /// \brief Function call operator. Executes the skeleton on the data provided
+  ///        as argument input and args. The resulting data is returned as a
+  ///        moved copy.
+  ///
+  /// \param input The input data for the skeleton managed inside a Vector.
+  ///              If no distribution is set the Block distribution is used.
+  ///              With the Block distribution every device reduces its part
+  ///              of the input and the partial results are combined
+  ///              afterwards.
+  ///
+  /// \param args  Additional arguments which are passed to the unary
+  ///              function. The binary function must not take additional
+  ///              arguments.
+  ///
+  template <typename... Args>
+  Vector<Tout> operator()(const Vector<Tin>& input, Args&&... args);
+
+  ///
+  /// \brief Function call operator. Executes the skeleton on the data provided
+  ///        as argument input and args. The resulting data is stored in the
+  ///        provided Vector output. A reference to the output Vector is
+  ///        returned to allow for chaining skeleton calls.
+  ///
+  /// \param output The Vector storing the result of the execution of the
+  ///               skeleton in its first item.
+  ///               The distribution of the container might change.
+  ///
+  /// \param input  The input data for the skeleton managed inside a Vector.
+  ///               If no distribution is set the Block distribution is used.
+  ///
+  /// \param args   Additional arguments which are passed to the unary
+  ///               function.
+  ///
+  template <typename... Args>
+  Vector<Tout>& operator()(Out<Vector<Tout>> output, const Vector<Tin>& input,
+                           Args&&... args);
+
+private:
+  void prepareInput(const Vector<Tin>& input);
+
+  void prepareOutput(Vector<Tout>& output,
+                     const detail::Device::ptr_type& devicePtr);
+
+  size_t numberOfGroups(const detail::Device& device, size_t data_size) const;
+
+  template <typename... Args>
+  void executeMapReduce(const detail::Device& device,
+                        const detail::DeviceBuffer& input,
+                        const detail::DeviceBuffer& output,
+                        size_t data_size, size_t groups, Args&&... args);
+
+  detail::Program createAndBuildProgram() const;
+
+  std::string _srcMap;
+  std::string _srcReduce;
+  std::string _funcMap;
+  std::string _funcReduce;
+  std::string _idReduce;
+
+  detail::Program _program;
+};
+
+} // namespace skelcl
+
+#include "detail/MapReduceDef.h"
+
+#endif // MAP_REDUCE_H_
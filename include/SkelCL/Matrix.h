@@ -55,6 +55,7 @@
 #include "detail/Device.h"
 #include "detail/DeviceBuffer.h"
 #include "detail/Distribution.h"
+#include "detail/MappedFile.h"
 #include "detail/Padding.h"
 #include "detail/skelclDll.h"
 
@@ -264,6 +265,15 @@ public:
          const detail::Distribution<Matrix<T>>& distribution
             = detail::Distribution<Matrix<T>>());
 
+  ///
+  /// \brief Constructor taking over the elements of a std::vector without
+  ///        copying them. After this call vector is empty.
+  ///
+  Matrix(std::vector<T>&& vector,
+         const size_type size,
+         const detail::Distribution<Matrix<T>>& distribution
+            = detail::Distribution<Matrix<T>>());
+
   ///
   /// \brief static function creating a matrix from 2 dim std::vector as
   ///        parameter
@@ -273,6 +283,21 @@ public:
                                     distribution
                                       = detail::Distribution<Matrix<T>>());
 
+  ///
+  /// \brief static function creating a matrix whose elements are stored on
+  ///        the host in the memory mapped file at path. Uploads read directly
+  ///        from and downloads write directly into the mapped file.
+  ///
+  /// Functions exposing iterators or the host buffer copy the elements into
+  /// storage owned by the Matrix first, which ends the use of the file.
+  ///
+  static Matrix<T> mapFile(const std::string& path,
+                           const typename size_type::size_type rowCount,
+                           const typename size_type::size_type columnCount,
+                           detail::MapMode mode = detail::MapMode::READ,
+                           const detail::Distribution<Matrix<T>>& distribution
+                              = detail::Distribution<Matrix<T>>());
+
   ///
   /// \brief constructor with 2 iterators and the number of columns as parameter
   ///
@@ -401,10 +426,29 @@ public:
 
   void dataOnHostModified() const;
 
+  bool hostIsUpToDate() const;
+
+  bool devicesAreUpToDate() const;
+
+  // Recreates and uploads the device buffers again if they have been evicted
+  // by the memory manager.
   const detail::DeviceBuffer& deviceBuffer(const detail::Device& device)const;
 
   host_buffer_type& hostBuffer() const;
 
+  ///
+  /// \brief Returns a pointer to the first element stored on the host. The
+  ///        data is not downloaded from the devices by this function.
+  ///
+  pointer hostData() const;
+
+  ///
+  /// \brief Moves the elements into the returned std::vector, downloading
+  ///        them from the devices first if necessary. Afterwards the Matrix
+  ///        is empty.
+  ///
+  host_buffer_type release();
+
   static std::string deviceFunctions();
 
 private:
@@ -421,6 +465,11 @@ private:
   std::string getInfo() const;
   std::string getDebugInfo() const;
 
+  void detachHostPointer() const;
+
+  void restoreEvictedDeviceBuffers() const;
+
+  void evictDeviceBuffers() const;
 
   static RegisterMatrixDeviceFunctions<T> registerMatrixDeviceFunctions;
 
@@ -430,6 +479,9 @@ private:
   mutable bool                                        _hostBufferUpToDate;
   mutable bool                                        _deviceBuffersUpToDate;
   mutable host_buffer_type                            _hostBuffer;
+  // _hostPointer != nullptr => mapped memory is used instead of _hostBuffer
+  mutable pointer                                     _hostPointer;
+  mutable std::shared_ptr<detail::MappedFile>         _mappedFile;
     // _deviceBuffers empty => buffers not created
   mutable std::map< detail::Device::id_type,
                     detail::DeviceBuffer >            _deviceBuffers;
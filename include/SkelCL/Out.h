@@ -47,6 +47,7 @@ namespace skelcl {
 /// \cond
 /// Don't show this forward declarations in doxygen
 template <typename> class Out;
+template <typename...> class SoAVector;
 /// \endcond
 
 ///
@@ -96,6 +97,36 @@ Out<ContainerType<T>> out(ContainerType<T>& c)
   return Out<ContainerType<T>>(c);
 }
 
+///
+/// \brief Wrapper marking all fields of a SoAVector as modified on the
+///        device after the skeleton is executed. See Out.
+///
+template <typename... Fields>
+class Out<SoAVector<Fields...>> {
+public:
+  Out<SoAVector<Fields...>>(SoAVector<Fields...>& c)
+    : _container(c)
+  {}
+
+  SoAVector<Fields...>& container() const
+  {
+    return _container;
+  }
+private:
+  SoAVector<Fields...>& _container;
+};
+
+///
+/// \brief Helper function to create a Out wrapper object for a SoAVector.
+///
+/// \param c SoAVector to be wrapped
+///
+template <typename... Fields>
+Out<SoAVector<Fields...>> out(SoAVector<Fields...>& c)
+{
+  return Out<SoAVector<Fields...>>(c);
+}
+
 } // namespace skelcl
 
 #endif // OUT_H_
@@ -43,6 +43,7 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Source.h"
 
@@ -118,11 +119,10 @@ public:
   ///        moved copy.
   ///
   /// \param input The input data for the skeleton managed inside a Vector.
-  ///              If no distribution is set the Single distribution using the
-  ///              device with id 0 is used.
-  ///              Currently only the Single distribution is supported for the
-  ///              input Vector! This will certainly be advanced in a future
-  ///              version.
+  ///              If no distribution is set the Block distribution is used.
+  ///              With the Block distribution every device reduces its part
+  ///              of the input and the partial results are combined
+  ///              afterwards.
   ///
   /// \param args  Additional arguments which are passed to the function
   ///              named by funcName and defined in the source code at created.
@@ -145,11 +145,10 @@ public:
   ///               The distribution of the container might change.
   ///
   /// \param input  The input data for the skeleton managed inside a Vector.
-  ///               If no distribution is set the Single distribution using the
-  ///               device with id 0 is used.
-  ///               Currently only the Single distribution is supported for the
-  ///               input vector! This will certainly be advanced in a future
-  ///               version.
+  ///               If no distribution is set the Block distribution is used.
+  ///               With the Block distribution every device reduces its part
+  ///               of the input and the partial results are combined
+  ///               afterwards.
   ///
   /// \param args   Additional arguments which are passed to the function
   ///               named by funcName and defined in the source code at
@@ -157,10 +156,40 @@ public:
   ///               same order here as they where defined in the funcName 
   ///               function declaration.
   ///
+  /// If the input Vector is too large to be stored on the devices, it is
+  /// streamed in chunks through all devices. Every chunk is reduced to a
+  /// single value and these partial results are reduced afterwards.
+  ///
   template <typename... Args>
   Vector<T>& operator()(Out<Vector<T>> output, const Vector<T>& input,
                         Args&&... args);
 
+  ///
+  /// \brief Reduces every Vector of a batch of (typically small) input
+  ///        Vectors with a single kernel launch.
+  ///
+  /// All input Vectors are packed into one Vector and every one of them is
+  /// reduced by a work-group of its own, using a table of the offsets of the
+  /// individual Vectors inside the packed one. The batch is processed on a
+  /// single device.
+  ///
+  /// \param output The Vector storing the result of the i-th input Vector in
+  ///               its i-th item. The result of an empty input Vector is the
+  ///               identity. The Vector is resized to the number of input
+  ///               Vectors and its distribution might change.
+  ///
+  /// \param inputs The input Vectors which are reduced.
+  ///
+  /// \param args   Additional arguments which are passed to the function
+  ///               named by funcName. They are the same for all Vectors of the
+  ///               batch.
+  ///
+  /// \return A reference to the output Vector.
+  ///
+  template <typename... Args>
+  Vector<T>& batch(Out<Vector<T>> output, const std::vector<Vector<T>>& inputs,
+                   Args&&... args);
+
   ///
   /// \brief Return the source code of the user defined function.
   ///
@@ -188,11 +217,22 @@ private:
   void prepareOutput(Vector<T>& output, const Vector<T>& input,
                      const size_t size);
 
+  size_t localSize(const detail::Device& device) const;
+
+  size_t numberOfGroups(const detail::Device& device, size_t data_size) const;
+
+  template <typename... Args>
+  cl::Kernel prepareKernel(const detail::Device& device,
+                           const detail::DeviceBuffer& input,
+                           const detail::DeviceBuffer& output,
+                           size_t data_size, size_t local_size,
+                           Args&&... args);
+
   template <typename... Args>
   void execute_first_step(const detail::Device& device,
                           const detail::DeviceBuffer& input,
                           detail::DeviceBuffer& output, size_t data_size,
-                          size_t global_size, Args&&... args);
+                          size_t groups, Args&&... args);
 
   template <typename... Args>
   void execute_second_step(const detail::Device& device,
@@ -200,8 +240,22 @@ private:
                            detail::DeviceBuffer& output, size_t data_size,
                            Args&&... args);
 
+  template <typename... Args>
+  void executeMultiDevice(Out<Vector<T>> output, const Vector<T>& input,
+                          Args&&... args);
+
+  template <typename... Args>
+  void executeStreaming(Out<Vector<T>> output, const Vector<T>& input,
+                        Args&&... args);
+
   skelcl::detail::Program createPrepareAndBuildProgram();
 
+  const skelcl::detail::Program& segmentsProgram();
+
+  skelcl::detail::Program createSegmentsProgram() const;
+
+  static std::string vectorType();
+
   /// Literal describing the identity of type T in respect to the operation
   /// performed by the reduction and described in function named _funcName
   std::string _id;
@@ -214,6 +268,8 @@ private:
 
   /// Program
   skelcl::detail::Program _program;
+  /// Program for reducing batches, built on first use
+  std::unique_ptr<skelcl::detail::Program> _segmentsProgram;
 };
 
 } // namespace skelcl
@@ -41,10 +41,13 @@
 #define SCAN_H_
 
 #include <istream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "detail/Skeleton.h"
 #include "detail/Program.h"
+#include "detail/ScanMode.h"
 
 namespace skelcl {
 
@@ -72,6 +75,13 @@ template<typename> class Scan;
 /// \brief An instance of the Reduce class describes a scan (a.k.a. prefix sum)
 ///        calculation customized by a given binary user-defined function.
 ///
+/// The scan is either exclusive (the default) or inclusive. Additionally, a
+/// segmented scan restarting at every flagged element is provided.
+///
+/// On GPUs the scan is performed in a single pass using a decoupled look-back
+/// between work-groups, otherwise multiple passes are used. The environment
+/// variable SKELCL_SCAN_SINGLE_PASS (0 or 1) overrides this choice.
+///
 /// \tparam T Type of the input and output data of the skeleton.
 ///
 /// \ingroup skeletons
@@ -94,9 +104,12 @@ public:
   /// \param funcName Name of the 'main' function (the starting point) of the
   ///                 given source code
   ///
+  /// \param mode     Whether an exclusive or an inclusive scan is performed
+  ///
   Scan(const Source& source,
        const std::string& id = "0",
-       const std::string& funcName = std::string("func"));
+       const std::string& funcName = std::string("func"),
+       detail::ScanMode mode = detail::ScanMode::EXCLUSIVE);
 
   ///
   /// \brief Function call operator. Executes the skeleton on the data provided
@@ -104,11 +117,10 @@ public:
   ///        moved copy.
   ///
   /// \param input The input data for the skeleton managed inside a Vector.
-  ///              If no distribution is set the Single distribution using the
-  ///              device with id 0 is used.
-  ///              Currently only the Single distribution is supported for the
-  ///              input Vector! This will certainly be advanced in a future
-  ///              version.
+  ///              If no distribution is set the Block distribution is used.
+  ///              For a Block distributed input every device scans its block
+  ///              and the totals of the preceding blocks are combined into
+  ///              each block afterwards.
   ///
   /// \param args  Additional arguments which are passed to the function
   ///              named by funcName and defined in the source code at created.
@@ -131,11 +143,10 @@ public:
   ///               The distribution of the container might change.
   ///
   /// \param input The input data for the skeleton managed inside a Vector.
-  ///              If no distribution is set the Single distribution using the
-  ///              device with id 0 is used.
-  ///              Currently only the Single distribution is supported for the
-  ///              input Vector! This will certainly be advanced in a future
-  ///              version.
+  ///              If no distribution is set the Block distribution is used.
+  ///              For a Block distributed input every device scans its block
+  ///              and the totals of the preceding blocks are combined into
+  ///              each block afterwards.
   ///
   /// \param args  Additional arguments which are passed to the function
   ///              named by funcName and defined in the source code at created.
@@ -148,12 +159,83 @@ public:
                         const Vector<T>& input,
                         Args&&... args);
 
+  ///
+  /// \brief Performs a segmented scan. Every element whose flag is not 0
+  ///        starts a new segment, i.e. the scan restarts at this element.
+  ///        The resulting data is returned as a moved copy.
+  ///
+  /// \param input The input data for the skeleton managed inside a Vector.
+  ///              The segmented scan is performed on a single device. If the
+  ///              input is not distributed to exactly one device the Single
+  ///              distribution is used.
+  ///
+  /// \param flags The segment head flags. Must have the same size as input.
+  ///
+  /// \param args  Additional arguments which are passed to the function
+  ///              named by funcName and defined in the source code at created.
+  ///
+  template <typename... Args>
+  Vector<T> segmented(const Vector<T>& input,
+                      const Vector<int>& flags,
+                      Args&&... args);
+
+  ///
+  /// \brief Performs a segmented scan. Every element whose flag is not 0
+  ///        starts a new segment, i.e. the scan restarts at this element.
+  ///        The resulting data is stored in the provided Vector output.
+  ///
+  /// \param output The Vector storing the result of the execution of the
+  ///               skeleton. A reference to this container is also returned.
+  ///
+  /// \param input  The input data for the skeleton managed inside a Vector.
+  ///
+  /// \param flags  The segment head flags. Must have the same size as input.
+  ///
+  /// \param args   Additional arguments which are passed to the function
+  ///               named by funcName and defined in the source code at created.
+  ///
+  template <typename... Args>
+  Vector<T>& segmented(Out<Vector<T>> output,
+                       const Vector<T>& input,
+                       const Vector<int>& flags,
+                       Args&&... args);
+
 private:
   template <typename... Args>
   void execute(Vector<T>& output,
                const Vector<T>& input,
                Args&&... args);
+
+  template <typename... Args>
+  void executeSegmented(Vector<T>& output,
+                        const Vector<T>& input,
+                        const Vector<int>& flags,
+                        Args&&... args);
   
+  template <typename... Args>
+  cl::Event scanOnDevice(const detail::Device::ptr_type& devicePtr,
+                         const detail::DeviceBuffer& inputBuffer,
+                         const detail::DeviceBuffer& outputBuffer,
+                         detail::ScanMode mode,
+                         T* total,
+                         Args&&... args);
+
+  bool useSinglePass(const detail::Device& device) const;
+
+  template <typename... Args>
+  cl::Event performSinglePassScan(const detail::Device::ptr_type& devicePtr,
+                                  const detail::DeviceBuffer& inputBuffer,
+                                  const detail::DeviceBuffer& outputBuffer,
+                                  detail::ScanMode mode,
+                                  T* total,
+                                  Args&&... args);
+
+  template <typename... Args>
+  void addOffset(const detail::Device::ptr_type& devicePtr,
+                 const detail::DeviceBuffer& outputBuffer,
+                 const T& offset,
+                 Args&&... args);
+
   size_t calculateNumberOfPasses(size_t workGroupSize,
                                  size_t elements) const;
 
@@ -163,19 +245,31 @@ private:
                            size_t elements,
                            const detail::Device::ptr_type& devicePtr);
 
+  template <typename... Args>
   void performScanPasses(size_t passes,
                          size_t wgSize,
                          const detail::Device::ptr_type& devicePtr,
                          const std::vector<detail::DeviceBuffer>& tmpBuffers,
                          const detail::DeviceBuffer& inputBuffer,
-                         const detail::DeviceBuffer& outputBuffer);
+                         const detail::DeviceBuffer& outputBuffer,
+                         detail::ScanMode mode,
+                         Args&&... args);
 
+  template <typename... Args>
   void performUniformCombination(size_t passes,
                                  size_t wgSize,
                                  const detail::Device::ptr_type& devicePtr,
                                  const std::vector<detail::DeviceBuffer>&
                                     tmpBuffers,
-                                 const detail::DeviceBuffer& outputBuffer);
+                                 const detail::DeviceBuffer& outputBuffer,
+                                 Args&&... args);
+
+  template <typename... Args>
+  void performSegmentedScan(const detail::Device::ptr_type& devicePtr,
+                            const detail::DeviceBuffer& inputBuffer,
+                            const detail::DeviceBuffer& flagsBuffer,
+                            const detail::DeviceBuffer& outputBuffer,
+                            Args&&... args);
 
   void prepareInput(const Vector<T>& input);
 
@@ -187,6 +281,12 @@ private:
                                         const std::string& funcName) const;
 
   const detail::Program _program;
+
+  detail::ScanMode _mode;
+
+  /// tile status buffers of the single pass scan cached for every device
+  std::map<detail::Device::id_type,
+           std::vector<detail::DeviceBuffer>> _tileStatus;
 };
 
 } // namespace skelcl
@@ -0,0 +1,205 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file SoAVector.h
+///
+
+#ifndef SOA_VECTOR_H_
+#define SOA_VECTOR_H_
+
+#include <tuple>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include "Vector.h"
+
+#include "detail/Device.h"
+#include "detail/Distribution.h"
+
+namespace skelcl {
+
+/// \brief The SoAVector class is a one dimensional container storing records
+///        with the fields Fields... as a struct of arrays.
+///
+/// Instead of storing every record as a struct (like Vector<Pixel> does),
+/// every field is stored in its own Vector, i.e. in its own DeviceBuffer on
+/// every device. Kernels accessing only some fields of the records,
+/// therefore, load only the required data and neighboring work-items access
+/// neighboring elements of the same buffer (coalesced memory access).
+///
+/// Every field can be processed on its own by passing field<I>() to a
+/// skeleton. If a SoAVector is passed as additional argument to a skeleton,
+/// e.g. Map or Zip, the buffers of all fields are passed to the user
+/// function, which has to declare one pointer parameter per field:
+///
+/// \code
+/// SoAVector<float, float> particles(n); // position and velocity
+///
+/// Map<void(Index)> step("void func(Index i, __global float* pos, "
+///                       "                 __global float* vel, float dt) "
+///                       "{ pos[i] += vel[i] * dt; }");
+/// step(IndexVector(n), out(particles), 0.1f);
+/// \endcode
+///
+/// \tparam Fields The types of the fields of the stored records
+///
+/// \ingroup containers
+/// \ingroup vector
+///
+template <typename... Fields>
+class SoAVector {
+  static_assert(sizeof...(Fields) > 0, "A SoAVector needs at least one field");
+public:
+  typedef size_t size_type;
+
+  /// \brief The type of the field with index I
+  template <size_t I>
+  struct field_type {
+    typedef typename std::tuple_element<I, std::tuple<Fields...>>::type type;
+  };
+
+  /// \brief Creates a new empty SoAVector.
+  ///
+  SoAVector();
+
+  /// \brief Creates a new SoAVector with size records. Every field is value
+  ///        initialized.
+  ///
+  /// \param size The number of records to be stored
+  ///
+  explicit SoAVector(const size_type size);
+
+  /// \brief Creates a new SoAVector from the given Vectors, one for every
+  ///        field. The Vectors are moved into the SoAVector, therefore, no
+  ///        data is copied.
+  ///
+  /// \param fields Vectors of equal size storing the fields of the records
+  ///
+  explicit SoAVector(Vector<Fields>&&... fields);
+
+  SoAVector(const SoAVector<Fields...>& rhs) = default;
+
+  SoAVector<Fields...>& operator=(const SoAVector<Fields...>& rhs) = default;
+
+  SoAVector(SoAVector<Fields...>&& rhs);
+
+  SoAVector<Fields...>& operator=(SoAVector<Fields...>&& rhs);
+
+  /// \brief Returns the number of records stored
+  ///
+  size_type size() const;
+
+  /// \brief Returns true if no records are stored
+  ///
+  bool empty() const;
+
+  /// \brief Resizes every field to hold size records
+  ///
+  void resize(size_type size);
+
+  /// \brief Returns the number of fields of every record
+  ///
+  static constexpr size_t fieldCount() { return sizeof...(Fields); }
+
+  /// \brief Returns the Vector storing the field with index I of all records
+  ///
+  template <size_t I>
+  Vector<typename field_type<I>::type>& field();
+
+  /// \brief Returns the Vector storing the field with index I of all records
+  ///
+  template <size_t I>
+  const Vector<typename field_type<I>::type>& field() const;
+
+  /// \brief Returns the field with index I of the n-th record
+  ///
+  template <size_t I>
+  typename field_type<I>::type& get(size_type n);
+
+  /// \brief Returns the field with index I of the n-th record
+  ///
+  template <size_t I>
+  const typename field_type<I>::type& get(size_type n) const;
+
+  /// \brief Returns true if all fields have a valid distribution
+  ///
+  bool isDistributionValid() const;
+
+  /// \brief Sets the given distribution for every field
+  ///
+  template <typename U>
+  void setDistribution(const detail::Distribution<Vector<U>>&
+                          distribution) const;
+
+  /// \brief Creates the device buffers of every field
+  ///
+  void createDeviceBuffers() const;
+
+  /// \brief Starts uploading every field to the devices
+  ///
+  void startUpload() const;
+
+  /// \brief Copies every field to the devices
+  ///
+  void copyDataToDevices() const;
+
+  /// \brief Copies every field to the host
+  ///
+  void copyDataToHost() const;
+
+  /// \brief Marks the data of every field on the devices as modified
+  ///
+  void dataOnDeviceModified() const;
+
+  /// \brief Marks the data of every field on the host as modified
+  ///
+  void dataOnHostModified() const;
+
+  /// \brief Returns the OpenCL buffers of all fields on the given device in
+  ///        the order of the fields.
+  ///
+  std::vector<cl::Buffer> clBuffers(const detail::Device& device) const;
+
+private:
+  std::tuple<Vector<Fields>...> _fields;
+};
+
+} // namespace skelcl
+
+#include "detail/SoAVectorDef.h"
+
+#endif // SOA_VECTOR_H_
@@ -53,6 +53,7 @@
 #include "detail/Device.h"
 #include "detail/DeviceBuffer.h"
 #include "detail/Distribution.h"
+#include "detail/MappedFile.h"
 
 namespace skelcl {
 
@@ -196,6 +197,69 @@ public:
          InputIterator last,
          const detail::Distribution<Vector<T>>& distribution);
 
+  /// \brief Creates a new Vector by taking over the elements of \c hostBuffer.
+  ///
+  /// No element is copied. After this call \c hostBuffer is empty.
+  ///
+  /// \b Complexity Constant
+  /// \param hostBuffer   The std::vector whose storage is adopted by the new
+  ///                     constructed Vector
+  /// \param distribution Distribution to be used by the new constructed
+  ///                     Vector
+  Vector(host_buffer_type&& hostBuffer,
+         const detail::Distribution<Vector<T>>& distribution
+                                    = detail::Distribution<Vector<T>>());
+
+  /// \brief Creates a new Vector which borrows the memory pointed to by
+  ///        \c hostPointer instead of allocating its own storage on the host.
+  ///
+  /// The data is uploaded directly from and downloaded directly into the
+  /// memory of the caller. The memory has to stay valid as long as the
+  /// returned Vector (or a Vector it is moved to) uses it.
+  ///
+  /// Element access via operator[](), at(), front(), back() and hostData()
+  /// works directly on the borrowed memory. Every other function working on
+  /// the host storage (e.g. begin(), end(), resize() or hostBuffer())
+  /// first copies the elements into storage owned by the Vector, which ends
+  /// the borrowing.
+  ///
+  /// \b Complexity Constant
+  /// \param hostPointer  Pointer to the first of \c size many elements
+  /// \param size         The number of elements pointed to by \c hostPointer
+  /// \param distribution Distribution to be used by the new constructed
+  ///                     Vector
+  /// \return A Vector borrowing the memory pointed to by \c hostPointer
+  static Vector<T> wrap(pointer hostPointer,
+                        const size_type size,
+                        const detail::Distribution<Vector<T>>& distribution
+                                    = detail::Distribution<Vector<T>>());
+
+  /// \brief Creates a new Vector which uses the memory mapped file at \c path
+  ///        as storage for its elements on the host.
+  ///
+  /// Uploads read directly from the mapped file and downloads write directly
+  /// into it, e.g. when the Vector is used as the output of a skeleton.
+  /// Besides owning the mapping, the returned Vector behaves like a Vector
+  /// created with wrap().
+  ///
+  /// \b Complexity Constant
+  /// \param path         The path of the file to be mapped
+  /// \param mode         detail::MapMode::READ maps the file privately, i.e.
+  ///                     modifications are not written back to the file.
+  ///                     detail::MapMode::READ_WRITE writes modifications back.
+  ///                     detail::MapMode::CREATE creates a new file large
+  ///                     enough to store \c size elements
+  /// \param size         The number of elements to be mapped. If 0 and the
+  ///                     file is not created, the whole file is mapped
+  /// \param distribution Distribution to be used by the new constructed
+  ///                     Vector
+  /// \return A Vector using the mapped file as storage on the host
+  static Vector<T> mapFile(const std::string& path,
+                           detail::MapMode mode = detail::MapMode::READ,
+                           const size_type size = 0,
+                           const detail::Distribution<Vector<T>>& distribution
+                                    = detail::Distribution<Vector<T>>());
+
   /// \brief Copy constructor. Creates a new Vector with the copy of the content
   ///        of \c rhs.
   ///
@@ -593,6 +657,9 @@ public:
   /// to force the creation, e.g. replace existing buffers, use
   /// forceCreateDeviceBuffers()
   ///
+  /// The buffers are marked as recently used in the global memory manager,
+  /// which might evict them later on to make room for other buffers.
+  ///
   /// \b Complexity Linear in the number of device (usually small)
   void createDeviceBuffers() const;
 
@@ -689,7 +756,9 @@ public:
   /// \param device The device for which the buffer should be returned.
   ///               The device must be part of the current distribution and the
   ///               device buffers have to be already created, otherwise the
-  ///               behavior is undefined.
+  ///               behavior is undefined. If the buffers have been evicted by
+  ///               the memory manager they are recreated and the data is
+  ///               uploaded again.
   ///
   /// \return A reference to the buffer object used for the given device.
   ///         Be careful if you use auto to use auto& to capture the reference
@@ -700,7 +769,9 @@ public:
   ///        on the given device
   ///
   /// \b Complexity Constant
-  /// \param device The device for which the storage object should be returned
+  /// \param device The device for which the storage object should be returned.
+  ///               If the buffers have been evicted by the memory manager
+  ///               they are recreated and the data is uploaded again.
   /// \return A reference to the underlying object storing the elements on the
   ///         given device
   detail::DeviceBuffer& deviceBuffer(const detail::Device& device);
@@ -708,11 +779,37 @@ public:
   /// \brief Returns a reference to the underlying object storing the elements
   ///        on the host
   ///
-  /// \b Complexity Constant
+  /// If the Vector borrows memory (see wrap()) the elements are copied into
+  /// storage owned by the Vector first.
+  ///
+  /// \b Complexity Constant, or linear in the size of the Vector if the Vector
+  ///               borrows memory
   /// \return A reference to the underlying object storing the elements on the
   ///         host
   host_buffer_type& hostBuffer() const;
 
+  /// \brief Returns a pointer to the memory storing the elements on the host.
+  ///
+  /// This is the borrowed memory if the Vector has been created with wrap(),
+  /// otherwise the memory of hostBuffer(). The data is not downloaded from
+  /// the devices by this function.
+  ///
+  /// \b Complexity Constant
+  /// \return Pointer to the first element stored on the host
+  pointer hostData() const;
+
+  /// \brief Releases the elements of the Vector by moving them into the
+  ///        returned std::vector.
+  ///
+  /// If the data on the host is not up to date this function will block until
+  /// the elements of the Vector are transfered from the devices to the host.
+  /// Afterwards the Vector is empty.
+  ///
+  /// \b Complexity Constant if hostIsUpToDate() returns \c true and the Vector
+  ///               owns its storage. Linear in size of the Vector otherwise.
+  /// \return The std::vector holding the elements of the Vector
+  host_buffer_type release();
+
   /// \brief Returns the source code of helper functions simplifying access to
   ///        the vector on the device.
   ///
@@ -725,6 +822,12 @@ private:
 
   std::string getDebugInfo() const;
 
+  void detachHostPointer() const;
+
+  void restoreEvictedDeviceBuffers() const;
+
+  void evictDeviceBuffers() const;
+
   static RegisterVectorDeviceFunctions<T> registerVectorDeviceFunctions;
 
           size_type                                   _size;
@@ -733,6 +836,10 @@ private:
   mutable bool                                        _hostBufferUpToDate;
   mutable bool                                        _deviceBuffersUpToDate;
   mutable host_buffer_type                            _hostBuffer;
+  // _hostPointer != nullptr => borrowed memory is used instead of _hostBuffer
+  mutable pointer                                     _hostPointer;
+  // keeps the file mapped while _hostPointer points into it
+  mutable std::shared_ptr<detail::MappedFile>         _mappedFile;
   // _deviceBuffers empty => buffers not created yet
   mutable std::map< detail::Device::id_type,
                     detail::DeviceBuffer >            _deviceBuffers;
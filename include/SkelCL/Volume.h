@@ -0,0 +1,293 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file Volume.h
+///
+
+#ifndef VOLUME_H_
+#define VOLUME_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include "Distributions.h"
+
+#include "detail/Device.h"
+#include "detail/DeviceBuffer.h"
+#include "detail/Distribution.h"
+#include "detail/skelclDll.h"
+
+namespace skelcl {
+
+///
+/// \brief This class defines a three dimensional size for a Volume.
+///
+/// The number of slices, the number of rows per slice and the number of
+/// columns per row are stored. Objects of this type can be compared for
+/// equality.
+///
+class SKELCL_DLL VolumeSize {
+public:
+  typedef size_t size_type;
+
+  ///
+  /// \brief Create a new VolumeSize object with the given number of slices,
+  ///        rows, and columns.
+  ///
+  /// \param sliceCount The number of slices (the z dimension).
+  /// \param rowCount The number of rows of each slice (the y dimension).
+  /// \param columnCount The number of columns of each row (the x dimension).
+  ///
+  VolumeSize(size_type sliceCount, size_type rowCount, size_type columnCount);
+
+  ///
+  /// \brief Returns the total number of elements.
+  ///        I.e. sliceCount() * rowCount() * columnCount().
+  ///
+  /// \return sliceCount() * rowCount() * columnCount()
+  ///
+  size_type elemCount() const;
+
+  ///
+  /// \brief Returns the number of elements of a single slice.
+  ///        I.e. rowCount() * columnCount().
+  ///
+  /// \return rowCount() * columnCount()
+  ///
+  size_type sliceSize() const;
+
+  ///
+  /// \brief Returns the number of slices.
+  ///
+  /// \return The number of slices.
+  ///
+  size_type sliceCount() const;
+
+  ///
+  /// \brief Returns the number of rows.
+  ///
+  /// \return The number of rows.
+  ///
+  size_type rowCount() const;
+
+  ///
+  /// \brief Returns the number of columns.
+  ///
+  /// \return The number of columns.
+  ///
+  size_type columnCount() const;
+
+  ///
+  /// \brief Compares two VolumeSizes for equality.
+  ///
+  /// \param rhs The VolumeSize to compare with.
+  ///
+  /// \return Returns true if and only if all three dimensions are equal.
+  ///
+  bool operator==(const VolumeSize& rhs) const;
+
+  ///
+  /// \brief Compares two VolumeSizes for inequality.
+  ///
+  /// \param rhs The VolumeSize to compare with.
+  ///
+  /// \return Returns !(this == rhs)
+  ///
+  bool operator!=(const VolumeSize& rhs) const;
+
+private:
+  size_type _sliceCount;
+  size_type _rowCount;
+  size_type _columnCount;
+};
+
+///
+/// \defgroup volume Volume
+/// \brief Three dimensional container data structures
+///
+/// \ingroup containers
+///
+
+///
+/// \brief The Volume class is a three dimensional container which makes its
+///        data accessible on the host as well as on the devices.
+///
+/// The elements are stored slice by slice, each slice row by row. When the
+/// Volume is distributed across multiple devices it is split along the slices
+/// (the z dimension), i.e. every device stores a slab of consecutive slices.
+/// Currently only the overlap distribution (detail::OLDistribution) is
+/// supported, which additionally stores halo slices of the neighbouring
+/// devices as required by the MapOverlap skeleton.
+///
+/// \ingroup containers
+/// \ingroup volume
+///
+template <typename T>
+class Volume {
+public:
+  typedef std::vector<T> host_buffer_type;
+  typedef typename host_buffer_type::value_type value_type;
+  typedef typename host_buffer_type::pointer pointer;
+  typedef typename host_buffer_type::const_pointer const_pointer;
+  typedef typename host_buffer_type::reference reference;
+  typedef typename host_buffer_type::const_reference const_reference;
+  typedef typename host_buffer_type::iterator iterator;
+  typedef typename host_buffer_type::const_iterator const_iterator;
+  typedef skelcl::VolumeSize size_type;
+  typedef typename size_type::size_type index_type;
+
+  ///
+  /// \brief Creates an empty new Volume of size {0,0,0}.
+  ///
+  Volume();
+
+  ///
+  /// \brief Creates a new Volume with the given VolumeSize. The newly created
+  ///        Volume is filled with the given value.
+  ///
+  /// \param size The size of the Volume to create.
+  /// \param value The value to be used to fill the Volume.
+  ///
+  Volume(const size_type& size, const value_type& value = value_type());
+
+  ///
+  /// \brief Move constructor.
+  ///
+  Volume(Volume<T>&& rhs);
+
+  ///
+  /// \brief Move assignment operator.
+  ///
+  Volume<T>& operator=(Volume<T>&& rhs);
+
+  ///
+  /// \brief Destructor.
+  ///
+  ~Volume();
+
+  iterator begin();
+  const_iterator begin() const;
+
+  iterator end();
+  const_iterator end() const;
+
+  size_type size() const;
+  index_type sliceCount() const;
+  index_type rowCount() const;
+  index_type columnCount() const;
+
+  bool empty() const;
+
+  void resize(const size_type& size, T value = T());
+
+  void clear();
+
+  ///
+  /// \brief Access the element at the given coordinates.
+  ///
+  /// \param slice The index of the slice (z).
+  /// \param row The index of the row inside of the slice (y).
+  /// \param column The index of the column inside of the row (x).
+  ///
+  reference operator()(index_type slice, index_type row, index_type column);
+  const_reference operator()(index_type slice, index_type row,
+                             index_type column) const;
+
+  detail::Distribution<Volume<T>>& distribution() const;
+
+  template <typename U>
+  void setDistribution(const detail::Distribution<Volume<U>>& distribution)
+    const;
+
+  void setDistribution(std::unique_ptr<detail::Distribution<Volume<T>>>&&
+                          newDistribution) const;
+
+  void createDeviceBuffers() const;
+
+  detail::Event startUpload() const;
+
+  void copyDataToDevices() const;
+
+  detail::Event startDownload() const;
+
+  void copyDataToHost() const;
+
+  void dataOnDeviceModified() const;
+
+  void dataOnHostModified() const;
+
+  bool hostIsUpToDate() const;
+
+  bool devicesAreUpToDate() const;
+
+  const detail::DeviceBuffer& deviceBuffer(const detail::Device& device) const;
+
+  host_buffer_type& hostBuffer() const;
+
+  pointer hostData() const;
+
+  static std::string deviceFunctions();
+
+private:
+  Volume(const Volume<T>&);// = delete;
+  Volume<T>& operator=(const Volume<T>&);// = delete;
+
+  std::string getInfo() const;
+  std::string getDebugInfo() const;
+
+  void restoreEvictedDeviceBuffers() const;
+
+  void evictDeviceBuffers() const;
+
+          size_type                                   _size;
+  mutable std::unique_ptr<detail::Distribution<Volume<T>>> _distribution;
+  mutable bool                                        _hostBufferUpToDate;
+  mutable bool                                        _deviceBuffersUpToDate;
+  mutable host_buffer_type                            _hostBuffer;
+  // _deviceBuffers empty => buffers not created yet
+  mutable std::map< detail::Device::id_type,
+                    detail::DeviceBuffer >            _deviceBuffers;
+};
+
+} // namespace skelcl
+
+#include "detail/VolumeDef.h"
+
+#endif // VOLUME_H_
@@ -42,6 +42,7 @@
 
 #include <istream>
 #include <string>
+#include <vector>
 
 #include "detail/Skeleton.h"
 #include "detail/Program.h"
@@ -51,6 +52,7 @@ namespace skelcl {
 /// \cond
 /// Don't show this forward declarations in doxygen
 class Source;
+template <typename> class Expression;
 template <typename> class Out;
 
 template<typename> class Zip;
@@ -197,6 +199,10 @@ public:
   ///               here as they where defined in the funcName function
   ///               declaration.
   ///
+  /// If the input containers are too large to be stored on the devices, they
+  /// are streamed in chunks through the devices (see
+  /// detail::streaming::isRequired()).
+  ///
   template <template <typename> class C,
             typename... Args>
   C<Tout>& operator()(Out<C<Tout>> output,
@@ -204,6 +210,58 @@ public:
                       const C<Tright>& right,
                       Args&&... args);
 
+  ///
+  /// \brief Records the invocation of the skeleton on the provided lazily
+  ///        evaluated inputs, without launching a kernel.
+  ///
+  /// The user-defined function is fused with the functions of all other
+  /// skeleton calls recorded in the returned expression when it is evaluated.
+  /// Vectors are converted into expressions reading them, so that lazily
+  /// evaluated and ordinary inputs can be mixed. See Expression for details.
+  ///
+  /// \param left  The lazily evaluated left input.
+  /// \param right The lazily evaluated right input. It has to have the same
+  ///              size as left.
+  ///
+  /// \return An expression computing the result of this skeleton call.
+  ///
+  Expression<Tout> operator()(const Expression<Tleft>& left,
+                              const Expression<Tright>& right);
+
+  ///
+  /// \brief Executes the skeleton on every pair of containers of a batch of
+  ///        (typically small) input containers with a single kernel launch.
+  ///
+  /// The left and the right containers are packed into one container each,
+  /// the skeleton is executed once on them and the results are unpacked into
+  /// the output containers. See Map::batch() for details.
+  ///
+  /// \tparam C     The incomplete type of the containers used as input and
+  ///               output. C is either Vector or Matrix.
+  /// \tparam Args  The types of the arguments which are passed to the
+  ///               user-defined function in addition to the input containers.
+  ///
+  /// \param outputs The output containers. The vector is resized to hold one
+  ///                output container for every left container and every
+  ///                output container is resized to match its left container.
+  /// \param lefts   The left input containers.
+  /// \param rights  The right input containers, one for every left container.
+  ///                Every right container has to have at least as many
+  ///                elements as its left container.
+  /// \param args    The values of the arguments which are passed to the
+  ///                user-defined function in addition to the input
+  ///                containers. They are the same for all containers of the
+  ///                batch.
+  ///
+  /// \return A reference to the provided output containers.
+  ///
+  template <template <typename> class C,
+            typename... Args>
+  std::vector<C<Tout>>& batch(std::vector<C<Tout>>& outputs,
+                              const std::vector<C<Tleft>>& lefts,
+                              const std::vector<C<Tright>>& rights,
+                              Args&&... args);
+
   ///
   /// \brief Return the source code of the user defined function.
   ///
@@ -226,6 +284,13 @@ private:
                const C<Tright>& right,
                Args&&... args);
 
+  template <template <typename> class C,
+            typename... Args>
+  void executeStreaming(C<Tout>& output,
+                        const C<Tleft>& left,
+                        const C<Tright>& right,
+                        Args&&... args);
+
   template <template <typename> class C>
   void prepareInput(const C<Tleft>& left,
                     const C<Tright>& right);
@@ -346,6 +411,123 @@ private:
   const detail::Program _program;
 };
 
+///
+/// \brief This version of the Zip skeleton combines three or more input
+///        containers in a single pass.
+///
+/// On creation the Zip skeleton is customized with source code defining a
+/// function taking one argument per input container. The function is
+/// executed once for every tuple of items at the same position in the input
+/// containers.
+///
+/// More formally: When x1 .. xn are containers of length m and f is the
+/// provided function, the Zip skeleton calculates the output container z as
+/// follows: z[i] = f(x1[i], .., xn[i]) for every i in 0 .. m-1.
+///
+/// All input containers have to have the same size and are distributed alike
+/// before the kernel is launched.
+///
+/// \tparam T1    Type of the first input data of the skeleton
+/// \tparam Tn    Types of the remaining input data of the skeleton
+/// \tparam Tout  Type of the output data of the skeleton
+///
+/// \ingroup skeletons
+/// \ingroup zip
+///
+template<typename T1,
+         typename... Tn,
+         typename Tout>
+class Zip<Tout(T1, Tn...)> : public detail::Skeleton {
+public:
+  ///
+  /// \brief Constructor taking the source code used to customize the Zip
+  ///        skeleton.
+  ///
+  /// \param source   The source code of the user-defined function.
+  /// \param funcName The name of the user-defined function which should be
+  ///                 invoked by the Zip skeleton.
+  ///
+  Zip<Tout(T1, Tn...)>(const Source& source,
+                       const std::string& funcName = std::string("func"));
+
+  ///
+  /// \brief Executes the skeleton on the provided input containers. The
+  ///        resulting data is stored in a newly created output container and
+  ///        the container is returned.
+  ///
+  /// \param first The first input container.
+  /// \param rest  The remaining input containers.
+  /// \param args  The values of the arguments which are passed to the
+  ///              user-defined function in addition to the input containers.
+  ///
+  /// \return A newly created container storing the elements which get
+  ///         computed.
+  ///
+  template <template <typename> class C,
+            typename... Args>
+  C<Tout> operator()(const C<T1>& first,
+                     const C<Tn>&... rest,
+                     Args&&... args);
+
+  ///
+  /// \brief Executes the skeleton on the provided input containers. The
+  ///        resulting data is stored in the provided output container and a
+  ///        reference to this container is returned.
+  ///
+  /// \param output The output container in which the resulting data is
+  ///               stored.
+  /// \param first  The first input container.
+  /// \param rest   The remaining input containers.
+  /// \param args   The values of the arguments which are passed to the
+  ///               user-defined function in addition to the input containers.
+  ///
+  /// \return A reference to the provided output container.
+  ///
+  template <template <typename> class C,
+            typename... Args>
+  C<Tout>& operator()(Out<C<Tout>> output,
+                      const C<T1>& first,
+                      const C<Tn>&... rest,
+                      Args&&... args);
+
+  ///
+  /// \brief Return the source code of the user defined function.
+  ///
+  /// \return The source code of the user defined function.
+  ///
+  const std::string& source() const;
+
+  ///
+  /// \brief Return the name of the user defined function.
+  ///
+  /// \return The name of the user defined function.
+  ///
+  const std::string& func() const;
+
+private:
+  template <template <typename> class C,
+            typename... Args>
+  void execute(C<Tout>& output,
+               const C<T1>& first,
+               const C<Tn>&... rest,
+               Args&&... args);
+
+  template <template <typename> class C>
+  void prepareInput(const C<T1>& first,
+                    const C<Tn>&... rest);
+
+  template <template <typename> class C>
+  void prepareOutput(C<Tout>& output,
+                     const C<T1>& first);
+
+  detail::Program createAndBuildProgram(const std::string& source,
+                                        const std::string& funcName) const;
+
+  const std::string     _source;
+  const std::string     _funcName;
+  const detail::Program _program;
+};
+
 // TODO: when template aliases are available:
 // template<typename T>
 // using Zip = Zip<T(T, T)>;
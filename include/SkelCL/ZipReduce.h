@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ZipReduce.h
+///
+
+#ifndef ZIP_REDUCE_H_
+#define ZIP_REDUCE_H_
+
+#include <istream>
+#include <string>
+
+#include "Source.h"
+
+#include "detail/Program.h"
+#include "detail/Skeleton.h"
+
+namespace skelcl {
+
+/// \cond
+/// Don't show this forward declarations in doxygen
+template <typename> class Out;
+template <typename> class Vector;
+
+template <typename> class ZipReduce;
+/// \endcond
+
+///
+/// \defgroup zipreduce ZipReduce Skeleton
+///
+/// \brief The ZipReduce skeleton describes a calculation on two Vectors
+///        performed in parallel on a device. A binary user-defined function
+///        is applied pairwise to the items of both input Vectors and the
+///        results are reduced to a scalar value using a second binary
+///        user-defined function.
+///
+/// \ingroup skeletons
+///
+
+///
+/// \brief An instance of the ZipReduce class describes a fused zip and
+///        reduction calculation customized by two binary user-defined
+///        functions.
+///
+/// More formally: When l and r are Vectors of length n, z is the provided zip
+/// function and + the provided reduce function, the ZipReduce skeleton
+/// calculates the output value y as follows:
+/// y = z(l[0], r[0]) + z(l[1], r[1]) + ... + z(l[n-1], r[n-1]).
+/// The reduce function has to be associative and commutative.
+///
+/// With z being the multiplication and + the addition the ZipReduce skeleton
+/// computes the dot product of l and r in a single pass over the data.
+///
+/// \tparam Tleft  Type of the left input data of the skeleton.
+/// \tparam Tright Type of the right input data of the skeleton.
+/// \tparam Tout   Type of the output data of the skeleton.
+///
+/// \ingroup skeletons
+/// \ingroup zipreduce
+///
+template <typename Tleft, typename Tright, typename Tout>
+class ZipReduce<Tout(Tleft, Tright)> : public detail::Skeleton {
+public:
+  ///
+  /// \brief Constructor taking the source code of the zip and the reduce
+  ///        function used to customize the ZipReduce skeleton.
+  ///
+  /// \param zipSource    Source code defining the zip function.
+  ///
+  /// \param reduceSource Source code defining the reduce function.
+  ///
+  /// \param id           Identity for the reduce function. It is the result
+  ///                     for empty inputs.
+  ///
+  /// \param zipFunc      Name of the zip function defined in zipSource.
+  ///
+  /// \param reduceFunc   Name of the reduce function defined in reduceSource.
+  ///
+  ZipReduce(const Source& zipSource, const Source& reduceSource,
+            const std::string& id = "0",
+            const std::string& zipFunc = "func",
+            const std::string& reduceFunc = "func");
+
+  ///
+  /// \brief Function call operator. Executes the skeleton on the data provided
+  ///        as arguments left, right and args. The resulting data is returned
+  ///        as a moved copy.
+  ///
+  /// \param left  The left input data for the skeleton managed inside a
+  ///              Vector. If no distribution is set for left and right the
+  ///              Block distribution is used. With the Block distribution
+  ///              every device reduces its part of the input and the partial
+  ///              results are combined afterwards.
+  ///
+  /// \param right The right input data for the skeleton managed inside a
+  ///              Vector. It has to have the same size as left.
+  ///
+  /// \param args  Additional arguments which are passed to the zip
+  ///              function. The reduce function must not take additional
+  ///              arguments.
+  ///
+  template <typename... Args>
+  Vector<Tout> operator()(const Vector<Tleft>& left,
+                          const Vector<Tright>& right,
+                          Args&&... args);
+
+  ///
+  /// \brief Function call operator. Executes the skeleton on the data provided
+  ///        as arguments left, right and args. The resulting data is stored in
+  ///        the provided Vector output. A reference to the output Vector is
+  ///        returned to allow for chaining skeleton calls.
+  ///
+  /// \param output The Vector storing the result of the execution of the
+  ///               skeleton in its first item.
+  ///               The distribution of the container might change.
+  ///
+  /// \param left   The left input data for the skeleton managed inside a
+  ///               Vector.
+  ///
+  /// \param right  The right input data for the skeleton managed inside a
+  ///               Vector. It has to have the same size as left.
+  ///
+  /// \param args   Additional arguments which are passed to the zip
+  ///               function.
+  ///
+  template <typename... Args>
+  Vector<Tout>& operator()(Out<Vector<Tout>> output,
+                           const Vector<Tleft>& left,
+                           const Vector<Tright>& right,
+                           Args&&... args);
+
+private:
+  void prepareInput(const Vector<Tleft>& left, const Vector<Tright>& right);
+
+  void prepareOutput(Vector<Tout>& output,
+                     const detail::Device::ptr_type& devicePtr);
+
+  size_t numberOfGroups(const detail::Device& device, size_t data_size) const;
+
+  template <typename... Args>
+  void executeZipReduce(const detail::Device& device,
+                        const detail::DeviceBuffer& left,
+                        const detail::DeviceBuffer& right,
+                        const detail::DeviceBuffer& output,
+                        size_t data_size, size_t groups, Args&&... args);
+
+  detail::Program createAndBuildProgram() const;
+
+  std::string _srcZip;
+  std::string _srcReduce;
+  std::string _funcZip;
+  std::string _funcReduce;
+  std::string _idReduce;
+
+  detail::Program _program;
+};
+
+} // namespace skelcl
+
+#include "detail/ZipReduceDef.h"
+
+#endif // ZIP_REDUCE_H_
@@ -41,12 +41,14 @@
 #define ALLPAIRS_DEF_H
 
 #include <algorithm>
+#include <chrono>
 #include <istream>
 #include <iterator>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.h>
@@ -67,6 +69,8 @@
 #include "../Out.h"
 
 #include "Device.h"
+#include "DeviceBuffer.h"
+#include "Event.h"
 #include "KernelUtil.h"
 #include "Program.h"
 #include "Skeleton.h"
@@ -84,8 +88,14 @@ AllPairs<Tout(Tleft, Tright)>::AllPairs(const Reduce<Tout(Tout)>& reduce, const
       _idReduce(reduce.id()),
       _srcUser(),
       _funcUser(),
-      _C(32), _R(8), _S(16), // parameters
-      _program(createAndBuildProgramSpecial())
+      _config(isMatrixMultiplication()
+                ? detail::tuning::AllPairsConfig(
+                      detail::tuning::AllPairsConfig::GEMM, 32, 32, 4, 16, 4)
+                : detail::tuning::AllPairsConfig(
+                      detail::tuning::AllPairsConfig::TILED, 32, 8, 16, 32)),
+      _program(createAndBuildProgramSpecial(_config)),
+      _tunedPrograms(),
+      _tunedConfigs()
 {
     LOG_DEBUG("Create new AllPairs object (", this, ")");
 }
@@ -100,8 +110,10 @@ AllPairs<Tout(Tleft, Tright)>::AllPairs(const std::string& source, const std::st
       _idReduce(),
       _srcUser(source),
       _funcUser(func),
-      _C(16), _R(16), _S(1),
-      _program(createAndBuildProgramGeneral())
+      _config(detail::tuning::AllPairsConfig::GENERIC, 16, 16, 1, 1),
+      _program(createAndBuildProgramGeneral()),
+      _tunedPrograms(),
+      _tunedConfigs()
 {
     LOG_DEBUG("Create new AllPairs object (", this, ")");
 }
@@ -128,22 +140,33 @@ Matrix<Tout>& AllPairs<Tout(Tleft, Tright)>::operator()(Out< Matrix<Tout> > outp
     ASSERT( left.columnCount() == right.rowCount() );
     ASSERT( left.columnCount() > 0 );
 
-    prepareInput(left, right);
+    bool byColumns = splitByColumns(left, right);
+
+    prepareInput(left, right, byColumns);
 
     prepareAdditionalInput(std::forward<Args>(args)...);
 
-    prepareOutput(output.container(), left, right);
+    prepareOutput(output.container(), left, right, byColumns);
+
+    // with blocks of columns every device computes its block into a buffer of
+    // its own, the blocks are assembled on the host afterwards
+    std::vector<detail::DeviceBuffer> blocks;
+    if (byColumns) blocks = createColumnBlocks(output.container());
 
-    execute(output.container(), left, right, std::forward<Args>(args)...);
+    execute(output.container(), blocks, left, right,
+            std::forward<Args>(args)...);
 
     updateModifiedStatus(output, std::forward<Args>(args)...);
 
+    if (byColumns) gatherColumns(output.container(), blocks);
+
     return output.container();
 }
 
 template<typename Tleft, typename Tright, typename Tout>
 template <typename... Args>
 void AllPairs<Tout(Tleft, Tright)>::execute(Matrix<Tout>& output,
+                                            const std::vector<detail::DeviceBuffer>& blocks,
                                             const Matrix<Tleft>& left,
                                             const Matrix<Tright>& right,
                                             Args&&... args)
@@ -151,66 +174,230 @@ void AllPairs<Tout(Tleft, Tright)>::execute(Matrix<Tout>& output,
     ASSERT( left.distribution().isValid() && right.distribution().isValid() );
     ASSERT( output.rowCount() == left.rowCount() && output.columnCount() == right.columnCount() );
 
-    for (auto& devicePtr : left.distribution().devices()) {
-        auto& outputBuffer = output.deviceBuffer(*devicePtr);
-        auto& leftBuffer   = left.deviceBuffer(*devicePtr);
-        auto& rightBuffer  = right.deviceBuffer(*devicePtr);
-
-        cl_uint elements[2]   = { static_cast<cl_uint>(
-                                    outputBuffer.size() / output.columnCount()),
-                                  static_cast<cl_uint>(output.columnCount()) };
-        cl_uint local[2]      = {_C, _R}; // C, R
-        cl_uint global[2]     = {static_cast<cl_uint>(
-                                  detail::util::ceilToMultipleOf(elements[1],
-                                                                 local[0])),
-                                 static_cast<cl_uint>(
-                                  detail::util::ceilToMultipleOf(elements[0],
-                                                                 local[1]*_S))
-                                   /_S}; // SUBTILES
-        cl_uint dimension     = static_cast<cl_uint>( left.columnCount() );
-
-        LOG_DEBUG("dim: ", dimension, " height: ",
-                  elements[0], " width: ",elements[1]);
-        LOG_DEBUG("local: ", local[0],",", local[1],
-                  " global: ", global[0],",",global[1]);
-
+    auto& devices = left.distribution().devices();
+    for (size_t i = 0; i < devices.size(); ++i) {
+        auto& devicePtr = devices[i];
+        // either all columns of the device's rows or a block of columns of
+        // all rows is computed
+        auto columns = blocks.empty()
+                         ? std::make_pair(0u,
+                                          static_cast<unsigned int>(output.columnCount()))
+                         : columnRange(output.columnCount(), i, devices.size());
+        if (columns.second == 0) continue;
+
+        auto& outputBuffer = blocks.empty() ? output.deviceBuffer(*devicePtr)
+                                            : blocks[i];
         try {
-            cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_ALLPAIRS"));
+            launch(configFor(*devicePtr, outputBuffer, left, right,
+                             columns.first, columns.second, args...),
+                   *devicePtr, outputBuffer, left, right,
+                   columns.first, columns.second,
+                   std::forward<Args>(args)...);
+        } catch (cl::Error& err) {
+            ABORT_WITH_ERROR(err);
+        }
+    }
+    LOG_INFO("AllPairs kernel started");
+}
 
-            kernel.setArg(0, leftBuffer.clBuffer());
-            kernel.setArg(1, rightBuffer.clBuffer());
-            kernel.setArg(2, outputBuffer.clBuffer());
-            kernel.setArg(3, dimension);   // dimension
-            kernel.setArg(4, elements[0]); // height
-            kernel.setArg(5, elements[1]); // width
+template<typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+cl::Event AllPairs<Tout(Tleft, Tright)>::launch(
+                                  const detail::tuning::AllPairsConfig& config,
+                                  const detail::Device& device,
+                                  const detail::DeviceBuffer& outputBuffer,
+                                  const Matrix<Tleft>& left,
+                                  const Matrix<Tright>& right,
+                                  cl_uint firstColumn,
+                                  cl_uint columns,
+                                  Args&&... args)
+{
+    auto& leftBuffer   = left.deviceBuffer(device);
+    auto& rightBuffer  = right.deviceBuffer(device);
+
+    // outputBuffer stores the given columns of the rows computed by the device
+    cl_uint elements[2]   = { static_cast<cl_uint>(
+                                outputBuffer.size() / columns),
+                              static_cast<cl_uint>(right.columnCount()) };
+    cl_uint local[2]      = {config.workGroupSize(0),
+                             config.workGroupSize(1)};
+    cl_uint global[2]     = {static_cast<cl_uint>(
+                              detail::util::ceilToMultipleOf(columns,
+                                                             config.C))
+                               * local[0] / config.C,
+                             static_cast<cl_uint>(
+                              detail::util::ceilToMultipleOf(elements[0],
+                                                             local[1]*config.S))
+                               /config.S}; // SUBTILES
+    cl_uint dimension     = static_cast<cl_uint>( left.columnCount() );
+
+    LOG_DEBUG("dim: ", dimension, " height: ",
+              elements[0], " width: ",elements[1]);
+    LOG_DEBUG("local: ", local[0],",", local[1],
+              " global: ", global[0],",",global[1]);
+
+    cl::Kernel kernel(program(config).kernel(device, "SCL_ALLPAIRS"));
+
+    kernel.setArg(0, leftBuffer.clBuffer());
+    kernel.setArg(1, rightBuffer.clBuffer());
+    kernel.setArg(2, outputBuffer.clBuffer());
+    kernel.setArg(3, dimension);   // dimension
+    kernel.setArg(4, elements[0]); // height
+    kernel.setArg(5, elements[1]); // width
+    kernel.setArg(6, columns);     // width of the output buffer
+
+    detail::kernelUtil::setKernelArgs(kernel, device, 7,
+                                      std::forward<Args>(args)...);
+
+
+    // keep buffers and arguments alive / mark them as in use
+    auto keepAlive = detail::kernelUtil::keepAlive(device,
+                                                   leftBuffer.clBuffer(),
+                                                   rightBuffer.clBuffer(),
+                                                   outputBuffer.clBuffer(),
+                                                   std::forward<Args>(args)...);
+
+    // after finishing the kernel invoke this function ...
+    auto invokeAfter =  [=] () { (void)keepAlive; };
+
+    // the global offset selects the first column computed by the device, which
+    // is stored in the first column of outputBuffer
+    return device.enqueue(kernel, cl::NDRange(global[0], global[1]),
+                          cl::NDRange(local[0], local[1]),
+                          firstColumn > 0 ? cl::NDRange(firstColumn, 0)
+                                          : cl::NullRange,
+                          invokeAfter);
+}
 
-            detail::kernelUtil::setKernelArgs(kernel, *devicePtr, 6,
-                                              std::forward<Args>(args)...);
+template<typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+const detail::tuning::AllPairsConfig&
+  AllPairs<Tout(Tleft, Tright)>::configFor(const detail::Device& device,
+                                           const detail::DeviceBuffer& outputBuffer,
+                                           const Matrix<Tleft>& left,
+                                           const Matrix<Tright>& right,
+                                           cl_uint firstColumn,
+                                           cl_uint columns,
+                                           Args&&... args)
+{
+    if (!detail::tuning::isEnabled()) return _config;
+
+    // the rows and columns computed by the device and the dimension
+    auto shape = detail::tuning::shapeClass({
+                    outputBuffer.size() / columns, columns,
+                    left.columnCount() });
+    auto key = detail::tuning::key(device, sourceHash(), shape);
+
+    auto iter = _tunedConfigs.find(key);
+    if (iter != _tunedConfigs.end()) return iter->second;
+
+    detail::tuning::AllPairsConfig config;
+    std::string value;
+    if (!detail::tuning::lookup(key, value)
+        || !detail::tuning::AllPairsConfig::fromString(value, config)) {
+        config = tune(device, outputBuffer, left, right, firstColumn, columns,
+                      args...);
+        detail::tuning::store(key, config.toString());
+    }
+    return _tunedConfigs[key] = config;
+}
 
+template<typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+detail::tuning::AllPairsConfig
+  AllPairs<Tout(Tleft, Tright)>::tune(const detail::Device& device,
+                                      const detail::DeviceBuffer& outputBuffer,
+                                      const Matrix<Tleft>& left,
+                                      const Matrix<Tright>& right,
+                                      cl_uint firstColumn,
+                                      cl_uint columns,
+                                      Args&&... args)
+{
+    auto candidates = detail::tuning::allPairsCandidates(device,
+                        static_cast<detail::tuning::AllPairsConfig::Kernel>(
+                            _config.kernel),
+                        sizeof(Tleft), sizeof(Tright));
+
+    auto best = _config;
+    cl_ulong bestTime = CL_ULONG_MAX;
+
+    for (auto& candidate : candidates) {
+        cl::Kernel kernel(program(candidate).kernel(device, "SCL_ALLPAIRS"));
+        // the compiler might have limited the work-group size of the kernel
+        if (candidate.workGroupSize(0) * candidate.workGroupSize(1)
+              > kernel.getWorkGroupInfo<
+                                          CL_KERNEL_WORK_GROUP_SIZE>(
+                                              device.clDevice())) {
+            continue;
+        }
 
-            // keep buffers and arguments alive / mark them as in use
-            auto keepAlive = detail::kernelUtil::keepAlive(*devicePtr,
-                                                           leftBuffer.clBuffer(),
-                                                           rightBuffer.clBuffer(),
-                                                           outputBuffer.clBuffer(),
-                                                           std::forward<Args>(args)...);
+        // the first run warms up, the second one is measured
+        launch(candidate, device, outputBuffer, left, right, firstColumn,
+               columns, args...).wait();
+        cl::Event event = launch(candidate, device, outputBuffer, left, right,
+                                 firstColumn, columns, args...);
+        event.wait();
+        auto time = event.getProfilingInfo<CL_PROFILING_COMMAND_END>()
+                  - event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+
+        LOG_DEBUG_INFO("AllPairs configuration ", candidate.toString(),
+                       " on device ", device.id(), ": ", time, " ns");
+        if (time < bestTime) {
+            bestTime = time;
+            best = candidate;
+        }
+    }
 
-            // after finishing the kernel invoke this function ...
-            auto invokeAfter =  [=] () { (void)keepAlive; };
+    LOG_INFO("Selected AllPairs configuration ", best.toString(),
+             " for device ", device.id());
+    return best;
+}
 
-            devicePtr->enqueue(kernel, cl::NDRange(global[0], global[1]), cl::NDRange(local[0], local[1]),
-                               cl::NullRange, // offset
-                               invokeAfter);
+template<typename Tleft, typename Tright, typename Tout>
+const detail::Program&
+  AllPairs<Tout(Tleft, Tright)>::program(
+                                  const detail::tuning::AllPairsConfig& config)
+{
+    // the generic kernel does not depend on the configuration
+    if (config.kernel == detail::tuning::AllPairsConfig::GENERIC
+        || config.toString() == _config.toString()) {
+        return _program;
+    }
 
-        } catch (cl::Error& err) {
-            ABORT_WITH_ERROR(err);
-        }
+    auto& programPtr = _tunedPrograms[config.toString()];
+    if (programPtr == nullptr) {
+        programPtr.reset(new detail::Program(
+                               createAndBuildProgramSpecial(config)));
     }
-    LOG_INFO("AllPairs kernel started");
+    return *programPtr;
+}
+
+template<typename Tleft, typename Tright, typename Tout>
+bool AllPairs<Tout(Tleft, Tright)>::isMatrixMultiplication() const
+{
+    bool isFloatingPoint = std::is_same<Tout, float>::value
+                        || std::is_same<Tout, double>::value;
+    return isFloatingPoint
+        && std::is_same<Tleft, Tout>::value
+        && std::is_same<Tright, Tout>::value
+        && detail::util::isBinaryOperation(_srcReduce, _funcReduce, "+")
+        && detail::util::isBinaryOperation(_srcZip, _funcZip, "*");
+}
+
+template<typename Tleft, typename Tright, typename Tout>
+std::string AllPairs<Tout(Tleft, Tright)>::sourceHash() const
+{
+    return detail::util::hash("//AllPairs\n"
+                              + detail::util::typeToString<Tleft>()
+                              + detail::util::typeToString<Tright>()
+                              + detail::util::typeToString<Tout>()
+                              + _srcReduce + _srcZip + _idReduce
+                              + _srcUser + _funcUser);
 }
 
 template<typename Tleft, typename Tright, typename Tout>
-detail::Program AllPairs<Tout(Tleft, Tright)>::createAndBuildProgramSpecial() const
+detail::Program AllPairs<Tout(Tleft, Tright)>::createAndBuildProgramSpecial(
+                                const detail::tuning::AllPairsConfig& config) const
 {
     ASSERT_MESSAGE( !_srcReduce.empty(),
                     "Tried to create program with empty user reduce source." );
@@ -223,7 +410,7 @@ detail::Program AllPairs<Tout(Tleft, Tright)>::createAndBuildProgramSpecial() co
 
     // _srcZip: replace func by TMP_ZIP
     stooling::SourceCode zSource(_srcZip);
-    zSource.renameFunction(_funcReduce, "TMP_ZIP");
+    zSource.renameFunction(_funcZip, "TMP_ZIP");
 
     // create program
     std::string s(Matrix<Tout>::deviceFunctions());
@@ -243,22 +430,46 @@ detail::Program AllPairs<Tout(Tleft, Tright)>::createAndBuildProgramSpecial() co
 
     s.append("\n");
 
-    // allpairs parameters
-    s.append("#define C ").append(std::to_string(_C)).append("\n");
-    s.append("#define R ").append(std::to_string(_R)).append("\n");
-    s.append("#define S ").append(std::to_string(_S)).append("\n");
-    s.append("#define D 32");
-
-    // allpairs skeleton source
-    s.append(
-      #include "AllPairsKernel.cl"
-    );
+    // allpairs parameters and skeleton source
+    if (config.kernel == detail::tuning::AllPairsConfig::GEMM) {
+        auto type = detail::util::typeToString<Tout>();
+        auto vw   = std::to_string(config.W);
+        s.append("#define SCL_TILE_COLS ").append(std::to_string(config.C)).append("\n");
+        s.append("#define SCL_TILE_ROWS ").append(std::to_string(config.R)).append("\n");
+        s.append("#define SCL_TILE_DEPTH ").append(std::to_string(config.D)).append("\n");
+        s.append("#define SCL_WPT ").append(std::to_string(config.S)).append("\n");
+        s.append("#define SCL_VW ").append(vw).append("\n");
+        if (config.W == 1) {
+            s.append("typedef ").append(type).append(" SCL_VEC;\n");
+            s.append("#define SCL_VLOAD(p) (*(p))\n");
+            s.append("#define SCL_VSTORE(v, p) (*(p) = (v))\n");
+        } else {
+            s.append("typedef ").append(type + vw).append(" SCL_VEC;\n");
+            s.append("#define SCL_VLOAD(p) vload").append(vw).append("(0, p)\n");
+            s.append("#define SCL_VSTORE(v, p) vstore").append(vw).append("(v, 0, p)\n");
+        }
+        s.append(
+          #include "AllPairsGemmKernel.cl"
+        );
+    } else if (config.kernel == detail::tuning::AllPairsConfig::SQUARE) {
+        s.append("#define SIZE ").append(std::to_string(config.C)).append("\n");
+        s.append(
+          #include "AllPairsKernel3.cl"
+        );
+    } else {
+        s.append("#define C ").append(std::to_string(config.C)).append("\n");
+        s.append("#define R ").append(std::to_string(config.R)).append("\n");
+        s.append("#define S ").append(std::to_string(config.S)).append("\n");
+        s.append("#define D ").append(std::to_string(config.D)).append("\n");
+        s.append(
+          #include "AllPairsKernel.cl"
+        );
+    }
 
-    auto program = detail::Program(s, detail::util::hash("//AllPairs\n"
-                                                         + Matrix<Tout>::deviceFunctions()
-                                                         + _idReduce
-                                                         + rSource.code()
-                                                         + zSource.code()));
+    // the hash covers the parameters, as every configuration is compiled
+    // into its own binary, and the kernel source, so that binaries of older
+    // kernel versions are not loaded
+    auto program = detail::Program(s, detail::util::hash("//AllPairs\n" + s));
     // modify program
     if (!program.loadBinary()) {
         // problem: reduce parameter a und zip parameter a
@@ -324,9 +535,7 @@ SCL_TYPE_1 getElementFromColumn(rmatrix_t* matrix, const unsigned int element_id
       #include "AllPairsKernel2.cl"
     );
 
-    auto program = detail::Program(s, detail::util::hash("//AllPairs\n"
-                                                         + Matrix<Tout>::deviceFunctions()
-                                                         + _srcUser
+    auto program = detail::Program(s, detail::util::hash("//AllPairs\n" + s
                                                          + _funcUser));
     // modify program
     if (!program.loadBinary()) {
@@ -343,9 +552,30 @@ SCL_TYPE_1 getElementFromColumn(rmatrix_t* matrix, const unsigned int element_id
     return program;
 }
 
+template<typename Tleft, typename Tright, typename Tout>
+bool AllPairs<Tout(Tleft, Tright)>::splitByColumns(const Matrix<Tleft>& left,
+                                                   const Matrix<Tright>& right) const
+{
+    bool isLeftSingle  = (dynamic_cast<detail::SingleDistribution< Matrix<Tleft> >*>(&left.distribution())   != nullptr);
+    bool isRightSingle = (dynamic_cast<detail::SingleDistribution< Matrix<Tright> >*>(&right.distribution()) != nullptr);
+    if (isLeftSingle || isRightSingle) return false;
+
+    // blocks of rows are preferred, as the right matrix can be reused, but
+    // every device should get enough rows to fill its work-groups
+    // the right matrix is copied to all devices it is distributed to, i.e. to
+    // all devices of the default device list if it has no distribution yet
+    auto devices = right.distribution().isValid()
+                     ? right.distribution().devices().size()
+                     : detail::globalDeviceList.size();
+    auto height  = left.rowCount();
+    auto width   = right.columnCount();
+    return devices > 1 && (height < 16 * devices || width >= 8 * height);
+}
+
 template<typename Tleft, typename Tright, typename Tout>
 void AllPairs<Tout(Tleft, Tright)>::prepareInput(const Matrix<Tleft>& left,
-                                                 const Matrix<Tright>& right)
+                                                 const Matrix<Tright>& right,
+                                                 bool byColumns)
 {
     bool isLeftCopy    = (dynamic_cast<detail::CopyDistribution< Matrix<Tleft> >*>(&left.distribution())     != nullptr);
     bool isLeftSingle  = (dynamic_cast<detail::SingleDistribution< Matrix<Tleft> >*>(&left.distribution())   != nullptr);
@@ -353,50 +583,29 @@ void AllPairs<Tout(Tleft, Tright)>::prepareInput(const Matrix<Tleft>& left,
 
     bool isRightCopy   = (dynamic_cast<detail::CopyDistribution< Matrix<Tright> >*>(&right.distribution())   != nullptr);
     bool isRightSingle = (dynamic_cast<detail::SingleDistribution< Matrix<Tright> >*>(&right.distribution()) != nullptr);
-    bool isRightBlock  = (dynamic_cast<detail::BlockDistribution< Matrix<Tright> >*>(&right.distribution())  != nullptr);
 
-    // set distributions
+    // set distributions, distributions which are already set are kept, so
+    // that the data on the devices is reused
 
-    // left and right not valid
-    if (!left.distribution().isValid() && !right.distribution().isValid()) {
-        left.setDistribution(detail::BlockDistribution< Matrix<Tleft> >());
-        right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-
-    // only left not valid
-    } else if (!left.distribution().isValid()) {
-        if (isRightCopy) // right copy -> left block
-            left.setDistribution(detail::BlockDistribution< Matrix<Tleft> >());
-        else if (isRightSingle) // right single -> left single
+    if (isLeftSingle || isRightSingle) {
+        // single device requested -> both single
+        if (!isLeftSingle)
             left.setDistribution(detail::SingleDistribution< Matrix<Tleft> >());
-        else if (isRightBlock) { // right block -> left block + change right to copy
-            left.setDistribution(detail::BlockDistribution< Matrix<Tleft> >());
-            right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-        }
-        else
-            ASSERT_MESSAGE(false, "if check only valid for single, copy and block distribution. new distribution added?");
+        if (!isRightSingle)
+            right.setDistribution(detail::SingleDistribution< Matrix<Tright> >());
 
-    // only right not valid
-    } else if (!right.distribution().isValid()) {
-        if (isLeftBlock) // left block -> right copy
-            right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-        else if (isLeftCopy) // left copy -> right copy
+    } else if (byColumns) {
+        // blocks of columns -> left and right copy
+        if (!isLeftCopy)
+            left.setDistribution(detail::CopyDistribution< Matrix<Tleft> >());
+        if (!isRightCopy)
             right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-        else if (isLeftSingle) // left single -> right single
-            right.setDistribution(detail::SingleDistribution< Matrix<Tright> >());
-        else
-            ASSERT_MESSAGE(false, "if check only valid for single, copy and block distribution. new distribution added?");
 
-    // both valid
     } else {
-        if (isLeftCopy && isRightSingle)
-            left.setDistribution(detail::SingleDistribution< Matrix<Tleft> >()); // single okay?
-        else if (isLeftBlock && isRightSingle)
-            right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-        else if (isLeftSingle && isRightBlock)
-            right.setDistribution(detail::SingleDistribution< Matrix<Tright> >()); // single okay?
-        else if (isLeftCopy && isRightBlock)
-            right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
-        else if (isLeftBlock && isRightBlock)
+        // blocks of rows -> left block and right copy
+        if (!isLeftBlock)
+            left.setDistribution(detail::BlockDistribution< Matrix<Tleft> >());
+        if (!isRightCopy)
             right.setDistribution(detail::CopyDistribution< Matrix<Tright> >());
     }
 
@@ -412,7 +621,8 @@ void AllPairs<Tout(Tleft, Tright)>::prepareInput(const Matrix<Tleft>& left,
 template<typename Tleft, typename Tright, typename Tout>
 void AllPairs<Tout(Tleft, Tright)>::prepareOutput(Matrix<Tout>& output,
                                                   const Matrix<Tleft>& left,
-                                                  const Matrix<Tright>& right)
+                                                  const Matrix<Tright>& right,
+                                                  bool byColumns)
 {
     // set size
     if (output.rowCount() != left.rowCount() || output.columnCount() != right.columnCount())
@@ -421,10 +631,71 @@ void AllPairs<Tout(Tleft, Tright)>::prepareOutput(Matrix<Tout>& output,
     // adopt distribution from left input
     output.setDistribution(left.distribution()); // richtiger typ (Tout)?
 
+    // blocks of columns are assembled on the host, so that no device stores
+    // the complete output
+    if (byColumns) return;
+
     //create buffers if required
     output.createDeviceBuffers();
 }
 
+template<typename Tleft, typename Tright, typename Tout>
+std::vector<detail::DeviceBuffer>
+  AllPairs<Tout(Tleft, Tright)>::createColumnBlocks(const Matrix<Tout>& output)
+{
+    // every device stores its block of columns of all rows contiguously
+    auto& devices = output.distribution().devices();
+    std::vector<detail::DeviceBuffer> blocks(devices.size());
+    for (size_t i = 0; i < devices.size(); ++i) {
+        auto columns = columnRange(output.columnCount(), i, devices.size());
+        if (columns.second == 0) continue;
+
+        blocks[i] = detail::DeviceBuffer(devices[i],
+                                         output.rowCount() * columns.second,
+                                         sizeof(Tout));
+    }
+    return blocks;
+}
+
+template<typename Tleft, typename Tright, typename Tout>
+void AllPairs<Tout(Tleft, Tright)>::gatherColumns(
+                              const Matrix<Tout>& output,
+                              const std::vector<detail::DeviceBuffer>& blocks) const
+{
+    // every device stores its block of columns of every row
+    detail::Event events;
+    auto& devices = output.distribution().devices();
+    auto  width   = output.columnCount();
+    for (size_t i = 0; i < devices.size(); ++i) {
+        auto columns = columnRange(width, i, devices.size());
+        if (columns.second == 0) continue;
+
+        // the block is strided on the host, so that it is read with one
+        // command per device
+        events.insert(devices[i]->enqueueReadRect(blocks[i], output.hostData(),
+                                                  output.rowCount(),
+                                                  columns.second,
+                                                  columns.second, width,
+                                                  0, columns.first));
+    }
+    events.wait();
+
+    // the complete result is now stored on the host only
+    output.dataOnHostModified();
+    LOG_DEBUG_INFO("Gathered columns of AllPairs result on the host");
+}
+
+template<typename Tleft, typename Tright, typename Tout>
+std::pair<unsigned int, unsigned int>
+  AllPairs<Tout(Tleft, Tright)>::columnRange(size_t width, size_t index,
+                                             size_t devices)
+{
+    auto first = width * index / devices;
+    auto last  = width * (index + 1) / devices;
+    return std::make_pair(static_cast<unsigned int>(first),
+                          static_cast<unsigned int>(last - first));
+}
+
 } // namespace skelcl
 
 #endif // ALLPAIRS_DEF_H
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file AllPairsGemmKernel.cl
+///
+/// \brief Register blocked matrix multiplication used by the AllPairs
+///        skeleton if it is customized with an addition and a
+///        multiplication.
+///
+/// Every work-group computes a tile of SCL_TILE_ROWS x SCL_TILE_COLS elements
+/// of the output, every work-item SCL_WPT rows of SCL_VW adjacent columns of
+/// this tile, which are kept in registers. The tiles of the inputs are loaded
+/// into two local memory buffers, so that the next tile is loaded while the
+/// current one is used.
+///
+
+R"(
+
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+typedef float SCL_TYPE_2;
+
+// work-items per work-group in both dimensions
+#define SCL_CTS (SCL_TILE_COLS / SCL_VW)
+#define SCL_RTS (SCL_TILE_ROWS / SCL_WPT)
+
+// loads the tiles starting at index k0 of the dimension, elements outside of
+// the matrices are set to zero
+void SCL_LOAD_TILES(const __global SCL_TYPE_0* M,
+                    const __global SCL_TYPE_1* N,
+                    __local SCL_TYPE_0* Ml,
+                    __local SCL_TYPE_1* Nl,
+                    const int rowBase, const int colBase, const int k0,
+                    const int dimension, const int height, const int width)
+{
+    const int lid = get_local_id(1) * SCL_CTS + get_local_id(0);
+    int i;
+
+    // consecutive work-items read consecutive elements of a row of M
+    for (i = lid; i < SCL_TILE_ROWS * SCL_TILE_DEPTH; i += SCL_CTS * SCL_RTS) {
+        const int row = rowBase + i / SCL_TILE_DEPTH;
+        const int k   = k0 + i % SCL_TILE_DEPTH;
+        Ml[(i % SCL_TILE_DEPTH) * SCL_TILE_ROWS + i / SCL_TILE_DEPTH] =
+            (row < height && k < dimension) ? M[row * dimension + k] : 0;
+    }
+
+    for (i = lid; i < SCL_TILE_DEPTH * SCL_TILE_COLS; i += SCL_CTS * SCL_RTS) {
+        const int k   = k0 + i / SCL_TILE_COLS;
+        const int col = colBase + i % SCL_TILE_COLS;
+        Nl[i] = (col < width && k < dimension) ? N[k * width + col] : 0;
+    }
+}
+
+__kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
+                           const __global SCL_TYPE_1* N,
+                                 __global SCL_TYPE_2* P,
+                           const unsigned int SCL_DIMENSION,
+                           const unsigned int SCL_HEIGHT,
+                           const unsigned int SCL_WIDTH,
+                           const unsigned int SCL_OUT_WIDTH) {
+    __local SCL_TYPE_0 Ml[2][SCL_TILE_DEPTH][SCL_TILE_ROWS];
+    __local SCL_TYPE_1 Nl[2][SCL_TILE_DEPTH][SCL_TILE_COLS];
+
+    const int dimension = SCL_DIMENSION;
+    const int height    = SCL_HEIGHT;
+    const int width     = SCL_WIDTH;
+    const int outWidth  = SCL_OUT_WIDTH;
+    const int l_col     = get_local_id(0);
+    const int l_row     = get_local_id(1);
+
+    // the global offset selects the first column computed by the device
+    const int rowBase = get_group_id(1) * SCL_TILE_ROWS;
+    const int colBase = get_global_offset(0) + get_group_id(0) * SCL_TILE_COLS;
+    const int tiles   = (dimension + SCL_TILE_DEPTH - 1) / SCL_TILE_DEPTH;
+
+    SCL_VEC acc[SCL_WPT];
+    int w, k, t;
+    for (w = 0; w < SCL_WPT; ++w) {
+        acc[w] = (SCL_VEC)((SCL_TYPE_2)(SCL_IDENTITY));
+    }
+
+    SCL_LOAD_TILES(M, N, &Ml[0][0][0], &Nl[0][0][0], rowBase, colBase, 0,
+                   dimension, height, width);
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (t = 0; t < tiles; ++t) {
+        const int cur = t % 2;
+
+        // the other buffer has been read before the last barrier
+        if (t + 1 < tiles) {
+            SCL_LOAD_TILES(M, N, &Ml[1 - cur][0][0], &Nl[1 - cur][0][0],
+                           rowBase, colBase, (t + 1) * SCL_TILE_DEPTH,
+                           dimension, height, width);
+        }
+
+        for (k = 0; k < SCL_TILE_DEPTH; ++k) {
+            const SCL_VEC n = SCL_VLOAD(&Nl[cur][k][l_col * SCL_VW]);
+            for (w = 0; w < SCL_WPT; ++w) {
+                acc[w] += Ml[cur][k][l_row + w * SCL_RTS] * n;
+            }
+        }
+
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // P holds the outWidth columns starting at the global offset
+    const int col = colBase - (int)get_global_offset(0) + l_col * SCL_VW;
+    for (w = 0; w < SCL_WPT; ++w) {
+        const int row = rowBase + l_row + w * SCL_RTS;
+        if (row >= height || col >= outWidth) continue;
+
+        if (col + SCL_VW <= outWidth) {
+            SCL_VSTORE(acc[w], &P[row * outWidth + col]);
+        } else {
+            SCL_TYPE_2 values[SCL_VW];
+            SCL_VSTORE(acc[w], values);
+            for (k = 0; col + k < outWidth; ++k) {
+                P[row * outWidth + col + k] = values[k];
+            }
+        }
+    }
+}
+)"
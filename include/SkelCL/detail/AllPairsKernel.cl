@@ -49,7 +49,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
                                  __global SCL_TYPE_2* P,
                            const unsigned int dimension,
                            const unsigned int height,
-                           const unsigned int width) {
+                           const unsigned int width,
+                           const unsigned int out_width) {
     __local SCL_TYPE_0 Ml[R][D];
     __local SCL_TYPE_1 Nl[D][C];
 
@@ -57,10 +58,12 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
     const unsigned int l_col = get_local_id(0);
     const unsigned int   row = get_global_id(1) % R + (get_global_id(1) / R) * R * S;
     const unsigned int l_row = get_local_id(1);
+    // P holds the out_width columns starting at the global offset
+    const unsigned int out_col = col - get_global_offset(0);
 
     for (int m = 0; m < S; ++m)
-        if ((row + m * R < height) && (col < width))
-            P[(row + m * R) * width + col] = SCL_IDENTITY;
+        if ((row + m * R < height) && (out_col < out_width))
+            P[(row + m * R) * out_width + out_col] = SCL_IDENTITY;
 
     for (int segment = 0; segment < dimension/D; ++segment) {
 
@@ -74,8 +77,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
         for (int s = 0; s < S; ++s) {
             if ((row - l_row + s * R >= height)) break;
             SCL_TYPE_2 result;
-            if ((row + s * R < height) && (col < width))
-                result = P[(row + s * R) * width + col];
+            if ((row + s * R < height) && (out_col < out_width))
+                result = P[(row + s * R) * out_width + out_col];
 
             uint jj = segment * D / C;
             uint coffset = segment * D - jj * C;
@@ -92,8 +95,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
 
             barrier(CLK_LOCAL_MEM_FENCE);
 
-            if ((row + s * R < height) && (col < width))
-                P[(row + s * R) * width + col] = result;
+            if ((row + s * R < height) && (out_col < out_width))
+                P[(row + s * R) * out_width + out_col] = result;
         } 
     }
     
@@ -110,8 +113,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
         for (int s = 0; s < S; ++s) {
             if ((row - l_row + s * R >= height)) break;
             SCL_TYPE_2 result;
-            if ((row + s * R < height) && (col < width))
-                result = P[(row + s * R) * width + col];
+            if ((row + s * R < height) && (out_col < out_width))
+                result = P[(row + s * R) * out_width + out_col];
 
             uint jj = segment * D / C;
             uint coffset = segment * D - jj * C;
@@ -128,8 +131,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
 
             barrier(CLK_LOCAL_MEM_FENCE);
 
-            if ((row + s * R < height) && (col < width))
-                P[(row + s * R) * width + col] = result;
+            if ((row + s * R < height) && (out_col < out_width))
+                P[(row + s * R) * out_width + out_col] = result;
         } 
     }
 }
@@ -44,10 +44,13 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
                                  __global SCL_TYPE_2* P,
                            const unsigned int dimension,
                            const unsigned int height,
-                           const unsigned int width) {
+                           const unsigned int width,
+                           const unsigned int out_width) {
 
     const unsigned int col = get_global_id(0);
     const unsigned int row = get_global_id(1);
+    // P holds the out_width columns starting at the global offset
+    const unsigned int out_col = col - get_global_offset(0);
 
     lmatrix_t Mm;
     Mm.data = M;
@@ -59,8 +62,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
     Nm.width = width;
     Nm.column = col;
 
-    if (row < height && col < width) {
-        P[row * width + col] = USR_FUNC(&Mm, &Nm, dimension);
+    if (row < height && out_col < out_width) {
+        P[row * out_width + out_col] = USR_FUNC(&Mm, &Nm, dimension);
     }
 }
 )"
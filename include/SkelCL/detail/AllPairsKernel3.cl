@@ -5,14 +5,17 @@ typedef float SCL_TYPE_0;
 typedef float SCL_TYPE_1;
 typedef float SCL_TYPE_2;
 
+#ifndef SIZE
 #define SIZE 16
+#endif
 
 __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
                            const __global SCL_TYPE_1* N,
                                  __global SCL_TYPE_2* P, 
                            const unsigned int dimension,
                            const unsigned int height,
-                           const unsigned int width) {
+                           const unsigned int width,
+                           const unsigned int out_width) {
     __local SCL_TYPE_0 Ml[SIZE][SIZE];
     __local SCL_TYPE_1 Nl[SIZE][SIZE];
 
@@ -20,11 +23,15 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
     const unsigned int   row = get_global_id(1);
     const unsigned int l_col = get_local_id(0);
     const unsigned int l_row = get_local_id(1);
+    // P holds the out_width columns starting at the global offset
+    const unsigned int out_col = col - get_global_offset(0);
                                
     SCL_TYPE_2 sum = SCL_IDENTITY; 
     for (int m = 0; m < dimension/SIZE; ++m) {  
-        Ml[l_row][l_col] = M[row * dimension + (m * SIZE + l_col)];
-        Nl[l_row][l_col] = N[(m * SIZE + l_row) * width + col];
+        if (row < height)
+            Ml[l_row][l_col] = M[row * dimension + (m * SIZE + l_col)];
+        if (col < width)
+            Nl[l_row][l_col] = N[(m * SIZE + l_row) * width + col];
         barrier(CLK_LOCAL_MEM_FENCE);
 
         for (int k = 0; k < SIZE; ++k)
@@ -47,8 +54,8 @@ __kernel void SCL_ALLPAIRS(const __global SCL_TYPE_0* M,
         
     }
 
-    if (row < height && col < width)
-        P[row * width + col] = sum;
+    if (row < height && out_col < out_width)
+        P[row * out_width + out_col] = sum;
 }
 
 )"
@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file Batch.h
+///
+/// \brief Helpers for executing an element-wise skeleton on a batch of
+///        containers with a single kernel launch. The containers are packed
+///        into one Vector, using a table of offsets, and the results are
+///        unpacked from the packed output afterwards.
+///
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <pvsutil/Assert.h>
+
+#include "../Vector.h"
+
+#include "Streaming.h"
+
+namespace skelcl {
+
+namespace detail {
+
+namespace batch {
+
+///
+/// \brief Returns the table of offsets of the containers in the packed
+///        container. The i-th container starts at offsets[i] and ends at
+///        offsets[i+1].
+///
+template <template <typename> class C, typename T>
+std::vector<size_t> offsets(const std::vector<C<T>>& containers)
+{
+  std::vector<size_t> offsets(containers.size() + 1, 0);
+  for (size_t i = 0; i < containers.size(); ++i) {
+    offsets[i+1] = offsets[i] + streaming::elementCount(containers[i]);
+  }
+  return offsets;
+}
+
+///
+/// \brief Packs the first offsets[i+1] - offsets[i] elements of every
+///        container into a single Vector.
+///
+template <template <typename> class C, typename T>
+Vector<T> pack(const std::vector<C<T>>& containers,
+               const std::vector<size_t>& offsets)
+{
+  ASSERT(offsets.size() == containers.size() + 1);
+
+  Vector<T> packed(offsets.back());
+  for (size_t i = 0; i < containers.size(); ++i) {
+    auto size = offsets[i+1] - offsets[i];
+    ASSERT(streaming::elementCount(containers[i]) >= size);
+
+    containers[i].copyDataToHost();
+    std::copy(containers[i].hostData(), containers[i].hostData() + size,
+              packed.hostData() + offsets[i]);
+  }
+  return packed;
+}
+
+///
+/// \brief Provides one output container of the same size (or shape) as
+///        every input container, with room for its elements on the host.
+///        The previous contents of the outputs are discarded, as they are
+///        overwritten by unpack.
+///
+template <template <typename> class C, typename Tout, typename Tin>
+void prepareOutputs(std::vector<C<Tout>>& outputs,
+                    const std::vector<C<Tin>>& inputs)
+{
+  outputs.resize(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    // the data on the devices is not downloaded, marking the host as up to
+    // date lets resize allocate the storage on the host instead
+    bool onHost = outputs[i].hostIsUpToDate();
+    outputs[i].dataOnHostModified();
+    if (!onHost || outputs[i].size() != inputs[i].size()) {
+      outputs[i].resize(inputs[i].size());
+    }
+  }
+}
+
+///
+/// \brief Copies the elements of the packed container back into the
+///        prepared output containers.
+///
+template <template <typename> class C, typename T>
+void unpack(const Vector<T>& packed, const std::vector<size_t>& offsets,
+            std::vector<C<T>>& outputs)
+{
+  ASSERT(offsets.size() == outputs.size() + 1);
+
+  packed.copyDataToHost();
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    std::copy(packed.hostData() + offsets[i],
+              packed.hostData() + offsets[i+1],
+              outputs[i].hostData());
+    outputs[i].dataOnHostModified();
+  }
+}
+
+} // namespace batch
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // BATCH_H_
@@ -89,7 +89,7 @@ void BlockDistribution<C<T>>::startUpload(C<T>& container,
     auto& buffer = container.deviceBuffer(*devicePtr);
 
     auto event = devicePtr->enqueueWrite(buffer,
-                                         container.hostBuffer().begin(),
+                                         container.hostData(),
                                          offset);
     offset += buffer.size();
     events->insert(event);
@@ -108,7 +108,7 @@ void BlockDistribution<C<T>>::startDownload(C<T>& container,
     auto& buffer = container.deviceBuffer(*devicePtr);
 
     auto event = devicePtr->enqueueRead(buffer,
-                                        container.hostBuffer().begin(),
+                                        container.hostData(),
                                         offset);
     offset += buffer.size();
     events->insert(event);
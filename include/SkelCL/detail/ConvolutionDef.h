@@ -0,0 +1,307 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ConvolutionDef.h
+///
+#ifndef CONVOLUTIONDEF_H_
+#define CONVOLUTIONDEF_H_
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.h>
+#undef __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "../Distributions.h"
+#include "../Matrix.h"
+#include "../Out.h"
+
+#include "Device.h"
+#include "KernelUtil.h"
+#include "Program.h"
+#include "Skeleton.h"
+#include "Util.h"
+
+namespace skelcl {
+
+template <typename Tin, typename Tout>
+Convolution<Tout(Tin)>::Convolution(const std::vector<Tout>& rowCoefficients,
+                                    const std::vector<Tout>& columnCoefficients,
+                                    detail::Padding padding,
+                                    Tin neutral_element)
+  : detail::Skeleton(),
+    _rowCoefficients(rowCoefficients),
+    _columnCoefficients(columnCoefficients),
+    _rowRadius(static_cast<unsigned int>(rowCoefficients.size() / 2)),
+    _columnRadius(static_cast<unsigned int>(columnCoefficients.size() / 2)),
+    _padding(padding), _neutral_element(neutral_element),
+    _program(createAndBuildProgram())
+{
+  static_assert(std::is_arithmetic<Tout>::value,
+                "Convolution requires arithmetic coefficients");
+  LOG_DEBUG_INFO("Create new Convolution object (", this, ")");
+}
+
+template <typename Tin, typename Tout>
+Matrix<Tout> Convolution<Tout(Tin)>::operator()(const Matrix<Tin>& in)
+{
+  Matrix<Tout> output;
+  this->operator()(out(output), in);
+  return output;
+}
+
+template <typename Tin, typename Tout>
+Matrix<Tout>& Convolution<Tout(Tin)>::operator()(Out<Matrix<Tout>> output,
+                                                 const Matrix<Tin>& in)
+{
+  ASSERT(in.rowCount() > 0);
+  ASSERT(in.columnCount() > 0);
+
+  prepareInput(in);
+
+  prepareOutput(output.container(), in);
+
+  // intermediate result of the row pass, including the halo rows
+  Matrix<Tout> temp;
+  prepareOutput(temp, in);
+
+  execute(output.container(), temp, in);
+
+  // ... finally update modification status
+  output.container().dataOnDeviceModified();
+
+  return output.container();
+}
+
+template <typename Tin, typename Tout>
+void Convolution<Tout(Tin)>::execute(Matrix<Tout>& output, Matrix<Tout>& temp,
+                                     const Matrix<Tin>& in)
+{
+  ASSERT(in.distribution().isValid());
+  ASSERT(output.rowCount() == in.rowCount() &&
+         output.columnCount() == in.columnCount());
+
+  const cl_uint cols = static_cast<cl_uint>(in.columnCount());
+  cl_uint rowOffset = 0;
+
+  for (auto& devicePtr : in.distribution().devices()) {
+    cl::Kernel rowKernel(_program.kernel(*devicePtr, "SCL_CONVOLUTION_ROWS"));
+    cl::Kernel columnKernel(
+        _program.kernel(*devicePtr, "SCL_CONVOLUTION_COLUMNS"));
+
+    cl_uint workgroupSize = static_cast<cl_uint>(
+        std::min(detail::kernelUtil::determineWorkgroupSizeForKernel(
+                     rowKernel, *devicePtr),
+                 detail::kernelUtil::determineWorkgroupSizeForKernel(
+                     columnKernel, *devicePtr)));
+
+    auto& inputBuffer = in.deviceBuffer(*devicePtr);
+    auto& tempBuffer = temp.deviceBuffer(*devicePtr);
+    auto& outputBuffer = output.deviceBuffer(*devicePtr);
+
+    // the row pass covers the halo rows as well, as they are read by the
+    // column pass
+    cl_uint bufferRows = static_cast<cl_uint>(inputBuffer.size() / cols);
+    cl_uint elements = static_cast<cl_uint>(
+        inputBuffer.size() - 2 * _columnRadius * cols);
+    cl_uint local[2] = {static_cast<cl_uint>(sqrt(workgroupSize)), local[0]};
+    cl_uint globalCols = static_cast<cl_uint>(
+        detail::util::ceilToMultipleOf(cols, local[0]));
+
+    LOG_DEBUG_INFO("elements: ", elements, " radius: ", _rowRadius, ",",
+                   _columnRadius);
+
+    try
+    {
+      int j = 0;
+      rowKernel.setArg(j++, inputBuffer.clBuffer());
+      rowKernel.setArg(j++, tempBuffer.clBuffer());
+      rowKernel.setArg(j++,
+                       local[1] * (local[0] + 2 * _rowRadius) * sizeof(Tin),
+                       NULL); // allocate local memory
+      rowKernel.setArg(j++, bufferRows);
+      rowKernel.setArg(j++, cols);
+
+      j = 0;
+      columnKernel.setArg(j++, tempBuffer.clBuffer());
+      columnKernel.setArg(j++, outputBuffer.clBuffer());
+      columnKernel.setArg(j++,
+                          local[0] * (local[1] + 2 * _columnRadius) *
+                              sizeof(Tout),
+                          NULL); // allocate local memory
+      columnKernel.setArg(j++, elements);
+      columnKernel.setArg(j++, cols);
+      columnKernel.setArg(j++, rowOffset);
+      columnKernel.setArg(j++, static_cast<cl_uint>(in.rowCount()));
+
+      // keep buffers alive / mark them as in use
+      auto keepAlive = detail::kernelUtil::keepAlive(
+          *devicePtr, inputBuffer.clBuffer(), tempBuffer.clBuffer(),
+          outputBuffer.clBuffer());
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter = [=]() { (void)keepAlive; };
+
+      // both passes are enqueued in order into the same queue
+      devicePtr->enqueue(rowKernel,
+                         cl::NDRange(globalCols,
+                                     detail::util::ceilToMultipleOf(
+                                         bufferRows, local[1])),
+                         cl::NDRange(local[0], local[1]),
+                         cl::NullRange, // offset
+                         invokeAfter);
+      devicePtr->enqueue(columnKernel,
+                         cl::NDRange(globalCols,
+                                     detail::util::ceilToMultipleOf(
+                                         elements / cols, local[1])),
+                         cl::NDRange(local[0], local[1]),
+                         cl::NullRange, // offset
+                         invokeAfter);
+    }
+    catch (cl::Error& err)
+    {
+      ABORT_WITH_ERROR(err);
+    }
+
+    rowOffset += elements / cols;
+  }
+  LOG_INFO("Convolution kernels started");
+}
+
+template <typename Tin, typename Tout>
+std::string
+    Convolution<Tout(Tin)>::coefficientsToString(const std::vector<Tout>& c)
+{
+  std::stringstream s;
+  // print floating point coefficients exactly and as literals of type Tout
+  s.precision(std::numeric_limits<Tout>::digits10 + 2);
+  if (std::is_floating_point<Tout>::value) s << std::showpoint;
+
+  for (size_t i = 0; i < c.size(); ++i) {
+    if (i > 0) s << ", ";
+    s << c[i];
+    if (std::is_same<Tout, float>::value) s << "f";
+  }
+  return s.str();
+}
+
+template <typename Tin, typename Tout>
+detail::Program Convolution<Tout(Tin)>::createAndBuildProgram() const
+{
+  ASSERT_MESSAGE(_rowCoefficients.size() % 2 == 1,
+                 "Convolution requires an odd number of row coefficients");
+  ASSERT_MESSAGE(_columnCoefficients.size() % 2 == 1,
+                 "Convolution requires an odd number of column coefficients");
+
+  std::stringstream temp;
+
+  temp << "#define SCL_ROW_RADIUS (" << _rowRadius << ")\n"
+       << "#define SCL_COLUMN_RADIUS (" << _columnRadius << ")\n";
+  temp << detail::paddingDefinitions(_padding, _neutral_element);
+
+  // create program
+  std::string s(Matrix<Tout>::deviceFunctions());
+  s.append(temp.str());
+
+  s.append(R"(
+
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+
+)");
+
+  // the coefficients are specialized into the program as constants
+  s.append("__constant SCL_TYPE_1 SCL_ROW_COEFFICIENTS[] = { ");
+  s.append(coefficientsToString(_rowCoefficients));
+  s.append(" };\n__constant SCL_TYPE_1 SCL_COLUMN_COEFFICIENTS[] = { ");
+  s.append(coefficientsToString(_columnCoefficients));
+  s.append(" };\n");
+
+  // convolution skeleton source
+  s.append(
+#include "ConvolutionKernel.cl"
+      );
+
+  auto program = detail::Program(s, detail::util::hash("//Convolution\n" + s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    program.adjustTypes<Tin, Tout>();
+  }
+  program.build();
+
+  return program;
+}
+
+template <typename Tin, typename Tout>
+void Convolution<Tout(Tin)>::prepareInput(const Matrix<Tin>& in)
+{
+  // set distribution, only the rows of the column pass require a halo
+  in.setDistribution(detail::OLDistribution<Matrix<Tin>>(
+      _columnRadius, _padding, _neutral_element));
+
+  // create buffers if required
+  in.createDeviceBuffers();
+
+  // copy data to devices
+  in.startUpload();
+}
+
+template <typename Tin, typename Tout>
+void Convolution<Tout(Tin)>::prepareOutput(Matrix<Tout>& output,
+                                           const Matrix<Tin>& in)
+{
+  // set size
+  if (output.size() != in.size())
+    output.resize(
+        typename Matrix<Tout>::size_type(in.rowCount(), in.columnCount()));
+
+  // adopt distribution from in input
+  output.setDistribution(in.distribution());
+
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
+} // namespace skelcl
+
+#endif // CONVOLUTIONDEF_H_
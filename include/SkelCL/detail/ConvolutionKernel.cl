@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ConvolutionKernel.cl
+///
+
+R"(
+// First pass: filters every row stored by the device, including the halo
+// rows. Each row of the work-group loads its part of the row plus the
+// SCL_ROW_RADIUS elements on both sides into local memory.
+__kernel void SCL_CONVOLUTION_ROWS(const __global SCL_TYPE_0* SCL_IN,
+                                   __global SCL_TYPE_1* SCL_TMP,
+                                   __local SCL_TYPE_0* SCL_SHARED,
+                                   const unsigned int SCL_BUFFER_ROWS,
+                                   const unsigned int SCL_COLS)
+{
+  const int col = get_global_id(0);
+  const int row = get_global_id(1);
+  const int rows = SCL_BUFFER_ROWS;
+  const int cols = SCL_COLS;
+  const int localCol = get_local_id(0);
+  const int localWidth = get_local_size(0);
+  const int lineWidth = localWidth + 2 * SCL_ROW_RADIUS;
+  const int firstCol = get_group_id(0) * localWidth - SCL_ROW_RADIUS;
+
+  __local SCL_TYPE_0* line = SCL_SHARED + get_local_id(1) * lineWidth;
+
+  int i;
+  if (row < rows) {
+    for (i = localCol; i < lineWidth; i += localWidth) {
+      const int c = firstCol + i;
+#ifdef NEUTRAL
+      line[i] = (c < 0 || c >= cols) ? NEUTRAL : SCL_IN[row * cols + c];
+#else
+      line[i] = SCL_IN[row * cols + SCL_REMAP(c, cols)];
+#endif
+    }
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (row < rows && col < cols) {
+    SCL_TYPE_1 sum = 0;
+    for (i = 0; i <= 2 * SCL_ROW_RADIUS; ++i) {
+      sum += SCL_ROW_COEFFICIENTS[i] * line[localCol + i];
+    }
+    SCL_TMP[row * cols + col] = sum;
+  }
+}
+
+// Second pass: filters the columns of the result of the first pass for the
+// rows computed by the device. The work-group loads a tile of its columns
+// with SCL_COLUMN_RADIUS additional rows above and below into local memory.
+__kernel void SCL_CONVOLUTION_COLUMNS(const __global SCL_TYPE_1* SCL_TMP,
+                                      __global SCL_TYPE_1* SCL_OUT,
+                                      __local SCL_TYPE_1* SCL_SHARED,
+                                      const unsigned int SCL_ELEMENTS,
+                                      const unsigned int SCL_COLS,
+                                      const unsigned int SCL_ROW_OFFSET,
+                                      const unsigned int SCL_ROWS)
+{
+  const int col = get_global_id(0);
+  const int row = get_global_id(1);
+  const int cols = SCL_COLS;
+  const int deviceRows = SCL_ELEMENTS / SCL_COLS;
+  const int localCol = get_local_id(0);
+  const int localRow = get_local_id(1);
+  const int localWidth = get_local_size(0);
+  const int localHeight = get_local_size(1);
+  const int tileHeight = localHeight + 2 * SCL_COLUMN_RADIUS;
+  const int firstRow = get_group_id(1) * localHeight - SCL_COLUMN_RADIUS;
+
+  int i;
+  if (col < cols) {
+    for (i = localRow; i < tileHeight; i += localHeight) {
+      int r = firstRow + i;
+      if (r >= deviceRows + SCL_COLUMN_RADIUS) break; // never accessed
+#ifdef SCL_NO_PADDING
+      // no padding rows are stored on the first and last device, rows outside
+      // of the matrix are remapped to rows stored by the device instead
+      const int matrixRow = (int)SCL_ROW_OFFSET + r;
+      if (matrixRow < 0 || matrixRow >= (int)SCL_ROWS) {
+        r = SCL_REMAP(matrixRow, SCL_ROWS) - (int)SCL_ROW_OFFSET;
+      }
+#endif
+      SCL_SHARED[i * localWidth + localCol] =
+          SCL_TMP[(r + SCL_COLUMN_RADIUS) * cols + col];
+    }
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (row < deviceRows && col < cols) {
+    SCL_TYPE_1 sum = 0;
+    for (i = 0; i <= 2 * SCL_COLUMN_RADIUS; ++i) {
+      sum += SCL_COLUMN_COEFFICIENTS[i] *
+             SCL_SHARED[(localRow + i) * localWidth + localCol];
+    }
+    SCL_OUT[(row + SCL_COLUMN_RADIUS) * cols + col] = sum;
+  }
+}
+)"
@@ -88,7 +88,7 @@ void CopyDistribution<C<T>>::startUpload(C<T>& container,
     auto& buffer = container.deviceBuffer(*devicePtr);
 
     auto event = devicePtr->enqueueWrite(buffer,
-                                         container.hostBuffer().begin());
+                                         container.hostData());
     events->insert(event);
   }
 }
@@ -105,7 +105,7 @@ void CopyDistribution<C<T>>::startDownload(C<T>& container,
 
     auto& buffer = container.deviceBuffer(firstDevice);
 
-    auto event = firstDevice.enqueueRead(buffer,container.hostBuffer().begin());
+    auto event = firstDevice.enqueueRead(buffer,container.hostData());
 
     events->insert(event);
 
@@ -125,7 +125,7 @@ void CopyDistribution<C<T>>::startDownload(C<T>& container,
         events->insert(event);
       } else { // ... the "last" device writes directly to the host buffer
         auto event = devicePtr->enqueueRead( deviceBuffer,
-                                             container.hostBuffer().begin() );
+                                             container.hostData() );
         events->insert(event);
       }
     }
@@ -134,8 +134,8 @@ void CopyDistribution<C<T>>::startDownload(C<T>& container,
     // combine all vs into hostPointer using _combineFunc
     for (unsigned i = 0; i < vs.size(); ++i) {
       std::transform(vs[i].begin(), vs[i].end(),
-                     static_cast<T*>(&(container.hostBuffer().front())),
-                     static_cast<T*>(&(container.hostBuffer().front())),
+                     container.hostData(),
+                     container.hostData(),
                      this->_combineFunc);
     }
   }
@@ -155,9 +155,18 @@ size_t
 
 template <template <typename> class C, typename T>
 bool CopyDistribution<C<T>>::dataExchangeOnDistributionChange(
-                                   Distribution<C<T>>& /*newDistribution*/)
+                                   Distribution<C<T>>& newDistribution)
 {
-  return true; // always do data exchange for copy distibution
+  auto copy = dynamic_cast<CopyDistribution<C<T>>*>(&newDistribution);
+
+  if (   copy != nullptr
+      && this->_devices == copy->_devices // same set of devices
+      && _combineFunc == nullptr // all devices store the same data
+     ) {
+    return false; // => no data exchange, the copies can be reused
+  } else {
+    return true;  // => data exchange
+  }
 }
 
 template <template <typename> class C, typename T>
@@ -126,6 +126,25 @@ public:
                     const cl::NDRange& offset = cl::NullRange,
                     const std::function<void()> callback = nullptr) const;
 
+  ///
+  /// \brief Enqueues the execution of an OpenCL kernel object on the device,
+  ///        which starts only after all events in waitFor have completed
+  ///
+  /// \param kernel  The OpenCL kernel to be enqueued
+  ///        global  The total number of OpenCL Work Items to be used in the
+  ///                kernel execution
+  ///        local   The number of OpenCL Work Items to form an OpenCL Work
+  ///                Group
+  ///        waitFor Events which have to complete before the kernel starts
+  ///
+  /// \return An OpenCL Event object which can be used to wait for the
+  ///         operation to complete
+  ///
+  cl::Event enqueue(const cl::Kernel& kernel,
+                    const cl::NDRange& global,
+                    const cl::NDRange& local,
+                    const VECTOR_CLASS<cl::Event>& waitFor) const;
+
   ///
   /// \brief Enqueues a memory operation to copy data to the devices memory
   ///
@@ -222,6 +241,82 @@ public:
                         size_t deviceOffset,
                         size_t hostOffset = 0) const;
 
+  ///
+  /// \brief Enqueues a memory operation to copy a rectangular block of
+  ///        elements from the devices memory with a single command
+  ///
+  /// \param buffer         The Buffer on the device from which the data should
+  ///                       be copied
+  ///        hostPointer    Pointer pointing to the memory location to which
+  ///                       the data should be copied
+  ///        rows           Number of rows of the block
+  ///        columns        Number of elements in every row of the block
+  ///        deviceRowPitch Number of elements between two rows in buffer
+  ///        hostRowPitch   Number of elements between two rows at hostPointer
+  ///        deviceOffset   Position of the first element of the block in
+  ///                       buffer
+  ///        hostOffset     Position of the first element of the block at
+  ///                       hostPointer
+  ///
+  /// \return An OpenCL Event object which can be used to wait for the
+  ///         operation to complete
+  ///
+  cl::Event enqueueReadRect(const DeviceBuffer& buffer,
+                            void* const hostPointer,
+                            size_t rows,
+                            size_t columns,
+                            size_t deviceRowPitch,
+                            size_t hostRowPitch,
+                            size_t deviceOffset,
+                            size_t hostOffset) const;
+
+  ///
+  /// \brief Enqueues a memory operation to copy size elements from
+  ///        hostPointer to the beginning of buffer using the transfer queue
+  ///        of the device.
+  ///
+  /// Operations on the transfer queue are executed in order with respect to
+  /// each other, but independently of the kernels and memory operations
+  /// enqueued by the other functions of this class. Therefore, transfers can
+  /// overlap with kernel executions. Dependencies have to be expressed
+  /// explicitly with waitFor.
+  ///
+  /// \param buffer      The Buffer on the device to which the data should be
+  ///                    copied
+  ///        hostPointer Pointer to the data which should be copied
+  ///        size        Number of elements to be copied
+  ///        waitFor     Events which have to complete before the transfer
+  ///                    starts
+  ///
+  /// \return An OpenCL Event object which can be used to wait for the
+  ///         operation to complete
+  ///
+  cl::Event enqueueTransferWrite(const DeviceBuffer& buffer,
+                                 const void* hostPointer,
+                                 size_t size,
+                                 const VECTOR_CLASS<cl::Event>& waitFor) const;
+
+  ///
+  /// \brief Enqueues a memory operation to copy size elements from the
+  ///        beginning of buffer to hostPointer using the transfer queue of
+  ///        the device. See enqueueTransferWrite().
+  ///
+  /// \param buffer      The Buffer on the device from which the data should
+  ///                    be copied
+  ///        hostPointer Pointer to the memory location to which the data
+  ///                    should be copied
+  ///        size        Number of elements to be copied
+  ///        waitFor     Events which have to complete before the transfer
+  ///                    starts
+  ///
+  /// \return An OpenCL Event object which can be used to wait for the
+  ///         operation to complete
+  ///
+  cl::Event enqueueTransferRead(const DeviceBuffer& buffer,
+                                void* hostPointer,
+                                size_t size,
+                                const VECTOR_CLASS<cl::Event>& waitFor) const;
+
   ///
   /// \brief Enqueues a memory operation to copy data from one buffer to the
   ///        other. Both buffers should reside on the same device (or at least
@@ -356,6 +451,7 @@ private:
   cl::Device        _device;
   cl::Context       _context;
   cl::CommandQueue  _commandQueue;
+  cl::CommandQueue  _transferQueue;
   id_type           _id;
 };
 
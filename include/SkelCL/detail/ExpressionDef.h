@@ -0,0 +1,243 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ExpressionDef.h
+///
+
+#ifndef EXPRESSION_DEF_H_
+#define EXPRESSION_DEF_H_
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "../Distributions.h"
+#include "../Out.h"
+#include "../Vector.h"
+
+#include "Device.h"
+#include "DeviceBuffer.h"
+#include "ExpressionNode.h"
+#include "Program.h"
+#include "Util.h"
+
+namespace skelcl {
+
+namespace detail {
+
+template <typename T>
+class VectorLeaf : public ExpressionLeaf {
+public:
+  VectorLeaf(const Vector<T>& vector)
+    : _vector(vector)
+  {
+  }
+
+  const void* container() const
+  {
+    return &_vector;
+  }
+
+  size_t size() const
+  {
+    return _vector.size();
+  }
+
+  std::string typeName() const
+  {
+    return util::typeToString<T>();
+  }
+
+  void distribute(bool forceBlock) const
+  {
+    if (forceBlock || !_vector.distribution().isValid()) {
+      _vector.setDistribution(BlockDistribution<Vector<T>>());
+    }
+    _vector.createDeviceBuffers();
+  }
+
+  void startUpload() const
+  {
+    _vector.startUpload();
+  }
+
+  const DeviceList& devices() const
+  {
+    return _vector.distribution().devices();
+  }
+
+  const DeviceBuffer& deviceBuffer(const Device& device) const
+  {
+    return _vector.deviceBuffer(device);
+  }
+
+private:
+  const Vector<T>& _vector;
+};
+
+} // namespace detail
+
+template <typename T>
+Expression<T>::Expression(const Vector<T>& vector)
+  : _node(std::make_shared<const detail::ExpressionNode>(
+            std::make_shared<const detail::VectorLeaf<T>>(vector))),
+    _distribution([&vector]() {
+                    return detail::cloneAndConvert<Vector<T>>(
+                             vector.distribution());
+                  })
+{
+}
+
+template <typename T>
+template <typename U>
+Expression<T>::Expression(detail::ExpressionNode::ptr_type node,
+                          const Expression<U>& reference)
+  : _node(std::move(node)),
+    _distribution([reference]() {
+                    return detail::cloneAndConvert<Vector<T>>(
+                             *reference._distribution());
+                  })
+{
+}
+
+template <typename T>
+size_t Expression<T>::size() const
+{
+  return _node->size();
+}
+
+template <typename T>
+Vector<T> Expression<T>::eval() const
+{
+  Vector<T> output;
+  eval(out(output));
+  return output;
+}
+
+template <typename T>
+Vector<T>& Expression<T>::eval(Out<Vector<T>> output) const
+{
+  auto leaves = _node->leaves();
+  detail::ExpressionNode::prepareLeaves(leaves);
+
+  // prepare output: adopt distribution from the first vector read
+  auto& container = output.container();
+  if (container.size() < size()) {
+    container.resize(size());
+  }
+  container.setDistribution(_distribution());
+  container.createDeviceBuffers();
+
+  auto& program = _node->program(detail::util::typeToString<T>());
+
+  for (auto& devicePtr : leaves.front()->devices()) {
+    auto& outputBuffer = container.deviceBuffer(*devicePtr);
+
+    size_t workGroupSize = _node->workGroupSize();
+    if (workGroupSize == 0) {
+      workGroupSize = devicePtr->maxWorkGroupSize();
+    }
+
+    cl_uint elements  = static_cast<cl_uint>(
+                          leaves.front()->deviceBuffer(*devicePtr).size() );
+    cl_uint local     = static_cast<cl_uint>(
+                          std::min(workGroupSize,
+                                   devicePtr->maxWorkGroupSize()) );
+    cl_uint global    = static_cast<cl_uint>(
+                          detail::util::ceilToMultipleOf(elements, local) );
+
+    try {
+      cl::Kernel kernel(program.kernel(*devicePtr, "SCL_FUSED"));
+
+      std::vector<cl::Buffer> keepAlive;
+      for (auto& leaf : leaves) {
+        keepAlive.push_back(leaf->deviceBuffer(*devicePtr).clBuffer());
+      }
+      keepAlive.push_back(outputBuffer.clBuffer());
+
+      cl_uint i = 0;
+      for (auto& buffer : keepAlive) {
+        kernel.setArg(i++, buffer);
+      }
+      kernel.setArg(i, elements);
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter =  [=] () {
+                                    (void)keepAlive;
+                                 };
+
+      devicePtr->enqueue(kernel,
+                         cl::NDRange(global), cl::NDRange(local),
+                         cl::NullRange, // offset
+                         invokeAfter);
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+  }
+  LOG_DEBUG_INFO("Fused kernel started");
+
+  container.dataOnDeviceModified();
+
+  return container;
+}
+
+template <typename T>
+Expression<T>::operator Vector<T>() const
+{
+  return eval();
+}
+
+template <typename T>
+const detail::ExpressionNode::ptr_type& Expression<T>::node() const
+{
+  return _node;
+}
+
+template <typename T>
+Expression<T> lazy(const Vector<T>& vector)
+{
+  return Expression<T>(vector);
+}
+
+} // namespace skelcl
+
+#endif // EXPRESSION_DEF_H_
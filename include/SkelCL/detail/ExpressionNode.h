@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ExpressionNode.h
+///
+
+#ifndef EXPRESSION_NODE_H_
+#define EXPRESSION_NODE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DeviceBuffer.h"
+#include "DeviceList.h"
+#include "Program.h"
+#include "skelclDll.h"
+
+namespace skelcl {
+
+namespace detail {
+
+class Device;
+
+///
+/// \brief Type erased view on a container which is read by a fused kernel.
+///
+class SKELCL_DLL ExpressionLeaf {
+public:
+  virtual ~ExpressionLeaf();
+
+  /// \brief Identifies the container, so that it is uploaded and passed to
+  ///        the fused kernel only once even if it is read multiple times.
+  virtual const void* container() const = 0;
+
+  virtual size_t size() const = 0;
+
+  /// \brief The OpenCL name of the element type.
+  virtual std::string typeName() const = 0;
+
+  /// \brief Sets the distribution (the block distribution if forceBlock is
+  ///        set or no valid distribution is set) and creates the buffers.
+  virtual void distribute(bool forceBlock) const = 0;
+
+  virtual void startUpload() const = 0;
+
+  virtual const DeviceList& devices() const = 0;
+
+  virtual const DeviceBuffer& deviceBuffer(const Device& device) const = 0;
+};
+
+///
+/// \brief A node in a lazily evaluated graph of element-wise skeleton calls.
+///
+/// Every node is either a leaf reading a container or the application of a
+/// user-defined function to the values of its operands. When the graph is
+/// evaluated, the user-defined functions of all nodes are composed at source
+/// level into a single kernel, so that no intermediate containers are
+/// created.
+///
+class SKELCL_DLL ExpressionNode {
+public:
+  typedef std::shared_ptr<const ExpressionNode> ptr_type;
+  typedef std::vector<std::shared_ptr<const ExpressionLeaf>> leaves_type;
+
+  explicit ExpressionNode(std::shared_ptr<const ExpressionLeaf> leaf);
+
+  ExpressionNode(const std::string& source,
+                 const std::string& funcName,
+                 std::vector<ptr_type> operands,
+                 size_t workGroupSize);
+
+  ExpressionNode(const ExpressionNode&) = delete;
+
+  ExpressionNode& operator=(const ExpressionNode&) = delete;
+
+  ~ExpressionNode();
+
+  size_t size() const;
+
+  size_t workGroupSize() const;
+
+  /// \brief All containers read by the graph, every container listed once.
+  leaves_type leaves() const;
+
+  /// \brief Distributes all leaves alike and uploads their data.
+  ///
+  /// Leaves without a valid distribution are block distributed. If the
+  /// leaves are partitioned differently across the devices afterwards, all
+  /// of them are redistributed using the block distribution.
+  static void prepareLeaves(const leaves_type& leaves);
+
+  /// \brief Returns the program containing the fused kernel SCL_FUSED with
+  ///        this node as root. The program is build on first use.
+  ///
+  /// The kernel expects one buffer per leaf, the output buffer and the
+  /// number of elements as arguments.
+  const Program& program(const std::string& outputType) const;
+
+private:
+  void collect(leaves_type& leaves,
+               std::vector<const ExpressionNode*>& functions) const;
+
+  std::string code(const leaves_type& leaves,
+                   const std::vector<const ExpressionNode*>& functions) const;
+
+  std::shared_ptr<const ExpressionLeaf> _leaf;
+  std::string                           _source;
+  std::string                           _funcName;
+  std::vector<ptr_type>                 _operands;
+  size_t                                _workGroupSize;
+  mutable std::unique_ptr<Program>      _program;
+};
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // EXPRESSION_NODE_H_
@@ -104,6 +104,20 @@ void setKernelArgs(cl::Kernel& kernel,
                    Matrix<T>& matrix,
                    Args&&... args);
 
+template <typename... Fields, typename... Args>
+void setKernelArgs(cl::Kernel& kernel,
+                   const Device& device,
+                   size_t index,
+                   Out<SoAVector<Fields...>>&& soaVector,
+                   Args&&... args);
+
+template <typename... Fields, typename... Args>
+void setKernelArgs(cl::Kernel& kernel,
+                   const Device& device,
+                   size_t index,
+                   SoAVector<Fields...>& soaVector,
+                   Args&&... args);
+
 template <typename... Args>
 void setKernelArgs(cl::Kernel& kernel,
                    const Device& device,
@@ -192,6 +206,38 @@ void setKernelArgs(cl::Kernel& kernel,
                  std::forward<Args>(args)... );
 }
 
+template <typename... Fields, typename... Args>
+void setKernelArgs(cl::Kernel& kernel,
+                   const Device& device,
+                   size_t index,
+                   Out<SoAVector<Fields...>>&& outSoAVector,
+                   Args&&... args)
+{
+  setKernelArgs( kernel, device, index,
+                 outSoAVector.container(), std::forward<Args>(args)... );
+}
+
+template <typename... Fields, typename... Args>
+void setKernelArgs(cl::Kernel& kernel,
+                   const Device& device,
+                   size_t index,
+                   SoAVector<Fields...>& soaVector,
+                   Args&&... args)
+{
+  // pass one buffer for every field
+  for (auto& buffer : soaVector.clBuffers(device)) {
+    try {
+      kernel.setArg( static_cast<cl_uint>(index), buffer );
+    } catch (cl::Error& err) {
+      LOG_ERROR("Error while setting argument ", index,
+        " (SoAVector version called)");
+      ABORT_WITH_ERROR(err);
+    }
+    ++index;
+  }
+  setKernelArgs( kernel, device, index, std::forward<Args>(args)... );
+}
+
 template <typename... Args>
 void setKernelArgs(cl::Kernel& kernel,
                    const Device& device,
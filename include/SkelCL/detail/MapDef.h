@@ -44,9 +44,12 @@
 #include <istream>
 #include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <cmath>
 
@@ -58,16 +61,20 @@
 #include <pvsutil/Logger.h>
 
 #include "../Distributions.h"
+#include "../Expression.h"
 #include "../Index.h"
 #include "../Out.h"
 #include "../Matrix.h"
 #include "../Source.h"
 #include "../Vector.h"
 
+#include "Batch.h"
 #include "Device.h"
+#include "ExpressionNode.h"
 #include "KernelUtil.h"
 #include "Program.h"
 #include "Skeleton.h"
+#include "Streaming.h"
 #include "Util.h"
 
 namespace skelcl {
@@ -76,7 +83,9 @@ template<typename Tin, typename Tout>
 Map<Tout(Tin)>::Map(const Source& source,
                     const std::string& funcName)
   : Skeleton(),
-    detail::MapHelper<Tout(Tin)>(createAndBuildProgram(source, funcName))
+    detail::MapHelper<Tout(Tin)>(createAndBuildProgram(source, funcName)),
+    _source(source),
+    _funcName(funcName)
 {
   LOG_DEBUG_INFO("Create new Map object (", this, ")");
 }
@@ -99,6 +108,20 @@ C<Tout>& Map<Tout(Tin)>::operator()(Out<C<Tout>> output,
                                     const C<Tin>& input,
                                     Args&&... args) const
 {
+  if (   input.hostIsUpToDate()
+      && detail::streaming::isRequired(detail::streaming::elementCount(input),
+                                       sizeof(Tin) + sizeof(Tout)) ) {
+    prepareAdditionalInput(std::forward<Args>(args)...);
+
+    executeStreaming(output.container(), input, std::forward<Args>(args)...);
+
+    // output is only modified on the host
+    output.container().dataOnHostModified();
+    updateModifiedStatus(std::forward<Args>(args)...);
+
+    return output.container();
+  }
+
   this->prepareInput(input);
 
   prepareAdditionalInput(std::forward<Args>(args)...);
@@ -112,6 +135,51 @@ C<Tout>& Map<Tout(Tin)>::operator()(Out<C<Tout>> output,
   return output.container();
 }
 
+template <typename Tin, typename Tout>
+Expression<Tout> Map<Tout(Tin)>::operator()(const Expression<Tin>& input) const
+{
+  auto node = std::make_shared<const detail::ExpressionNode>(
+                _source, _funcName,
+                std::vector<detail::ExpressionNode::ptr_type>{ input.node() },
+                this->workGroupSize());
+  return Expression<Tout>(node, input);
+}
+
+template <typename Tin, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+std::vector<C<Tout>>& Map<Tout(Tin)>::batch(std::vector<C<Tout>>& outputs,
+                                            const std::vector<C<Tin>>& inputs,
+                                            Args&&... args) const
+{
+  auto offsets = detail::batch::offsets(inputs);
+
+  detail::batch::prepareOutputs(outputs, inputs);
+  if (offsets.back() == 0) return outputs; // nothing to compute
+
+  // pack all inputs into a single container, process it with a single kernel
+  // launch and unpack the results
+  Vector<Tin>  packedInput = detail::batch::pack(inputs, offsets);
+  Vector<Tout> packedOutput;
+  this->operator()(out(packedOutput), packedInput, std::forward<Args>(args)...);
+  detail::batch::unpack(packedOutput, offsets, outputs);
+
+  LOG_DEBUG_INFO("Map processed a batch of ", inputs.size(), " containers");
+  return outputs;
+}
+
+template <typename Tin, typename Tout>
+const std::string& Map<Tout(Tin)>::source() const
+{
+  return _source;
+}
+
+template <typename Tin, typename Tout>
+const std::string& Map<Tout(Tin)>::func() const
+{
+  return _funcName;
+}
+
 template <typename Tin, typename Tout>
 template <template <typename> class C,
           typename... Args>
@@ -165,6 +233,80 @@ void Map<Tout(Tin)>::execute(C<Tout>& output,
   LOG_DEBUG_INFO("Map kernel started");
 }
 
+template <typename Tin, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+void Map<Tout(Tin)>::executeStreaming(C<Tout>& output,
+                                      const C<Tin>& input,
+                                      Args&&... args) const
+{
+  namespace streaming = detail::streaming;
+
+  auto elements = streaming::elementCount(input);
+  const size_t bytesPerElement = sizeof(Tin) + sizeof(Tout);
+
+  if (static_cast<void*>(&output) != static_cast<const void*>(&input)) {
+    // resize container if required
+    if (streaming::elementCount(output) < elements) {
+      output.resize(input.size());
+    }
+  }
+
+  const Tin* inputPtr  = input.hostData();
+  Tout*      outputPtr = output.hostData();
+
+  streaming::Buffers inputBuffers(sizeof(Tin), bytesPerElement);
+  streaming::Buffers outputBuffers(sizeof(Tout), bytesPerElement);
+
+  auto upload = [&] (const streaming::Chunk& chunk,
+                     const streaming::Events& waitFor) {
+    return streaming::Events(1,
+             chunk.devicePtr->enqueueTransferWrite(inputBuffers[chunk],
+                                                   inputPtr + chunk.offset,
+                                                   chunk.size, waitFor) );
+  };
+
+  auto compute = [&] (const streaming::Chunk& chunk,
+                      const streaming::Events& waitFor) {
+    auto& devicePtr = chunk.devicePtr;
+    cl_uint elements  = static_cast<cl_uint>( chunk.size );
+    cl_uint local     = static_cast<cl_uint>(
+                          std::min(this->workGroupSize(),
+                                   devicePtr->maxWorkGroupSize()) );
+    cl_uint global    = static_cast<cl_uint>(
+                          detail::util::ceilToMultipleOf(elements, local) );
+    cl::Event event;
+    try {
+      cl::Kernel kernel(this->_program.kernel(*devicePtr, "SCL_MAP"));
+
+      kernel.setArg(0, inputBuffers[chunk].clBuffer());
+      kernel.setArg(1, outputBuffers[chunk].clBuffer());
+      kernel.setArg(2, elements);
+
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, 3,
+                                        std::forward<Args>(args)...);
+
+      event = devicePtr->enqueue(kernel,
+                                 cl::NDRange(global), cl::NDRange(local),
+                                 waitFor);
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+    return event;
+  };
+
+  auto download = [&] (const streaming::Chunk& chunk,
+                       const streaming::Events& waitFor) {
+    return chunk.devicePtr->enqueueTransferRead(outputBuffers[chunk],
+                                                outputPtr + chunk.offset,
+                                                chunk.size, waitFor);
+  };
+
+  streaming::process(elements, bytesPerElement, upload, compute, download);
+
+  LOG_DEBUG_INFO("Map streamed ", elements, " elements");
+}
+
 template <typename Tin, typename Tout>
 detail::Program
     Map<Tout(Tin)>::createAndBuildProgram(const std::string& source,
@@ -331,6 +473,204 @@ __kernel void SCL_MAP(
   return program;
 }
 
+// ## Map<Tin, std::tuple<Touts...>> ###################################
+template<typename Tin, typename... Touts>
+Map<std::tuple<Touts...>(Tin)>::Map(const Source& source,
+                                    const std::string& funcName)
+  : Skeleton(),
+    _program(createAndBuildProgram(source, funcName))
+{
+  LOG_DEBUG_INFO("Create new Map object (", this, ") with ",
+                 sizeof...(Touts), " outputs");
+}
+
+template <typename Tin, typename... Touts>
+template <template <typename> class C,
+          typename... Args>
+void Map<std::tuple<Touts...>(Tin)>::operator()(Out<C<Touts>>... outputs,
+                                                const C<Tin>& input,
+                                                Args&&... args) const
+{
+  prepareInput(input);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutputs(input, outputs...);
+
+  execute(input, outputs..., std::forward<Args>(args)...);
+
+  updateModifiedStatus(outputs..., std::forward<Args>(args)...);
+}
+
+template <typename Tin, typename... Touts>
+template <template <typename> class C,
+          typename... Args>
+void Map<std::tuple<Touts...>(Tin)>::execute(const C<Tin>& input,
+                                             Out<C<Touts>>... outputs,
+                                             Args&&... args) const
+{
+  ASSERT( input.distribution().isValid() );
+
+  for (auto& devicePtr : input.distribution().devices()) {
+    auto& inputBuffer = input.deviceBuffer(*devicePtr);
+
+    cl_uint elements  = static_cast<cl_uint>( inputBuffer.size() );
+    cl_uint local     = static_cast<cl_uint>(
+                          std::min(this->workGroupSize(),
+                                   devicePtr->maxWorkGroupSize()) );
+    cl_uint global    = static_cast<cl_uint>(
+                          detail::util::ceilToMultipleOf(elements, local) );
+
+    try {
+      cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_MAP"));
+
+      // the input buffer, one buffer per output, the number of elements and
+      // the additional arguments
+      kernel.setArg(0, inputBuffer.clBuffer());
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, 1,
+                                        outputs.container()
+                                            .deviceBuffer(*devicePtr)
+                                            .clBuffer()...,
+                                        elements,
+                                        std::forward<Args>(args)...);
+
+      auto keepAlive = detail::kernelUtil::keepAlive(*devicePtr,
+                                                     inputBuffer.clBuffer(),
+                                                     outputs.container()
+                                                       .deviceBuffer(*devicePtr)
+                                                       .clBuffer()...,
+                                                     std::forward<Args>(args)...
+                                                    );
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter =  [=] () {
+                                    (void)keepAlive;
+                                 };
+
+      devicePtr->enqueue(kernel,
+                         cl::NDRange(global), cl::NDRange(local),
+                         cl::NullRange, // offset
+                         invokeAfter);
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+  }
+  LOG_DEBUG_INFO("Map kernel started");
+}
+
+template <typename Tin, typename... Touts>
+template <template <typename> class C>
+void Map<std::tuple<Touts...>(Tin)>::prepareInput(const C<Tin>& input) const
+{
+  // set default distribution if required
+  if (!input.distribution().isValid()) {
+    input.setDistribution(detail::BlockDistribution<C<Tin>>());
+  }
+  // create buffers if required
+  input.createDeviceBuffers();
+  // copy data to devices
+  input.startUpload();
+}
+
+template <typename Tin, typename... Touts>
+template <template <typename> class C>
+void Map<std::tuple<Touts...>(Tin)>::prepareOutputs(const C<Tin>& /*input*/)
+                                                                        const
+{
+}
+
+template <typename Tin, typename... Touts>
+template <template <typename> class C, typename T, typename... Ts>
+void Map<std::tuple<Touts...>(Tin)>::prepareOutputs(const C<Tin>& input,
+                                                    Out<C<T>> output,
+                                                    Out<C<Ts>>... outputs)
+                                                                        const
+{
+  ASSERT_MESSAGE(   static_cast<void*>(&output.container())
+                 != static_cast<const void*>(&input),
+                 "The input can not be used as output of a Map skeleton "
+                 "with multiple outputs.");
+  // resize container if required
+  if (output.container().size() < input.size()) {
+    output.container().resize(input.size());
+  }
+  // adopt distribution from input
+  output.container().setDistribution(input.distribution());
+  // create buffers if required
+  output.container().createDeviceBuffers();
+
+  prepareOutputs(input, outputs...);
+}
+
+template <typename Tin, typename... Touts>
+detail::Program
+    Map<std::tuple<Touts...>(Tin)>::createAndBuildProgram(
+                                          const std::string& source,
+                                          const std::string& funcName) const
+{
+  ASSERT_MESSAGE(!source.empty(),
+                 "Tried to create program with empty user source.");
+
+  const size_t outputs = sizeof...(Touts);
+
+  // generate the kernel: the user function writes its results into private
+  // variables, which are then stored in the output buffers
+  std::stringstream kernel;
+  for (size_t i = 0; i <= outputs; ++i) {
+    kernel << "typedef float SCL_TYPE_" << i << ";\n";
+  }
+  kernel << "\n__kernel void SCL_MAP(\n"
+         << "    const __global SCL_TYPE_0*  SCL_IN,\n";
+  for (size_t i = 0; i < outputs; ++i) {
+    kernel << "          __global SCL_TYPE_" << i + 1 << "*  SCL_OUT_" << i
+           << ",\n";
+  }
+  kernel << "    const unsigned int          SCL_ELEMENTS)\n"
+         << "{\n"
+         << "  if (get_global_id(0) < SCL_ELEMENTS) {\n";
+  for (size_t i = 0; i < outputs; ++i) {
+    kernel << "    SCL_TYPE_" << i + 1 << " SCL_RESULT_" << i << ";\n";
+  }
+  kernel << "    SCL_FUNC(SCL_IN[get_global_id(0)]";
+  for (size_t i = 0; i < outputs; ++i) {
+    kernel << ", &SCL_RESULT_" << i;
+  }
+  kernel << ");\n";
+  for (size_t i = 0; i < outputs; ++i) {
+    kernel << "    SCL_OUT_" << i << "[get_global_id(0)] = SCL_RESULT_" << i
+           << ";\n";
+  }
+  kernel << "  }\n"
+         << "}\n";
+
+  // create program
+  // first: device specific functions
+  std::string s(detail::CommonDefinitions::getSource());
+  // second: user defined source
+  s.append(source);
+  // last: append skeleton implementation source
+  s.append("\n");
+  s.append(kernel.str());
+
+  auto program = detail::Program(s, detail::util::hash(s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    // append parameters from user function to kernel
+    program.transferParameters(funcName, 1 + outputs, "SCL_MAP");
+    program.transferArguments(funcName, 1 + outputs, "SCL_FUNC");
+    // rename user function
+    program.renameFunction(funcName, "SCL_FUNC");
+    // rename typedefs
+    program.adjustTypes<Tin, Touts...>();
+  }
+
+  // build program
+  program.build();
+
+  return program;
+}
+
 // ## Map<Index, Tout> ################################################
 template <typename Tout>
 Map<Tout(Index)>::Map(const Source& source, const std::string& funcName)
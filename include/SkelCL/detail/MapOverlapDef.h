@@ -46,6 +46,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.h>
@@ -56,6 +57,8 @@
 
 #include "../Distributions.h"
 #include "../Matrix.h"
+#include "../Vector.h"
+#include "../Volume.h"
 #include "../Reduce.h"
 #include "../Zip.h"
 #include "../Out.h"
@@ -75,7 +78,8 @@ MapOverlap<Tout(Tin)>::MapOverlap(const Source& source,
                                   const std::string& func)
   : detail::Skeleton(), _userSource(source), _funcName(func),
     _overlap_range(overlap_range), _padding(padding),
-    _neutral_element(neutral_element), _program(createAndBuildProgram())
+    _neutral_element(neutral_element), _time_steps(1),
+    _program(), _temporalProgram(), _vectorProgram(), _volumeProgram()
 {
   LOG_DEBUG_INFO("Create new MapOverlap object (", this, ")");
 }
@@ -98,7 +102,7 @@ Matrix<Tout>& MapOverlap<Tout(Tin)>::
   ASSERT(in.rowCount() > 0);
   ASSERT(in.columnCount() > 0);
 
-  prepareInput(in);
+  prepareInput(in, _overlap_range);
 
   prepareAdditionalInput(std::forward<Args>(args)...);
 
@@ -111,6 +115,149 @@ Matrix<Tout>& MapOverlap<Tout(Tin)>::
   return output.container();
 }
 
+template <typename Tin, typename Tout>
+template <typename... Args>
+Vector<Tout> MapOverlap<Tout(Tin)>::operator()(const Vector<Tin>& in,
+                                               Args&&... args)
+{
+  Vector<Tout> output;
+  this->operator()(out(output), in, std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Vector<Tout>& MapOverlap<Tout(Tin)>::
+    operator()(Out<Vector<Tout>> output, const Vector<Tin>& in, Args&&... args)
+{
+  ASSERT(in.size() > 0);
+
+  prepareInput(in);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutput(output.container(), in);
+
+  execute(output.container(), in, std::forward<Args>(args)...);
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Volume<Tout> MapOverlap<Tout(Tin)>::operator()(const Volume<Tin>& in,
+                                               Args&&... args)
+{
+  Volume<Tout> output;
+  this->operator()(out(output), in, std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Volume<Tout>& MapOverlap<Tout(Tin)>::
+    operator()(Out<Volume<Tout>> output, const Volume<Tin>& in, Args&&... args)
+{
+  ASSERT(!in.empty());
+
+  prepareInput(in);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutput(output.container(), in);
+
+  execute(output.container(), in, std::forward<Args>(args)...);
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Matrix<Tout>& MapOverlap<Tout(Tin)>::iterate(unsigned int iterations,
+                                             Out<Matrix<Tout>> output,
+                                             const Matrix<Tin>& in,
+                                             Args&&... args)
+{
+  static_assert(std::is_same<Tin, Tout>::value,
+                "MapOverlap::iterate requires equal input and output types");
+  ASSERT(iterations > 0);
+  ASSERT(in.rowCount() > 0);
+  ASSERT(in.columnCount() > 0);
+
+  // every launch performs up to _time_steps steps, therefore, the halo has to
+  // provide the rows accessed by all of them
+  const unsigned int haloRows = _time_steps * _overlap_range;
+  const unsigned int launches = (iterations + _time_steps - 1) / _time_steps;
+
+  prepareInput(in, haloRows);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutput(output.container(), in);
+
+  // the second buffer used for ping-ponging between the launches; it is only
+  // created if at least two launches are performed
+  Matrix<Tout> temp;
+  if (launches > 1) {
+    prepareOutput(temp, in);
+  }
+
+  const Matrix<Tout>* source = &in;
+  unsigned int remaining = iterations;
+  for (unsigned int i = 0; i < launches; ++i) {
+    // choose the destination so that the last launch writes into output
+    Matrix<Tout>& destination =
+        ((launches - 1 - i) % 2 == 0) ? output.container() : temp;
+
+    auto steps = std::min(remaining, _time_steps);
+    if (_time_steps == 1) {
+      execute(destination, *source, std::forward<Args>(args)...);
+    } else {
+      executeTemporal(destination, *source, steps,
+                      std::forward<Args>(args)...);
+    }
+    remaining -= steps;
+    destination.dataOnDeviceModified();
+
+    if (i + 1 < launches) {
+      // the padding rows of each buffer have to be written once, afterwards
+      // they only change with the NEAREST padding mode
+      exchangeHalo(destination, haloRows,
+                   i < 2 || _padding == detail::Padding::NEAREST);
+    }
+    source = &destination;
+  }
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::setTimeSteps(unsigned int steps)
+{
+  ASSERT(steps > 0);
+  if (steps == _time_steps) return;
+
+  _time_steps = steps;
+  if (_time_steps > 1) {
+    _temporalProgram.reset(
+        new detail::Program(createAndBuildProgram(_time_steps)));
+  } else {
+    _temporalProgram.reset();
+  }
+}
+
+template <typename Tin, typename Tout>
+unsigned int MapOverlap<Tout(Tin)>::timeSteps() const
+{
+  return _time_steps;
+}
+
 template <typename Tin, typename Tout>
 template <typename... Args>
 void MapOverlap<Tout(Tin)>::execute(Matrix<Tout>& output, const Matrix<Tin>& in,
@@ -120,8 +267,14 @@ void MapOverlap<Tout(Tin)>::execute(Matrix<Tout>& output, const Matrix<Tin>& in,
   ASSERT(output.rowCount() == in.rowCount() &&
          output.columnCount() == in.columnCount());
 
+  if (_program == nullptr) {
+    _program.reset(new detail::Program(createAndBuildProgram(1)));
+  }
+
+  cl_uint rowOffset = 0;
+
   for (auto& devicePtr : in.distribution().devices()) {
-    cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_MAPOVERLAP"));
+    cl::Kernel kernel(_program->kernel(*devicePtr, "SCL_MAPOVERLAP"));
 
     cl_uint workgroupSize = static_cast<cl_uint>(
         detail::kernelUtil::determineWorkgroupSizeForKernel(kernel,
@@ -153,6 +306,250 @@ void MapOverlap<Tout(Tin)>::execute(Matrix<Tout>& output, const Matrix<Tin>& in,
                     NULL); // allocate local memory
       kernel.setArg(j++, elements);
       kernel.setArg(j++, static_cast<cl_uint>(output.columnCount()));
+      kernel.setArg(j++, rowOffset);
+      kernel.setArg(j++, static_cast<cl_uint>(in.rowCount()));
+
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, j++,
+                                        std::forward<Args>(args)...);
+
+      // keep buffers and arguments alive / mark them as in use
+      auto keepAlive = detail::kernelUtil::keepAlive(
+          *devicePtr, inputBuffer.clBuffer(), outputBuffer.clBuffer(),
+          std::forward<Args>(args)...);
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter = [=]() { (void)keepAlive; };
+      auto event = devicePtr->enqueue(kernel, cl::NDRange(global[0], global[1]),
+                                      cl::NDRange(local[0], local[1]),
+                                      cl::NullRange, // offset
+                                      invokeAfter);
+    }
+    catch (cl::Error& err)
+    {
+      ABORT_WITH_ERROR(err);
+    }
+
+    rowOffset += elements / static_cast<cl_uint>(in.columnCount());
+  }
+  LOG_INFO("MapOverlap kernel started");
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+void MapOverlap<Tout(Tin)>::execute(Vector<Tout>& output, const Vector<Tin>& in,
+                                    Args&&... args)
+{
+  ASSERT(in.distribution().isValid());
+  ASSERT(output.size() == in.size());
+
+  if (_vectorProgram == nullptr) {
+    _vectorProgram.reset(new detail::Program(createAndBuildVectorProgram()));
+  }
+
+  cl_uint offset = 0;
+
+  for (auto& devicePtr : in.distribution().devices()) {
+    cl::Kernel kernel(
+        _vectorProgram->kernel(*devicePtr, "SCL_MAPOVERLAP_VECTOR"));
+
+    auto& outputBuffer = output.deviceBuffer(*devicePtr);
+    auto& inputBuffer = in.deviceBuffer(*devicePtr);
+
+    cl_uint elements =
+        static_cast<cl_uint>(inputBuffer.size() - 2 * _overlap_range);
+    cl_uint local = static_cast<cl_uint>(
+        std::min(this->workGroupSize(),
+                 detail::kernelUtil::determineWorkgroupSizeForKernel(
+                     kernel, *devicePtr)));
+    cl_uint global = static_cast<cl_uint>(
+        detail::util::ceilToMultipleOf(elements, local));
+
+    LOG_DEBUG_INFO("elements: ", elements, " overlap: ", _overlap_range);
+    LOG_DEBUG_INFO("local: ", local, " global: ", global);
+
+    try
+    {
+      int j = 0;
+      kernel.setArg(j++, inputBuffer.clBuffer());
+      kernel.setArg(j++, outputBuffer.clBuffer());
+      kernel.setArg(j++, (local + 2 * _overlap_range) * sizeof(Tin),
+                    NULL); // allocate local memory
+      kernel.setArg(j++, elements);
+      kernel.setArg(j++, offset);
+      kernel.setArg(j++, static_cast<cl_uint>(in.size()));
+
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, j++,
+                                        std::forward<Args>(args)...);
+
+      // keep buffers and arguments alive / mark them as in use
+      auto keepAlive = detail::kernelUtil::keepAlive(
+          *devicePtr, inputBuffer.clBuffer(), outputBuffer.clBuffer(),
+          std::forward<Args>(args)...);
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter = [=]() { (void)keepAlive; };
+      devicePtr->enqueue(kernel, cl::NDRange(global), cl::NDRange(local),
+                         cl::NullRange, // offset
+                         invokeAfter);
+    }
+    catch (cl::Error& err)
+    {
+      ABORT_WITH_ERROR(err);
+    }
+
+    offset += elements;
+  }
+  LOG_INFO("MapOverlap kernel started");
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+void MapOverlap<Tout(Tin)>::execute(Volume<Tout>& output, const Volume<Tin>& in,
+                                    Args&&... args)
+{
+  ASSERT(in.distribution().isValid());
+  ASSERT(output.size() == in.size());
+
+  if (_volumeProgram == nullptr) {
+    _volumeProgram.reset(new detail::Program(createAndBuildVolumeProgram()));
+  }
+
+  cl_uint sliceOffset = 0;
+
+  for (auto& devicePtr : in.distribution().devices()) {
+    cl::Kernel kernel(
+        _volumeProgram->kernel(*devicePtr, "SCL_MAPOVERLAP_VOLUME"));
+
+    cl_uint workgroupSize = static_cast<cl_uint>(
+        detail::kernelUtil::determineWorkgroupSizeForKernel(kernel,
+                                                            *devicePtr));
+
+    auto& outputBuffer = output.deviceBuffer(*devicePtr);
+    auto& inputBuffer = in.deviceBuffer(*devicePtr);
+
+    auto sliceSize = in.size().sliceSize();
+    cl_uint slices = static_cast<cl_uint>(
+        inputBuffer.size() / sliceSize - 2 * _overlap_range);
+    // a volume with fewer slices than devices leaves some devices empty
+    if (slices == 0) continue;
+
+    // every work-group streams through a block of slices; larger blocks
+    // reduce the number of halo slices loaded redundantly by the
+    // work-groups, smaller ones create more work-groups
+    cl_uint zBlock = std::min(slices, std::max(16u, 8 * _overlap_range));
+
+    cl_uint local[2] = {static_cast<cl_uint>(sqrt(workgroupSize)), local[0]};
+    cl_uint global[3] = {static_cast<cl_uint>(detail::util::ceilToMultipleOf(
+                             in.columnCount(), local[0])),
+                         static_cast<cl_uint>(detail::util::ceilToMultipleOf(
+                             in.rowCount(), local[1])),
+                         (slices + zBlock - 1) / zBlock};
+
+    LOG_DEBUG_INFO("slices: ", slices, " overlap: ", _overlap_range,
+                   " zBlock: ", zBlock);
+    LOG_DEBUG_INFO("local: ", local[0], ",", local[1], " global: ", global[0],
+                   ",", global[1], ",", global[2]);
+
+    // a ring buffer of 2*overlap_range+1 tiles including the halo
+    unsigned int tileSize =
+        (local[0] + 2 * _overlap_range) * (local[1] + 2 * _overlap_range);
+
+    try
+    {
+      int j = 0;
+      kernel.setArg(j++, inputBuffer.clBuffer());
+      kernel.setArg(j++, outputBuffer.clBuffer());
+      kernel.setArg(j++, (2 * _overlap_range + 1) * tileSize * sizeof(Tin),
+                    NULL); // allocate local memory
+      kernel.setArg(j++, slices);
+      kernel.setArg(j++, sliceOffset);
+      kernel.setArg(j++, static_cast<cl_uint>(in.sliceCount()));
+      kernel.setArg(j++, static_cast<cl_uint>(in.rowCount()));
+      kernel.setArg(j++, static_cast<cl_uint>(in.columnCount()));
+      kernel.setArg(j++, zBlock);
+
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, j++,
+                                        std::forward<Args>(args)...);
+
+      // keep buffers and arguments alive / mark them as in use
+      auto keepAlive = detail::kernelUtil::keepAlive(
+          *devicePtr, inputBuffer.clBuffer(), outputBuffer.clBuffer(),
+          std::forward<Args>(args)...);
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter = [=]() { (void)keepAlive; };
+      devicePtr->enqueue(kernel,
+                         cl::NDRange(global[0], global[1], global[2]),
+                         cl::NDRange(local[0], local[1], 1),
+                         cl::NullRange, // offset
+                         invokeAfter);
+    }
+    catch (cl::Error& err)
+    {
+      ABORT_WITH_ERROR(err);
+    }
+
+    sliceOffset += slices;
+  }
+  LOG_INFO("MapOverlap kernel started");
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+void MapOverlap<Tout(Tin)>::executeTemporal(Matrix<Tout>& output,
+                                            const Matrix<Tin>& in,
+                                            unsigned int steps,
+                                            Args&&... args)
+{
+  ASSERT(in.distribution().isValid());
+  ASSERT(output.rowCount() == in.rowCount() &&
+         output.columnCount() == in.columnCount());
+  ASSERT(_temporalProgram != nullptr);
+  ASSERT(steps > 0 && steps <= _time_steps);
+
+  const unsigned int haloRows = _time_steps * _overlap_range;
+  cl_uint rowOffset = 0;
+
+  for (auto& devicePtr : in.distribution().devices()) {
+    cl::Kernel kernel(
+        _temporalProgram->kernel(*devicePtr, "SCL_MAPOVERLAP_TEMPORAL"));
+
+    cl_uint workgroupSize = static_cast<cl_uint>(
+        detail::kernelUtil::determineWorkgroupSizeForKernel(kernel,
+                                                            *devicePtr));
+
+    auto& outputBuffer = output.deviceBuffer(*devicePtr);
+    auto& inputBuffer = in.deviceBuffer(*devicePtr);
+
+    cl_uint elements = static_cast<cl_uint>(
+        inputBuffer.size() - 2 * haloRows * in.columnCount());
+    cl_uint local[2] = {static_cast<cl_uint>(sqrt(workgroupSize)), local[0]};
+    cl_uint global[2] = {static_cast<cl_uint>(detail::util::ceilToMultipleOf(
+                             in.columnCount(), local[0])),
+                         static_cast<cl_uint>(detail::util::ceilToMultipleOf(
+                             elements / in.rowCount(), local[1]))};
+
+    LOG_DEBUG_INFO("elements: ", elements, " overlap: ", _overlap_range,
+                   " steps: ", steps);
+    LOG_DEBUG_INFO("local: ", local[0], ",", local[1], " global: ", global[0],
+                   ",", global[1]);
+
+    // two tiles (current and next step) including the halo of all steps
+    unsigned int tileSize =
+        (local[0] + 2 * haloRows) * (local[1] + 2 * haloRows);
+
+    try
+    {
+      int j = 0;
+      kernel.setArg(j++, inputBuffer.clBuffer());
+      kernel.setArg(j++, outputBuffer.clBuffer());
+      kernel.setArg(j++, 2 * tileSize * sizeof(Tin),
+                    NULL); // allocate local memory
+      kernel.setArg(j++, elements);
+      kernel.setArg(j++, static_cast<cl_uint>(output.columnCount()));
+      kernel.setArg(j++, rowOffset);
+      kernel.setArg(j++, static_cast<cl_uint>(in.rowCount()));
+      kernel.setArg(j++, static_cast<cl_uint>(steps));
 
       detail::kernelUtil::setKernelArgs(kernel, *devicePtr, j++,
                                         std::forward<Args>(args)...);
@@ -173,24 +570,32 @@ void MapOverlap<Tout(Tin)>::execute(Matrix<Tout>& output, const Matrix<Tin>& in,
     {
       ABORT_WITH_ERROR(err);
     }
+
+    rowOffset += elements / static_cast<cl_uint>(in.columnCount());
   }
   LOG_INFO("MapOverlap kernel started");
 }
 
 template <typename Tin, typename Tout>
-detail::Program MapOverlap<Tout(Tin)>::createAndBuildProgram() const
+detail::Program
+    MapOverlap<Tout(Tin)>::createAndBuildProgram(unsigned int timeSteps) const
 {
   ASSERT_MESSAGE(!_userSource.empty(),
                  "Tried to create program with empty user source.");
 
   std::stringstream temp;
 
-  temp << "#define SCL_OVERLAP_RANGE (" << _overlap_range << ")\n"
-       << "#define SCL_TILE_WIDTH (get_local_size(0) + "
-       << "2*" << _overlap_range << ")\n";
-  if (_padding == detail::Padding::NEUTRAL) {
-    temp << "#define NEUTRAL (" << _neutral_element << ")\n";
+  temp << "#define SCL_OVERLAP_RANGE (" << _overlap_range << ")\n";
+  if (timeSteps > 1) {
+    // the tile of the time-skewed kernel includes the halo of all steps
+    temp << "#define SCL_TIME_STEPS (" << timeSteps << ")\n"
+         << "#define SCL_HALO (" << timeSteps * _overlap_range << ")\n"
+         << "#define SCL_TILE_WIDTH (get_local_size(0) + 2*SCL_HALO)\n";
+  } else {
+    temp << "#define SCL_TILE_WIDTH (get_local_size(0) + "
+         << "2*" << _overlap_range << ")\n";
   }
+  temp << detail::paddingDefinitions(_padding, _neutral_element);
 
   // create program
   std::string s(Matrix<Tout>::deviceFunctions());
@@ -226,16 +631,25 @@ SCL_TYPE_1 getData(input_matrix_t matrix, int x, int y)
   // user source
 	s.append(_userSource);
 
-  // allpairs skeleton source
-  s.append(
+  // mapoverlap skeleton source
+  std::string kernelName;
+  if (timeSteps > 1) {
+    kernelName = "SCL_MAPOVERLAP_TEMPORAL";
+    s.append(
+#include "MapOverlapTemporalKernel.cl"
+        );
+  } else {
+    kernelName = "SCL_MAPOVERLAP";
+    s.append(
 #include "MapOverlapKernel.cl"
-      );
+        );
+  }
 
   auto program = detail::Program(s, detail::util::hash("//MapOverlap\n" + s));
 
   // modify program
 	if (!program.loadBinary()) {
-		program.transferParameters(_funcName, 1, "SCL_MAPOVERLAP");
+		program.transferParameters(_funcName, 1, kernelName);
 		program.transferArguments(_funcName, 1, "USR_FUNC");
 
 		program.renameFunction(_funcName, "USR_FUNC");
@@ -248,10 +662,172 @@ SCL_TYPE_1 getData(input_matrix_t matrix, int x, int y)
 }
 
 template <typename Tin, typename Tout>
-void MapOverlap<Tout(Tin)>::prepareInput(const Matrix<Tin>& in)
+void MapOverlap<Tout(Tin)>::prepareInput(const Matrix<Tin>& in,
+                                         unsigned int haloRows)
 {
   // set distribution
   in.setDistribution(detail::OLDistribution<Matrix<Tin>>(
+      haloRows, _padding, _neutral_element));
+
+  // create buffers if required
+  in.createDeviceBuffers();
+
+  // copy data to devices
+  in.startUpload();
+}
+
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::exchangeHalo(const Matrix<Tout>& matrix,
+                                         unsigned int haloRows,
+                                         bool updatePadding) const
+{
+  auto& devices = matrix.distribution().devices();
+  auto haloSize = haloRows * matrix.columnCount();
+  auto last = devices.size() - 1;
+
+  // with the PERIODIC mode the first and the last device are neighbours
+  const bool periodic = (_padding == detail::Padding::PERIODIC);
+  const bool nearest = (updatePadding && _padding == detail::Padding::NEAREST);
+
+  // download the first and last haloRows rows computed by every device,
+  // as far as they are required by a neighbour or for the padding
+  std::vector<std::vector<Tout>> firstRows(devices.size());
+  std::vector<std::vector<Tout>> lastRows(devices.size());
+  std::vector<cl::Event> events;
+
+  for (size_t i = 0; i < devices.size(); ++i) {
+    auto& devicePtr = devices[i];
+    auto& buffer = matrix.deviceBuffer(*devicePtr);
+    ASSERT(buffer.size() >= 3 * haloSize);
+
+    if (i > 0 || periodic || nearest) {
+      firstRows[i].resize(haloSize);
+      events.push_back(devicePtr->enqueueRead(buffer, firstRows[i].begin(),
+                                              haloSize, haloSize));
+    }
+    if (i < last || periodic || nearest) {
+      lastRows[i].resize(haloSize);
+      events.push_back(devicePtr->enqueueRead(buffer, lastRows[i].begin(),
+                                              haloSize,
+                                              buffer.size() - 2 * haloSize));
+    }
+  }
+  for (auto& event : events) {
+    event.wait();
+  }
+  events.clear();
+
+  // create the padding rows on the top of the first and the bottom of the
+  // last device
+  std::vector<Tout> paddingTop;
+  std::vector<Tout> paddingBottom;
+  if (updatePadding) {
+    if (_padding == detail::Padding::NEUTRAL) {
+      paddingTop.resize(haloSize, _neutral_element);
+      paddingBottom.resize(haloSize, _neutral_element);
+    }
+
+    if (_padding == detail::Padding::NEAREST) {
+      auto columnCount = matrix.columnCount();
+      paddingTop.resize(haloSize);
+      paddingBottom.resize(haloSize);
+      for (auto i = 0u; i < haloRows; ++i) {
+        std::copy(firstRows[0].begin(), firstRows[0].begin() + columnCount,
+                  paddingTop.begin() + i * columnCount);
+        std::copy(lastRows[last].end() - columnCount, lastRows[last].end(),
+                  paddingBottom.begin() + i * columnCount);
+      }
+    }
+  }
+
+  // upload the rows into the halo of the neighbouring devices
+  for (size_t i = 0; i < devices.size(); ++i) {
+    auto& devicePtr = devices[i];
+    auto& buffer = matrix.deviceBuffer(*devicePtr);
+
+    if (i > 0) {
+      events.push_back(devicePtr->enqueueWrite(buffer, lastRows[i - 1].begin(),
+                                               haloSize, 0));
+    } else if (periodic) {
+      events.push_back(devicePtr->enqueueWrite(buffer, lastRows[last].begin(),
+                                               haloSize, 0));
+    } else if (!paddingTop.empty()) {
+      events.push_back(devicePtr->enqueueWrite(buffer, paddingTop.begin(),
+                                               haloSize, 0));
+    }
+
+    if (i < last) {
+      events.push_back(devicePtr->enqueueWrite(buffer, firstRows[i + 1].begin(),
+                                               haloSize,
+                                               buffer.size() - haloSize));
+    } else if (periodic) {
+      events.push_back(devicePtr->enqueueWrite(buffer, firstRows[0].begin(),
+                                               haloSize,
+                                               buffer.size() - haloSize));
+    } else if (!paddingBottom.empty()) {
+      events.push_back(devicePtr->enqueueWrite(buffer, paddingBottom.begin(),
+                                               haloSize,
+                                               buffer.size() - haloSize));
+    }
+  }
+
+  // wait for the transfers to finish before releasing the staging memory
+  for (auto& event : events) {
+    event.wait();
+  }
+}
+
+template <typename Tin, typename Tout>
+detail::Program MapOverlap<Tout(Tin)>::createAndBuildVectorProgram() const
+{
+  ASSERT_MESSAGE(!_userSource.empty(),
+                 "Tried to create program with empty user source.");
+
+  std::stringstream temp;
+  temp << "#define SCL_OVERLAP_RANGE (" << _overlap_range << ")\n";
+  temp << detail::paddingDefinitions(_padding, _neutral_element);
+
+  // create program
+  std::string s(Vector<Tout>::deviceFunctions());
+  s.append(temp.str());
+
+  s.append(R"(
+
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+
+)");
+
+  // user source
+  s.append(_userSource);
+
+  // mapoverlap skeleton source
+  s.append(
+#include "MapOverlapVectorKernel.cl"
+      );
+
+  auto program = detail::Program(s,
+                                 detail::util::hash("//MapOverlapVector\n" + s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    program.transferParameters(_funcName, 1, "SCL_MAPOVERLAP_VECTOR");
+    program.transferArguments(_funcName, 1, "USR_FUNC");
+
+    program.renameFunction(_funcName, "USR_FUNC");
+
+    program.adjustTypes<Tin, Tout>();
+  }
+  program.build();
+
+  return program;
+}
+
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::prepareInput(const Vector<Tin>& in)
+{
+  // set distribution
+  in.setDistribution(detail::OverlapDistribution<Vector<Tin>>(
       _overlap_range, _padding, _neutral_element));
 
   // create buffers if required
@@ -261,6 +837,120 @@ void MapOverlap<Tout(Tin)>::prepareInput(const Matrix<Tin>& in)
   in.startUpload();
 }
 
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::prepareOutput(Vector<Tout>& output,
+                                          const Vector<Tin>& in)
+{
+  // set size
+  if (output.size() != in.size()) {
+    output.resize(in.size());
+  }
+
+  // adopt distribution from the input, so that the output has the same halo
+  output.setDistribution(in.distribution());
+
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
+template <typename Tin, typename Tout>
+detail::Program MapOverlap<Tout(Tin)>::createAndBuildVolumeProgram() const
+{
+  ASSERT_MESSAGE(!_userSource.empty(),
+                 "Tried to create program with empty user source.");
+
+  std::stringstream temp;
+  temp << "#define SCL_OVERLAP_RANGE (" << _overlap_range << ")\n"
+       << "#define SCL_TILE_WIDTH (get_local_size(0) + 2*SCL_OVERLAP_RANGE)\n"
+       << "#define SCL_TILE_HEIGHT (get_local_size(1) + 2*SCL_OVERLAP_RANGE)\n"
+       << "#define SCL_TILE_SIZE (SCL_TILE_WIDTH * SCL_TILE_HEIGHT)\n"
+       // slot of slice z in the ring buffer, z >= -SCL_OVERLAP_RANGE
+       << "#define SCL_SLOT(z) "
+       << "(((z) + SCL_OVERLAP_RANGE) % (2*SCL_OVERLAP_RANGE + 1))\n";
+  temp << detail::paddingDefinitions(_padding, _neutral_element);
+
+  // create program
+  std::string s(Volume<Tout>::deviceFunctions());
+  s.append(temp.str());
+
+  // helper structs and functions
+  s.append(R"(
+
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+
+typedef struct {
+    __local SCL_TYPE_0* data;
+    int local_row;
+    int local_column;
+    int slice;
+} input_volume_t;
+
+SCL_TYPE_0 getData(input_volume_t volume, int x, int y, int z)
+{
+  int index = SCL_SLOT(volume.slice + z) * SCL_TILE_SIZE
+            + (volume.local_row + y + SCL_OVERLAP_RANGE) * SCL_TILE_WIDTH
+            + (volume.local_column + x + SCL_OVERLAP_RANGE);
+  return volume.data[index];
+}
+
+)");
+
+  // user source
+  s.append(_userSource);
+
+  // mapoverlap skeleton source
+  s.append(
+#include "MapOverlapVolumeKernel.cl"
+      );
+
+  auto program = detail::Program(s,
+                                 detail::util::hash("//MapOverlapVolume\n" + s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    program.transferParameters(_funcName, 1, "SCL_MAPOVERLAP_VOLUME");
+    program.transferArguments(_funcName, 1, "USR_FUNC");
+
+    program.renameFunction(_funcName, "USR_FUNC");
+
+    program.adjustTypes<Tin, Tout>();
+  }
+  program.build();
+
+  return program;
+}
+
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::prepareInput(const Volume<Tin>& in)
+{
+  // set distribution, the volume is split along the slices
+  in.setDistribution(detail::OLDistribution<Volume<Tin>>(
+      _overlap_range, _padding, _neutral_element));
+
+  // create buffers if required
+  in.createDeviceBuffers();
+
+  // copy data to devices
+  in.startUpload();
+}
+
+template <typename Tin, typename Tout>
+void MapOverlap<Tout(Tin)>::prepareOutput(Volume<Tout>& output,
+                                          const Volume<Tin>& in)
+{
+  // set size
+  if (output.size() != in.size()) {
+    output.resize(in.size());
+  }
+
+  // adopt distribution from the input, so that the output has the same halo
+  output.setDistribution(in.distribution());
+
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
 // Ausgabe vorbereiten
 template <typename Tin, typename Tout>
 void MapOverlap<Tout(Tin)>::prepareOutput(Matrix<Tout>& output,
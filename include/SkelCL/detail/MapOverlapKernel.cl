@@ -39,112 +39,65 @@
 ///
 
 R"(
-#pragma OPENCL EXTENSION cl_amd_printf:enable
-int localIndex(int rowOffset, int colOffset)
+// Returns the element in the given row, relative to the first row computed by
+// the device, and column. Accesses outside of the matrix are handled
+// according to the padding mode.
+SCL_TYPE_0 SCL_LOAD(const __global SCL_TYPE_0* SCL_IN, int row, int col,
+                    const int SCL_ROW_OFFSET, const int SCL_ROWS,
+                    const int SCL_COLS)
 {
-  const unsigned int l_col = get_local_id(0);
-  const unsigned int l_row = get_local_id(1);
-  return ((rowOffset + l_row) + SCL_OVERLAP_RANGE)
-       * SCL_TILE_WIDTH + SCL_OVERLAP_RANGE + (l_col + colOffset);
-}
-
-int globalIndex(int rowOffset, int colOffset, int SCL_COLS)
-{
-  const unsigned int col = get_global_id(0);
-  const unsigned int row = get_global_id(1);
-  return (rowOffset + row)
-       * SCL_COLS + (colOffset + col + (SCL_OVERLAP_RANGE * SCL_COLS));
+#ifdef SCL_NO_PADDING
+  // no padding rows are stored on the first and last device, rows outside of
+  // the matrix are remapped to rows stored by the device instead
+  const int matrixRow = SCL_ROW_OFFSET + row;
+  if (matrixRow < 0 || matrixRow >= SCL_ROWS) {
+    row = SCL_REMAP(matrixRow, SCL_ROWS) - SCL_ROW_OFFSET;
+  }
+#endif
+#ifdef NEUTRAL
+  if (col < 0 || col >= SCL_COLS) return NEUTRAL;
+#else
+  col = SCL_REMAP(col, SCL_COLS);
+#endif
+  return SCL_IN[(row + SCL_OVERLAP_RANGE) * SCL_COLS + col];
 }
 
 __kernel void SCL_MAPOVERLAP(__global SCL_TYPE_0* SCL_IN,
                              __global SCL_TYPE_1* SCL_OUT,
                              __local SCL_TYPE_1* SCL_SHARED,
                              const unsigned int SCL_ELEMENTS,
-                             const unsigned int SCL_COLS)
+                             const unsigned int SCL_COLS,
+                             const unsigned int SCL_ROW_OFFSET,
+                             const unsigned int SCL_ROWS)
 {
   const unsigned int col = get_global_id(0);
-  const unsigned int l_col = get_local_id(0);
   const unsigned int row = get_global_id(1);
-  const unsigned int l_row = get_local_id(1);
+  const int deviceRows = SCL_ELEMENTS / SCL_COLS;
+  const int tileSize = SCL_TILE_WIDTH * SCL_TILE_WIDTH;
+  const int localSize = get_local_size(0) * get_local_size(1);
+  const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+
+  // the upper left element of the tile including the halo
+  const int firstCol = get_group_id(0) * get_local_size(0) - SCL_OVERLAP_RANGE;
+  const int firstRow = get_group_id(1) * get_local_size(1) - SCL_OVERLAP_RANGE;
 
   input_matrix_t Mm;
   Mm.data = SCL_SHARED;
-  Mm.local_row = l_row;
-  Mm.local_column = l_col;
-
-  int i, m;
-
-  // everybody copies one item
-  SCL_SHARED[localIndex(0, 0)] = SCL_IN[globalIndex(0, 0, SCL_COLS)];
+  Mm.local_row = get_local_id(1);
+  Mm.local_column = get_local_id(0);
 
-  barrier(CLK_LOCAL_MEM_FENCE);
-
-  // the first row copies the north region
-  if (l_row == 0) {
-    for (m = 1; m <= SCL_OVERLAP_RANGE; m++) {
-      SCL_SHARED[localIndex(-m, 0)] = SCL_IN[globalIndex(-m, 0, SCL_COLS)];
-    }
-  }
-
-  // the last row copies the south region
-  if (l_row == get_local_size(1) - 1) {
-    for (m = 1; m <= SCL_OVERLAP_RANGE; m++) {
-      SCL_SHARED[localIndex(m, 0)] = SCL_IN[globalIndex(m, 0, SCL_COLS)];
-    }
-  }
-
-  // the second row copies the west and east regions
-  if (l_row == 1 && col < SCL_COLS) {
-    // Fill columns of local memory left of the mapped elements when padding
-    // elements to the left are needed
-    if (col < SCL_OVERLAP_RANGE) {
-      for (i = -SCL_OVERLAP_RANGE;
-           i < (int)get_local_size(1) + SCL_OVERLAP_RANGE; i++) {
-#ifdef NEUTRAL
-        SCL_SHARED[localIndex(i - 1, -SCL_OVERLAP_RANGE)] = NEUTRAL;
-#else // NEAREST
-        SCL_SHARED[localIndex(i - 1, -SCL_OVERLAP_RANGE)] =
-            SCL_IN[globalIndex(i - 1, -col, SCL_COLS)];
-#endif
-      }
-    }
-    // Fill columns of local memory left of the mapped elements
-    else if (l_col < SCL_OVERLAP_RANGE) {
-      for (i = -SCL_OVERLAP_RANGE;
-           i < (int)get_local_size(1) + SCL_OVERLAP_RANGE; i++) {
-        SCL_SHARED[localIndex(i - 1, -SCL_OVERLAP_RANGE)] =
-            SCL_IN[globalIndex(i - 1, -SCL_OVERLAP_RANGE, SCL_COLS)];
-      }
-    }
-
-    // Fill columns of local memory right of the mapped elements when padding
-    // elements to the right are needed
-    if (col >= (SCL_COLS - SCL_OVERLAP_RANGE)) {
-      for (i = -SCL_OVERLAP_RANGE;
-           i < (int)get_local_size(1) + SCL_OVERLAP_RANGE; i++) {
-#ifdef NEUTRAL
-        SCL_SHARED[localIndex(i - 1, +SCL_OVERLAP_RANGE)] = NEUTRAL;
-#else // NEAREST
-        SCL_SHARED[localIndex(i - 1, +SCL_OVERLAP_RANGE)] =
-            SCL_IN[globalIndex(i - 1, +(SCL_COLS - col - 1), SCL_COLS)];
-#endif
-      }
-    }
-    // Fill columns of local memory right of the mapped elements
-    else if (l_col >= (int)(get_local_size(0) - SCL_OVERLAP_RANGE)) {
-      for (i = -SCL_OVERLAP_RANGE;
-           i < (int)get_local_size(1) + SCL_OVERLAP_RANGE; i++) {
-        SCL_SHARED[localIndex(i - 1, +SCL_OVERLAP_RANGE)] =
-            SCL_IN[globalIndex(i - 1, +SCL_OVERLAP_RANGE, SCL_COLS)];
-      }
-    }
+  int i;
+  for (i = lid; i < tileSize; i += localSize) {
+    const int r = firstRow + i / SCL_TILE_WIDTH;
+    if (r >= deviceRows + SCL_OVERLAP_RANGE) continue; // never accessed
+    SCL_SHARED[i] = SCL_LOAD(SCL_IN, r, firstCol + i % SCL_TILE_WIDTH,
+                             SCL_ROW_OFFSET, SCL_ROWS, SCL_COLS);
   }
 
   barrier(CLK_LOCAL_MEM_FENCE);
 
-  if (row < SCL_ELEMENTS / SCL_COLS && col < SCL_COLS) {
-    SCL_OUT[globalIndex(0, 0, SCL_COLS)] = USR_FUNC(Mm);
+  if (row < deviceRows && col < SCL_COLS) {
+    SCL_OUT[(row + SCL_OVERLAP_RANGE) * SCL_COLS + col] = USR_FUNC(Mm);
   }
 }
 )"
-
@@ -0,0 +1,170 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapOverlapTemporalKernel.cl
+///
+/// Time-skewed MapOverlap kernel performing up to SCL_TIME_STEPS steps per
+/// launch. Each work-group loads a tile with a halo of SCL_HALO rows and
+/// columns into local memory. Every step shrinks the valid part of the tile by
+/// SCL_OVERLAP_RANGE elements on each side, so that after all steps the inner
+/// part covered by the work-group is still valid.
+///
+
+R"(
+int isInsideMatrix(int row, int col, int SCL_COLS, int SCL_ROWS)
+{
+  return row >= 0 && row < SCL_ROWS && col >= 0 && col < SCL_COLS;
+}
+
+__kernel void SCL_MAPOVERLAP_TEMPORAL(__global SCL_TYPE_0* SCL_IN,
+                                      __global SCL_TYPE_1* SCL_OUT,
+                                      __local SCL_TYPE_1* SCL_SHARED,
+                                      const unsigned int SCL_ELEMENTS,
+                                      const unsigned int SCL_COLS,
+                                      const unsigned int SCL_ROW_OFFSET,
+                                      const unsigned int SCL_ROWS,
+                                      const unsigned int SCL_STEPS)
+{
+  const int tileCols = get_local_size(0) + 2 * SCL_HALO;
+  const int tileRows = get_local_size(1) + 2 * SCL_HALO;
+  const int tileSize = tileCols * tileRows;
+  const int localSize = get_local_size(0) * get_local_size(1);
+  const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+
+  // the upper left element of the tile: the column in the matrix and the row
+  // in the device buffer (which starts with SCL_HALO halo rows)
+  const int firstCol = get_group_id(0) * get_local_size(0) - SCL_HALO;
+  const int firstRow = get_group_id(1) * get_local_size(1);
+  const int bufferRows = SCL_ELEMENTS / SCL_COLS + 2 * SCL_HALO;
+  // the row in the whole matrix corresponding to the first tile row
+  const int matrixRow = SCL_ROW_OFFSET + firstRow - SCL_HALO;
+
+  __local SCL_TYPE_1* current = SCL_SHARED;
+  __local SCL_TYPE_1* next = SCL_SHARED + tileSize;
+
+  int i;
+  unsigned int s;
+
+  // load the tile including the halo
+  for (i = lid; i < tileSize; i += localSize) {
+    const int row = firstRow + i / tileCols;
+    const int col = firstCol + i % tileCols;
+    if (row >= bufferRows) continue; // never used for a valid result
+#ifdef NEUTRAL
+    current[i] = (col < 0 || col >= (int)SCL_COLS)
+               ? NEUTRAL : SCL_IN[row * SCL_COLS + col];
+#else
+    int bufferRow = row;
+#ifdef SCL_NO_PADDING
+    // no padding rows are stored on the first and last device, rows outside
+    // of the matrix are remapped to rows stored by the device instead
+    const int mRow = (int)SCL_ROW_OFFSET + row - SCL_HALO;
+    if (mRow < 0 || mRow >= (int)SCL_ROWS) {
+      bufferRow = SCL_REMAP(mRow, SCL_ROWS) - (int)SCL_ROW_OFFSET + SCL_HALO;
+    }
+#endif
+    current[i] = SCL_IN[bufferRow * SCL_COLS + SCL_REMAP(col, SCL_COLS)];
+#endif
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  input_matrix_t Mm;
+
+  for (s = 1; s <= SCL_STEPS; ++s) {
+    const int border = s * SCL_OVERLAP_RANGE;
+
+    Mm.data = current;
+    for (i = lid; i < tileSize; i += localSize) {
+      const int r = i / tileCols;
+      const int c = i % tileCols;
+      if (   r < border || r >= tileRows - border
+          || c < border || c >= tileCols - border) continue;
+
+#ifdef SCL_PERIODIC
+      // the halo and the remapped columns hold the elements on the other
+      // side of the matrix, which are computed like all other elements
+      const int inside = 1;
+#else
+      const int inside =
+          isInsideMatrix(matrixRow + r, firstCol + c, SCL_COLS, SCL_ROWS);
+#endif
+      if (inside) {
+        Mm.local_row = r - SCL_OVERLAP_RANGE;
+        Mm.local_column = c - SCL_OVERLAP_RANGE;
+        next[i] = USR_FUNC(Mm);
+      } else {
+#ifdef NEUTRAL
+        next[i] = NEUTRAL;
+#endif
+      }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+#if !defined(NEUTRAL) && !defined(SCL_PERIODIC)
+    // elements outside of the matrix take the value of the element they are
+    // remapped to (e.g. the nearest one), which has been computed in this step
+    for (i = lid; i < tileSize; i += localSize) {
+      const int r = i / tileCols;
+      const int c = i % tileCols;
+      if (   r < border || r >= tileRows - border
+          || c < border || c >= tileCols - border) continue;
+
+      if (!isInsideMatrix(matrixRow + r, firstCol + c, SCL_COLS, SCL_ROWS)) {
+        const int nearestRow = SCL_REMAP(matrixRow + r, SCL_ROWS)
+                             - matrixRow;
+        const int nearestCol = SCL_REMAP(firstCol + c, SCL_COLS)
+                             - firstCol;
+        next[i] = next[nearestRow * tileCols + nearestCol];
+      }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+#endif
+
+    __local SCL_TYPE_1* tmp = current;
+    current = next;
+    next = tmp;
+  }
+
+  const unsigned int col = get_global_id(0);
+  const unsigned int row = get_global_id(1);
+  if (row < SCL_ELEMENTS / SCL_COLS && col < SCL_COLS) {
+    SCL_OUT[(row + SCL_HALO) * SCL_COLS + col] =
+      current[(get_local_id(1) + SCL_HALO) * tileCols
+              + get_local_id(0) + SCL_HALO];
+  }
+}
+)"
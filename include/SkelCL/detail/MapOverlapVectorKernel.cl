@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapOverlapVectorKernel.cl
+///
+/// One-dimensional MapOverlap kernel. Every work-group loads its part of the
+/// vector together with SCL_OVERLAP_RANGE elements on each side into local
+/// memory. The halo and padding elements are stored in the device buffer by
+/// the OverlapDistribution, with the CLAMP and MIRROR padding modes elements
+/// outside of the vector are remapped instead.
+///
+
+R"(
+__kernel void SCL_MAPOVERLAP_VECTOR(__global SCL_TYPE_0* SCL_IN,
+                                    __global SCL_TYPE_1* SCL_OUT,
+                                    __local SCL_TYPE_0* SCL_SHARED,
+                                    const unsigned int SCL_ELEMENTS,
+                                    const unsigned int SCL_OFFSET,
+                                    const unsigned int SCL_SIZE)
+{
+  const unsigned int gid = get_global_id(0);
+  const unsigned int lid = get_local_id(0);
+  const unsigned int localSize = get_local_size(0);
+  // first element of the tile in the device buffer, which starts with
+  // SCL_OVERLAP_RANGE halo elements
+  const unsigned int first = get_group_id(0) * localSize;
+  const unsigned int bufferSize = SCL_ELEMENTS + 2 * SCL_OVERLAP_RANGE;
+
+  unsigned int i;
+  for (i = lid; i < localSize + 2 * SCL_OVERLAP_RANGE; i += localSize) {
+    if (first + i < bufferSize) {
+#ifdef SCL_NO_PADDING
+      // no padding elements are stored on the first and last device, elements
+      // outside of the vector are remapped to elements stored by the device
+      const int index = (int)(SCL_OFFSET + first + i) - SCL_OVERLAP_RANGE;
+      if (index < 0 || index >= (int)SCL_SIZE) {
+        SCL_SHARED[i] = SCL_IN[SCL_REMAP(index, SCL_SIZE) - (int)SCL_OFFSET
+                               + SCL_OVERLAP_RANGE];
+        continue;
+      }
+#endif
+      SCL_SHARED[i] = SCL_IN[first + i];
+    }
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (gid < SCL_ELEMENTS) {
+    SCL_OUT[gid + SCL_OVERLAP_RANGE] =
+      USR_FUNC(SCL_SHARED + lid + SCL_OVERLAP_RANGE);
+  }
+}
+)"
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapOverlapVolumeKernel.cl
+///
+/// Three-dimensional MapOverlap kernel (2.5D blocking). Every work-group
+/// covers a two dimensional tile of the slices and streams along a block of
+/// slices, keeping the 2*SCL_OVERLAP_RANGE+1 slices accessed by the
+/// user-defined function as a ring buffer of tiles in local memory. The halo
+/// and padding slices are stored in the device buffer by the OLDistribution,
+/// the borders of the slices are handled while loading the tiles. With the
+/// CLAMP and MIRROR padding modes slices outside of the volume are remapped.
+///
+
+R"(
+// Loads the tile of slice z required by the work-group into the given slot of
+// the ring buffer in local memory. The slice index is relative to the first
+// slice of the device, i.e. z = -SCL_OVERLAP_RANGE denotes the first halo
+// slice stored in front of the slices of the device.
+void SCL_LOAD_SLICE(const __global SCL_TYPE_0* SCL_IN,
+                    __local SCL_TYPE_0* SCL_SHARED,
+                    const int slot, int z,
+                    const int SCL_SLICE_OFFSET, const int SCL_TOTAL_SLICES,
+                    const int SCL_ROWS, const int SCL_COLS)
+{
+#ifdef SCL_NO_PADDING
+  // no padding slices are stored on the first and last device, slices outside
+  // of the volume are remapped to slices stored by the device instead
+  const int volumeSlice = SCL_SLICE_OFFSET + z;
+  if (volumeSlice < 0 || volumeSlice >= SCL_TOTAL_SLICES) {
+    z = SCL_REMAP(volumeSlice, SCL_TOTAL_SLICES) - SCL_SLICE_OFFSET;
+  }
+#endif
+
+  const int x0 = get_group_id(0) * get_local_size(0) - SCL_OVERLAP_RANGE;
+  const int y0 = get_group_id(1) * get_local_size(1) - SCL_OVERLAP_RANGE;
+  const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+  const int lsize = get_local_size(0) * get_local_size(1);
+
+  const __global SCL_TYPE_0* slice =
+      SCL_IN + (z + SCL_OVERLAP_RANGE) * SCL_ROWS * SCL_COLS;
+  __local SCL_TYPE_0* tile = SCL_SHARED + slot * SCL_TILE_SIZE;
+
+  for (int i = lid; i < SCL_TILE_SIZE; i += lsize) {
+    const int x = x0 + i % SCL_TILE_WIDTH;
+    const int y = y0 + i / SCL_TILE_WIDTH;
+    if (x >= 0 && x < SCL_COLS && y >= 0 && y < SCL_ROWS) {
+      tile[i] = slice[y * SCL_COLS + x];
+    } else {
+#ifdef NEUTRAL
+      tile[i] = NEUTRAL;
+#else
+      tile[i] = slice[SCL_REMAP(y, SCL_ROWS) * SCL_COLS
+                      + SCL_REMAP(x, SCL_COLS)];
+#endif
+    }
+  }
+}
+
+__kernel void SCL_MAPOVERLAP_VOLUME(__global SCL_TYPE_0* SCL_IN,
+                                    __global SCL_TYPE_1* SCL_OUT,
+                                    __local SCL_TYPE_0* SCL_SHARED,
+                                    const unsigned int SCL_SLICES,
+                                    const unsigned int SCL_SLICE_OFFSET,
+                                    const unsigned int SCL_TOTAL_SLICES,
+                                    const unsigned int SCL_ROWS,
+                                    const unsigned int SCL_COLS,
+                                    const unsigned int SCL_Z_BLOCK)
+{
+  const unsigned int col = get_global_id(0);
+  const unsigned int row = get_global_id(1);
+
+  // every work-group streams through a block of SCL_Z_BLOCK slices
+  const int zBegin = get_group_id(2) * SCL_Z_BLOCK;
+  const int zEnd = min(zBegin + (int)SCL_Z_BLOCK, (int)SCL_SLICES);
+
+  input_volume_t Mm;
+  Mm.data = SCL_SHARED;
+  Mm.local_row = get_local_id(1);
+  Mm.local_column = get_local_id(0);
+
+  // load the slices in front of the first computed slice and all but the last
+  // slice behind it
+  for (int z = zBegin - SCL_OVERLAP_RANGE; z < zBegin + SCL_OVERLAP_RANGE;
+       ++z) {
+    SCL_LOAD_SLICE(SCL_IN, SCL_SHARED, SCL_SLOT(z), z, SCL_SLICE_OFFSET,
+                   SCL_TOTAL_SLICES, SCL_ROWS, SCL_COLS);
+  }
+
+  for (int z = zBegin; z < zEnd; ++z) {
+    // the slice entering the window replaces the one which left it in the
+    // previous iteration
+    SCL_LOAD_SLICE(SCL_IN, SCL_SHARED, SCL_SLOT(z + SCL_OVERLAP_RANGE),
+                   z + SCL_OVERLAP_RANGE, SCL_SLICE_OFFSET, SCL_TOTAL_SLICES,
+                   SCL_ROWS, SCL_COLS);
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (row < SCL_ROWS && col < SCL_COLS) {
+      Mm.slice = z;
+      SCL_OUT[((z + SCL_OVERLAP_RANGE) * SCL_ROWS + row) * SCL_COLS + col] =
+          USR_FUNC(Mm);
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+)"
@@ -0,0 +1,308 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapReduceDef.h
+///
+
+#ifndef MAP_REDUCE_DEF_H_
+#define MAP_REDUCE_DEF_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include <stooling/SourceCode.h>
+
+#include "../Distributions.h"
+#include "../Out.h"
+#include "../Vector.h"
+
+#include "Device.h"
+#include "DeviceBuffer.h"
+#include "DeviceList.h"
+#include "KernelUtil.h"
+#include "Program.h"
+#include "ReduceHelper.h"
+#include "Skeleton.h"
+#include "Util.h"
+
+namespace skelcl {
+
+template <typename Tin, typename Tout>
+MapReduce<Tout(Tin)>::MapReduce(const Source& mapSource,
+                                const Source& reduceSource,
+                                const std::string& id,
+                                const std::string& mapFunc,
+                                const std::string& reduceFunc)
+  : detail::Skeleton(),
+    _srcMap(mapSource),
+    _srcReduce(reduceSource),
+    _funcMap(mapFunc),
+    _funcReduce(reduceFunc),
+    _idReduce(id),
+    _program(createAndBuildProgram())
+{
+  LOG_DEBUG_INFO("Create new MapReduce object (", this, ")");
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Vector<Tout> MapReduce<Tout(Tin)>::operator()(const Vector<Tin>& input,
+                                              Args&&... args)
+{
+  Vector<Tout> output;
+  this->operator()(out(output), input, std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+Vector<Tout>& MapReduce<Tout(Tin)>::operator()(Out<Vector<Tout>> output,
+                                               const Vector<Tin>& input,
+                                               Args&&... args)
+{
+  if (input.size() == 0) {
+    // the result for an empty input is the identity
+    auto& devicePtr = detail::globalDeviceList.front();
+    prepareOutput(output.container(), devicePtr);
+
+    auto& outputBuffer = output.container().deviceBuffer(*devicePtr);
+    detail::reduceHelper::reducePartials(_program, *devicePtr, outputBuffer,
+                                         outputBuffer, 0,
+                                         this->workGroupSize());
+
+    updateModifiedStatus(output, std::forward<Args>(args)...);
+    return output.container();
+  }
+
+  prepareInput(input);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  auto& devices = input.distribution().devices();
+  bool isCopy = (dynamic_cast<detail::CopyDistribution<Vector<Tin>>*>(
+                   &input.distribution()) != nullptr);
+
+  if (devices.size() == 1 || isCopy) {
+    auto& devicePtr = devices.front();
+    prepareOutput(output.container(), devicePtr);
+
+    size_t groups = numberOfGroups(*devicePtr, input.size());
+    detail::DeviceBuffer tmpBuffer(devicePtr, groups, sizeof(Tout));
+
+    executeMapReduce(*devicePtr, input.deviceBuffer(*devicePtr), tmpBuffer,
+                     input.size(), groups, std::forward<Args>(args)...);
+    detail::reduceHelper::reducePartials(
+        _program, *devicePtr, tmpBuffer,
+        output.container().deviceBuffer(*devicePtr), groups,
+        this->workGroupSize());
+  } else {
+    // 1. every device reduces its block to a single value
+    std::vector<detail::DeviceBuffer> partials;
+    for (auto& devicePtr : devices) {
+      auto& inputBuffer = input.deviceBuffer(*devicePtr);
+      if (inputBuffer.size() == 0) continue;
+
+      size_t groups = numberOfGroups(*devicePtr, inputBuffer.size());
+      detail::DeviceBuffer tmpBuffer(devicePtr, groups, sizeof(Tout));
+      partials.emplace_back(devicePtr, 1, sizeof(Tout));
+
+      executeMapReduce(*devicePtr, inputBuffer, tmpBuffer, inputBuffer.size(),
+                       groups, std::forward<Args>(args)...);
+      detail::reduceHelper::reducePartials(_program, *devicePtr, tmpBuffer,
+                                           partials.back(), groups,
+                                           this->workGroupSize());
+    }
+
+    // 2. combine the partial results on the first device
+    auto& devicePtr = devices.front();
+    prepareOutput(output.container(), devicePtr);
+
+    detail::reduceHelper::combineDevicePartials(
+        _program, partials, output.container().deviceBuffer(*devicePtr),
+        this->workGroupSize());
+  }
+
+  LOG_DEBUG_INFO("MapReduce kernels started");
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename Tin, typename Tout>
+void MapReduce<Tout(Tin)>::prepareInput(const Vector<Tin>& input)
+{
+  // set default distribution if required
+  if (!input.distribution().isValid()) {
+    input.setDistribution(detail::BlockDistribution<Vector<Tin>>());
+  }
+  // create buffers if required
+  input.createDeviceBuffers();
+  // copy data to devices
+  input.startUpload();
+}
+
+template <typename Tin, typename Tout>
+void MapReduce<Tout(Tin)>::prepareOutput(Vector<Tout>& output,
+                                         const detail::Device::ptr_type&
+                                           devicePtr)
+{
+  // resize container if required
+  if (output.size() < 1) {
+    output.resize(1);
+  }
+  // the result is computed on a single device
+  output.setDistribution(detail::SingleDistribution<Vector<Tout>>(devicePtr));
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
+template <typename Tin, typename Tout>
+size_t MapReduce<Tout(Tin)>::numberOfGroups(const detail::Device& device,
+                                            size_t data_size) const
+{
+  return detail::reduceHelper::numberOfGroups(
+           device,
+           detail::reduceHelper::localSize(_program, device, "SCL_MAP_REDUCE",
+                                           this->workGroupSize()),
+           data_size);
+}
+
+template <typename Tin, typename Tout>
+template <typename... Args>
+void MapReduce<Tout(Tin)>::executeMapReduce(const detail::Device& device,
+                                            const detail::DeviceBuffer& input,
+                                            const detail::DeviceBuffer& output,
+                                            size_t data_size, size_t groups,
+                                            Args&&... args)
+{
+  ASSERT(output.size() >= groups);
+  try {
+    const size_t local_size = detail::reduceHelper::localSize(
+                                _program, device, "SCL_MAP_REDUCE",
+                                this->workGroupSize());
+
+    cl::Kernel kernel = _program.kernel(device, "SCL_MAP_REDUCE");
+    kernel.setArg(0, input.clBuffer());
+    kernel.setArg(1, output.clBuffer());
+    kernel.setArg(2, cl::__local(local_size * sizeof(Tout)));
+    kernel.setArg(3, static_cast<cl_uint>(data_size));
+
+    detail::kernelUtil::setKernelArgs(kernel, device, 4,
+                                      std::forward<Args>(args)...);
+
+    auto keepAlive = detail::kernelUtil::keepAlive(device, input.clBuffer(),
+                                                   output.clBuffer(),
+                                                   std::forward<Args>(args)...);
+
+    // after finishing the kernel invoke this function ...
+    auto invokeAfter = [keepAlive]() {};
+
+    device.enqueue(kernel, cl::NDRange(groups * local_size),
+                   cl::NDRange(local_size),
+                   cl::NullRange, // offset
+                   invokeAfter);
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+}
+
+template <typename Tin, typename Tout>
+detail::Program MapReduce<Tout(Tin)>::createAndBuildProgram() const
+{
+  ASSERT_MESSAGE( !_srcMap.empty(),
+                  "Tried to create program with empty user map source." );
+  ASSERT_MESSAGE( !_srcReduce.empty(),
+                  "Tried to create program with empty user reduce source." );
+
+  // _srcMap: replace func by TMP_MAP
+  stooling::SourceCode mSource(_srcMap);
+  mSource.renameFunction(_funcMap, "TMP_MAP");
+
+  // _srcReduce: replace func by TMP_REDUCE
+  stooling::SourceCode rSource(_srcReduce);
+  rSource.renameFunction(_funcReduce, "TMP_REDUCE");
+
+  // create program
+  // first: device specific functions
+  std::string s(detail::CommonDefinitions::getSource());
+  // second: identity
+  s.append("#define SCL_IDENTITY (" + _idReduce + ")\n");
+  // next: user defined sources
+  s.append(mSource.code());
+  s.append("\n");
+  s.append(rSource.code());
+  s.append("\n");
+  // last: append skeleton implementation source
+  s.append(R"(
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+#define SCL_REDUCE_TYPE SCL_TYPE_1
+)");
+  s.append(
+    #include "ReducePartialsKernel.cl"
+  );
+  s.append(
+    #include "MapReduceKernel.cl"
+  );
+
+  auto program = detail::Program(s, detail::util::hash("//MapReduce\n" + s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    // additional arguments are passed to the map function only
+    program.transferParameters("TMP_MAP", 1, "SCL_MAP_REDUCE");
+    program.transferArguments("TMP_MAP", 1, "USR_MAP");
+
+    program.renameFunction("TMP_MAP", "USR_MAP");
+    program.renameFunction("TMP_REDUCE", "USR_REDUCE");
+
+    program.adjustTypes<Tin, Tout>();
+  }
+  program.build();
+
+  return program;
+}
+
+} // namespace skelcl
+
+#endif // MAP_REDUCE_DEF_H_
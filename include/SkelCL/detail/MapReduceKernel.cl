@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MapReduceKernel.cl
+///
+
+R"(
+
+// Every work-item applies USR_MAP to the elements at its global id plus
+// multiples of the global size and accumulates the results with USR_REDUCE.
+// Each work-group writes one partial result (see ReducePartialsKernel.cl).
+__kernel void SCL_MAP_REDUCE (
+    const __global SCL_TYPE_0* SCL_IN,
+          __global SCL_TYPE_1* SCL_OUT,
+          __local  SCL_TYPE_1* SCL_LOCAL, // has size of the work-group
+    const unsigned int         DATA_SIZE)
+{
+    const unsigned int gid   = get_global_id(0);
+    const unsigned int gsize = get_global_size(0);
+
+    // work-items without an element hold the identity
+    SCL_TYPE_1 res = SCL_IDENTITY;
+    for (unsigned int i = gid; i < DATA_SIZE; i += gsize) {
+      res = USR_REDUCE( res, USR_MAP( SCL_IN[i] ) );
+    }
+
+    SCL_WORK_GROUP_REDUCE(SCL_LOCAL, SCL_OUT, res);
+}
+
+)"
@@ -0,0 +1,101 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file MappedFile.h
+///
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <string>
+
+#include "skelclDll.h"
+
+namespace skelcl {
+
+namespace detail {
+
+///
+/// \brief Describes how a file is mapped into memory.
+///
+enum class MapMode {
+  READ,       ///< Map an existing file. Modifications are not written back.
+  READ_WRITE, ///< Map an existing file. Modifications are written back.
+  CREATE      ///< Create (or truncate) the file. Modifications are written
+              ///  back.
+};
+
+///
+/// \brief A file mapped into the address space of the host.
+///
+/// The mapping is established in the constructor and removed in the
+/// destructor. Containers use the mapped memory as host storage, so that
+/// uploads read from and downloads write to the file (or the page cache)
+/// without an intermediate copy.
+///
+class SKELCL_DLL MappedFile {
+public:
+  ///
+  /// \brief Maps the file at path into memory.
+  ///
+  /// \param path        The path of the file to be mapped
+  /// \param mode        How the file is opened and mapped
+  /// \param sizeInBytes The number of bytes to map. If 0 the whole file is
+  ///                    mapped. For MapMode::CREATE the file is resized to
+  ///                    this size.
+  ///
+  MappedFile(const std::string& path, MapMode mode, size_t sizeInBytes = 0);
+
+  ~MappedFile();
+
+  void* data() const;
+
+  size_t sizeInBytes() const;
+
+  const std::string& path() const;
+
+private:
+  MappedFile(const MappedFile&);// = delete;
+  MappedFile& operator=(const MappedFile&);// = delete;
+
+  std::string _path;
+  size_t      _sizeInBytes;
+  void*       _data;
+};
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // MAPPED_FILE_H_
@@ -62,6 +62,8 @@
 #include "DeviceBuffer.h"
 #include "DeviceList.h"
 #include "Event.h"
+#include "MappedFile.h"
+#include "MemoryManager.h"
 #include "Util.h"
 
 namespace skelcl {
@@ -81,6 +83,8 @@ Matrix<T>::Matrix()
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -97,6 +101,8 @@ Matrix<T>::Matrix(const size_type size,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer( _size.elemCount(), value ),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -113,6 +119,8 @@ Matrix<T>::Matrix(const std::vector<T>& vector,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(vector),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -136,6 +144,27 @@ Matrix<T>::Matrix(const std::vector<T>& vector,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(vector),
+    _hostPointer(nullptr),
+    _mappedFile(),
+    _deviceBuffers()
+{
+  (void)registerMatrixDeviceFunctions;
+  _hostBuffer.resize(size.elemCount());
+  LOG_DEBUG_INFO("Created new Matrix object (", this, ") with ",
+      getDebugInfo());
+}
+
+template <typename T>
+Matrix<T>::Matrix(std::vector<T>&& vector,
+                  const size_type size,
+                  const detail::Distribution<Matrix<T>>& distribution)
+  : _size(size),
+    _distribution(detail::cloneAndConvert<Matrix<T>>(distribution)),
+    _hostBufferUpToDate(true),
+    _deviceBuffersUpToDate(false),
+    _hostBuffer(std::move(vector)),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -170,6 +199,26 @@ Matrix<T>
   return matrix;
 }
 
+template <typename T>
+Matrix<T> Matrix<T>::mapFile(const std::string& path,
+                             const typename size_type::size_type rowCount,
+                             const typename size_type::size_type columnCount,
+                             detail::MapMode mode,
+                             const detail::Distribution<Matrix<T>>& distribution)
+{
+  Matrix<T> matrix;
+  matrix._mappedFile = std::make_shared<detail::MappedFile>(path, mode,
+                                             rowCount * columnCount * sizeof(T));
+  matrix._size = {rowCount, columnCount};
+  matrix._distribution = detail::cloneAndConvert<Matrix<T>>(distribution);
+  matrix._hostBufferUpToDate = true;
+  matrix._deviceBuffersUpToDate = false;
+  matrix._hostPointer = static_cast<pointer>(matrix._mappedFile->data());
+  LOG_DEBUG_INFO("Created new Matrix object (", &matrix, ") from file ", path,
+      " with ", matrix.getDebugInfo());
+  return matrix;
+}
+
 template <typename T>
 template <typename InputIterator>
 Matrix<T>::Matrix(InputIterator first, InputIterator last,
@@ -180,6 +229,8 @@ Matrix<T>::Matrix(InputIterator first, InputIterator last,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -206,6 +257,8 @@ Matrix<T>::Matrix(InputIterator first, InputIterator last,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(first, last),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerMatrixDeviceFunctions;
@@ -221,11 +274,15 @@ Matrix<T>::Matrix(Matrix<T>&& rhs)
     _hostBufferUpToDate(std::move(rhs._hostBufferUpToDate)),
     _deviceBuffersUpToDate(std::move(rhs._deviceBuffersUpToDate)),
     _hostBuffer(std::move(rhs._hostBuffer)),
+    _hostPointer(rhs._hostPointer),
+    _mappedFile(std::move(rhs._mappedFile)),
     _deviceBuffers(std::move(rhs._deviceBuffers))
 {
   (void)registerMatrixDeviceFunctions;
+  detail::globalMemoryManager.remove(&rhs);
   rhs._size = {0, 0};
   rhs._hostBuffer.clear();
+  rhs._hostPointer = nullptr;
 
   LOG_DEBUG_INFO("Created new Matrix object (", this, ") with ",
       getDebugInfo());
@@ -239,9 +296,13 @@ Matrix<T>& Matrix<T>::operator=(Matrix<T>&& rhs)
   _hostBufferUpToDate     = std::move(rhs._hostBufferUpToDate);
   _deviceBuffersUpToDate  = std::move(rhs._deviceBuffersUpToDate);
   _hostBuffer             = std::move(rhs._hostBuffer);
+  _hostPointer            = rhs._hostPointer;
+  _mappedFile             = std::move(rhs._mappedFile);
   _deviceBuffers          = std::move(rhs._deviceBuffers);
+  detail::globalMemoryManager.remove(&rhs);
 
   rhs._size = {0,0};
+  rhs._hostPointer = nullptr;
   rhs._hostBufferUpToDate = false;
   rhs._deviceBuffersUpToDate = false;
   LOG_DEBUG_INFO("Move assignment to Matrix object (", this, ") from (",
@@ -252,6 +313,7 @@ Matrix<T>& Matrix<T>::operator=(Matrix<T>&& rhs)
 template <typename T>
 Matrix<T>::~Matrix()
 {
+  detail::globalMemoryManager.remove(this);
   LOG_DEBUG_INFO("Matrix object (", this, ") with ", getDebugInfo(),
       " destroyed");
 }
@@ -260,6 +322,7 @@ template <typename T>
 typename Matrix<T>::iterator Matrix<T>::begin()
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.begin();
 }
 
@@ -267,6 +330,7 @@ template <typename T>
 typename Matrix<T>::const_iterator Matrix<T>::begin() const
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.begin();
 }
 
@@ -274,6 +338,7 @@ template <typename T>
 typename Matrix<T>::iterator Matrix<T>::end()
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.end();
 }
 
@@ -281,6 +346,7 @@ template <typename T>
 typename Matrix<T>::const_iterator Matrix<T>::end() const
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.end();
 }
 
@@ -289,6 +355,7 @@ typename Matrix<T>::iterator
     Matrix<T>::row_begin(typename coordinate::index_type rowIndex)
 {
   copyDataToHost();
+  detachHostPointer();
   auto n = rowIndex * _size.columnCount();
   if ( n < _size.elemCount() ) {
     auto it  = _hostBuffer.begin();
@@ -304,6 +371,7 @@ typename Matrix<T>::const_iterator
     Matrix<T>::row_begin(typename coordinate::index_type rowIndex) const
 {
   copyDataToHost();
+  detachHostPointer();
   auto n = rowIndex * _size.columnCount();
   if ( n < _size.elemCount() ) {
     auto it = _hostBuffer.begin();
@@ -369,6 +437,7 @@ typename Matrix<T>::size_type::size_type Matrix<T>::max_size() const
 template <typename T>
 void Matrix<T>::resize(const size_type& size, T c)
 {
+  detachHostPointer();
   if (_hostBufferUpToDate) {
     _hostBuffer.resize(size.elemCount(), c);
     // device buffers are now invalid
@@ -411,6 +480,7 @@ template <typename T>
 void Matrix<T>::reserve(size_type::size_type bytes)
 {
   // TODO: handling similar to resize ?
+  detachHostPointer();
   return _hostBuffer.reserve(bytes);
 }
 
@@ -418,14 +488,14 @@ template <typename T>
 typename Matrix<T>::reference Matrix<T>::operator()( coordinate c )
 {
   copyDataToHost();
-  return _hostBuffer[c.rowIndex * _size.columnCount() + c.columnIndex];
+  return hostData()[c.rowIndex * _size.columnCount() + c.columnIndex];
 }
 
 template <typename T>
 typename Matrix<T>::const_reference Matrix<T>::operator()( coordinate c ) const
 {
   copyDataToHost();
-  return _hostBuffer[c.rowIndex * _size.columnCount() + c.columnIndex];
+  return hostData()[c.rowIndex * _size.columnCount() + c.columnIndex];
 }
 
 template <typename T>
@@ -445,7 +515,7 @@ typename Matrix<T>::reference Matrix<T>::at( coordinate c )
   }
 
   copyDataToHost();
-  return _hostBuffer[c.rowIndex * _size.columnCount() + c.columnIndex];
+  return hostData()[c.rowIndex * _size.columnCount() + c.columnIndex];
 }
 
 template <typename T>
@@ -465,35 +535,35 @@ typename Matrix<T>::const_reference Matrix<T>::at( coordinate c ) const
   }
 
   copyDataToHost();
-  return _hostBuffer[c.rowIndex * _size.columnCount() + c.columnIndex];
+  return hostData()[c.rowIndex * _size.columnCount() + c.columnIndex];
 }
 
 template <typename T>
 typename Matrix<T>::reference Matrix<T>::front()
 {
   copyDataToHost();
-  return _hostBuffer.front();
+  return *hostData();
 }
 
 template <typename T>
 typename Matrix<T>::const_reference Matrix<T>::front() const
 {
   copyDataToHost();
-  return _hostBuffer.front();
+  return *hostData();
 }
 
 template <typename T>
 typename Matrix<T>::reference Matrix<T>::back()
 {
   copyDataToHost();
-  return _hostBuffer.back();
+  return hostData()[_size.elemCount() - 1];
 }
 
 template <typename T>
 typename Matrix<T>::const_reference Matrix<T>::back() const
 {
   copyDataToHost();
-  return _hostBuffer.back();
+  return hostData()[_size.elemCount() - 1];
 }
 
 template <typename T>
@@ -501,6 +571,7 @@ template <typename InputIterator>
 void Matrix<T>::assign(InputIterator first, InputIterator last)
 {
   copyDataToHost();
+  detachHostPointer();
 
   _hostBuffer.assign(first, last);
 
@@ -528,6 +599,7 @@ template <typename T>
 void Matrix<T>::assign(size_type size, const T& v )
 {
   copyDataToHost();
+  detachHostPointer();
 
   _hostBuffer.assign(size.rowCount() * size.columnCount(), v);
   _size = size;
@@ -542,6 +614,7 @@ template <class InputIterator>
 void Matrix<T>::push_back_row(InputIterator first, InputIterator last)
 {
   copyDataToHost();
+  detachHostPointer();
 
   // range is bigger than column => cut range
   if (std::distance(first, last) > _size.columnCount()) {
@@ -592,6 +665,7 @@ void Matrix<T>::insert_row(typename coordinate::index_type rowIndex,
                            InputIterator first, InputIterator last)
 {
   copyDataToHost();
+  detachHostPointer();
 
   auto rangeSize = std::distance(first, last);
 
@@ -638,6 +712,7 @@ template <typename T>
 typename Matrix<T>::iterator
   Matrix<T>::erase_row(typename coordinate::index_type rowIndex)
 {
+  detachHostPointer();
   _size = { _size.rowCount() -1 , _size.columnCount() };
   return _hostBuffer.erase(row_begin(rowIndex), row_end(rowIndex));
 }
@@ -646,6 +721,8 @@ template <typename T>
 void Matrix<T>::clear()
 {
   _hostBuffer.clear();
+  _hostPointer = nullptr;
+  _mappedFile.reset();
   _deviceBuffers.clear();
   _size = {0,0};
 }
@@ -708,6 +785,14 @@ void
 template <typename T>
 void Matrix<T>::createDeviceBuffers() const
 {
+  // mark as used first, so that the buffers are not evicted while created
+  std::vector<detail::Device::id_type> ids;
+  for (auto& devicePtr : _distribution->devices()) {
+    ids.push_back(devicePtr->id());
+  }
+  detail::globalMemoryManager.use(this, ids,
+                                  [this] () { this->evictDeviceBuffers(); });
+
   // create device buffers only if none have been created so far
   if (_deviceBuffers.empty()) {
     forceCreateDeviceBuffers();
@@ -781,7 +866,9 @@ detail::Event Matrix<T>::startDownload() const
 
   if (_hostBufferUpToDate) return events;
 
-  _hostBuffer.resize(_size.elemCount()); // make enough room to store data
+  if (_hostPointer == nullptr) {
+    _hostBuffer.resize(_size.elemCount()); // make enough room to store data
+  }
 
   _distribution->startDownload( const_cast<Matrix<T>&>(*this), &events );
 
@@ -817,19 +904,58 @@ void Matrix<T>::dataOnHostModified() const
   LOG_DEBUG_INFO("Data on host marked as modified");
 }
 
+template <typename T>
+bool Matrix<T>::hostIsUpToDate() const
+{
+  return _hostBufferUpToDate;
+}
+
+template <typename T>
+bool Matrix<T>::devicesAreUpToDate() const
+{
+  return _deviceBuffersUpToDate;
+}
+
 template <typename T>
 const detail::DeviceBuffer&
   Matrix<T>::deviceBuffer(const detail::Device& device) const
 {
+  restoreEvictedDeviceBuffers();
   return _deviceBuffers[device.id()];
 }
 
 template <typename T>
 typename Matrix<T>::host_buffer_type& Matrix<T>::hostBuffer() const
 {
+  detachHostPointer();
   return _hostBuffer;
 }
 
+template <typename T>
+typename Matrix<T>::pointer Matrix<T>::hostData() const
+{
+  if (_hostPointer != nullptr) return _hostPointer;
+  return _hostBuffer.data();
+}
+
+template <typename T>
+typename Matrix<T>::host_buffer_type Matrix<T>::release()
+{
+  copyDataToHost();
+  detachHostPointer();
+
+  host_buffer_type hostBuffer(std::move(_hostBuffer));
+  _hostBuffer.clear();
+  _size = {0, 0};
+  _hostBufferUpToDate = true;
+  _deviceBuffersUpToDate = false; // no device buffers left
+  _deviceBuffers.clear();
+
+  LOG_DEBUG_INFO("Matrix object (", this, ") released its elements, now with ",
+      getDebugInfo());
+  return hostBuffer;
+}
+
 template <typename T>
 std::string Matrix<T>::deviceFunctions()
 {
@@ -883,10 +1009,47 @@ std::string Matrix<T>::getDebugInfo() const
     << ", deviceBuffersCreated: "  << (!_deviceBuffers.empty())
     << ", hostBufferUpToDate: "    << _hostBufferUpToDate
     << ", deviceBuffersUpToDate: " << _deviceBuffersUpToDate
-    << ", hostBuffer: "            << _hostBuffer.data();
+    << ", hostBuffer: "            << hostData();
   return s.str();
 }
 
+template <typename T>
+void Matrix<T>::detachHostPointer() const
+{
+  if (_hostPointer == nullptr) return;
+
+  // the mapped memory is only up to date if the host is,
+  // otherwise the next download fills _hostBuffer
+  if (_hostBufferUpToDate) {
+    _hostBuffer.assign(_hostPointer, _hostPointer + _size.elemCount());
+  }
+  _hostPointer = nullptr;
+  _mappedFile.reset();
+  LOG_DEBUG_INFO("Matrix object (", this, ") copied mapped memory, now with ",
+      getDebugInfo());
+}
+
+template <typename T>
+void Matrix<T>::restoreEvictedDeviceBuffers() const
+{
+  // device buffers have been evicted by the memory manager
+  if (   _deviceBuffers.empty() && _size.elemCount() > 0
+      && _distribution != nullptr && _distribution->isValid() ) {
+    createDeviceBuffers();
+    startUpload();
+  }
+}
+
+template <typename T>
+void Matrix<T>::evictDeviceBuffers() const
+{
+  if (_deviceBuffers.empty()) return;
+  copyDataToHost(); // download modified data first
+  _deviceBuffersUpToDate = false;
+  _deviceBuffers.clear();
+  LOG_DEBUG_INFO("Matrix object (", this, ") evicted its device buffers");
+}
+
 } // namespace skelcl
 
 #endif // MATRIX_DEF_H_
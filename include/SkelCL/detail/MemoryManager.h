@@ -0,0 +1,144 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file MemoryManager.h
+///
+/// \brief Accounting of the memory allocated on every device. If allocating
+///        a new buffer would exceed the memory budget of a device, the device
+///        buffers of the least recently used containers are evicted (their
+///        data is downloaded first, if required). Evicted containers
+///        recreate their device buffers the next time they are used.
+///
+
+#ifndef MEMORY_MANAGER_H_
+#define MEMORY_MANAGER_H_
+
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "Device.h"
+#include "skelclDll.h"
+
+namespace skelcl {
+
+namespace detail {
+
+class SKELCL_DLL MemoryManager {
+public:
+  typedef std::function<void()> evict_function;
+
+  MemoryManager();
+
+  ///
+  /// \brief Accounts for a new buffer of the given size on the given device.
+  ///        If the budget of the device would be exceeded, containers are
+  ///        evicted from the device first.
+  ///
+  void allocate(const Device& device, size_t sizeInBytes);
+
+  ///
+  /// \brief Accounts for a released buffer of the given size.
+  ///
+  void release(const Device& device, size_t sizeInBytes);
+
+  ///
+  /// \brief Marks the device buffers of owner as most recently used.
+  ///
+  /// The owner is registered if necessary. evict is invoked when the owner
+  /// is chosen to free memory on one of the given devices. Owners used since
+  /// the last kernel has been enqueued are never evicted, as they are
+  /// probably accessed by the skeleton currently being prepared.
+  ///
+  void use(const void* owner,
+           const std::vector<Device::id_type>& devices,
+           evict_function evict);
+
+  ///
+  /// \brief Unregisters owner, e.g. when it is destroyed.
+  ///
+  void remove(const void* owner);
+
+  ///
+  /// \brief Signals that a kernel has been enqueued, i.e. the buffers of all
+  ///        owners used so far might be evicted again.
+  ///
+  void kernelEnqueued();
+
+  ///
+  /// \brief Evicts least recently used owners from the given device until at
+  ///        least sizeInBytes bytes are available within the budget.
+  ///
+  /// \return true if at least one owner has been evicted
+  ///
+  bool evict(const Device& device, size_t sizeInBytes);
+
+  ///
+  /// \brief Returns the number of bytes currently allocated on the device.
+  ///
+  size_t usedMemory(const Device& device) const;
+
+  ///
+  /// \brief Returns the number of bytes which might be allocated on the
+  ///        device. This is the global memory size of the device, unless the
+  ///        environment variable SKELCL_DEVICE_MEMORY_BUDGET specifies a
+  ///        different budget (in MB). The environment variable is read
+  ///        once, when the memory manager is constructed.
+  ///
+  size_t budget(const Device& device) const;
+
+private:
+  struct Entry {
+    const void*                   owner;
+    std::vector<Device::id_type>  devices;
+    evict_function                evict;
+    size_t                        lastUse;
+  };
+
+  // least recently used entry first
+  std::list<Entry>                                    _entries;
+  std::map<const void*, std::list<Entry>::iterator>   _index;
+  std::map<Device::id_type, size_t>                   _used;
+  size_t                                              _generation;
+  size_t                                              _budget; // 0: none
+};
+
+SKELCL_DLL extern MemoryManager globalMemoryManager;
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // MEMORY_MANAGER_H_
@@ -49,6 +49,7 @@ namespace skelcl {
 
 template<typename> class Matrix;
 template<typename> class Vector;
+template<typename> class Volume;
 
 namespace detail {
 
@@ -143,6 +144,11 @@ size_t sizeForDevice(const std::shared_ptr<Device>& devicePtr,
 		const typename Matrix<T>::size_type size, const DeviceList& devices,
 		unsigned int overlapRadius);
 
+template<typename T>
+size_t sizeForDevice(const std::shared_ptr<Device>& devicePtr,
+		const typename Volume<T>::size_type size, const DeviceList& devices,
+		unsigned int overlapRadius);
+
 template <typename T>
 void startUpload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
                  detail::Padding padding, const T& neutralElement,
@@ -153,6 +159,11 @@ void startUpload(Matrix<T>& vector, Event* events, unsigned int overlapRadius,
                  detail::Padding padding, const T& neutralElement,
                  const detail::DeviceList& devices);
 
+template <typename T>
+void startUpload(Volume<T>& volume, Event* events, unsigned int overlapRadius,
+                 detail::Padding padding, const T& neutralElement,
+                 const detail::DeviceList& devices);
+
 template <typename T>
 void startDownload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
                    const detail::DeviceList& devices);
@@ -161,6 +172,10 @@ template <typename T>
 void startDownload(Matrix<T>& vector, Event* events, unsigned int overlapRadius,
                    const detail::DeviceList& devices);
 
+template <typename T>
+void startDownload(Volume<T>& volume, Event* events, unsigned int overlapRadius,
+                   const detail::DeviceList& devices);
+
 } // namespace ol_distribution_helper
 
 } // namespace detail
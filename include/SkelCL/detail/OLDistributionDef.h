@@ -61,8 +61,9 @@ template <template <typename> class C, typename T>
 template <typename U>
 OLDistribution<C<T>>::OLDistribution(const OLDistribution<C<U>>& rhs)
   : Distribution<C<T>>(rhs), _overlap_radius(rhs.getOverlapRadius()),
-    _padding(rhs.getPadding()), _neutral_element()
-//_neutral_element(rhs.getNeutralElement()) // TODO: find solution for this!
+    _padding(rhs.getPadding()),
+    _neutral_element(convertNeutralElement<T>(rhs.getNeutralElement(),
+                                              rhs.getPadding()))
 {
 }
 
@@ -111,8 +112,10 @@ bool OLDistribution<C<T>>::dataExchangeOnDistributionChange(
 
   if (block == nullptr) { // distributions differ => data exchange
     return true;
-  } else { // new distribution == block distribution
-    if (this->_devices == block->_devices) // same set of devices
+  } else { // new distribution == overlap distribution
+    if (   this->_devices == block->_devices // same set of devices
+        && this->_overlap_radius == block->_overlap_radius // and layout
+        && this->_padding == block->_padding)
     {
       return false; // => no data exchange
     } else {
@@ -146,7 +149,8 @@ bool OLDistribution<C<T>>::doCompare(const Distribution<C<T>>& rhs) const
   // can rhs be casted into block distribution ?
   auto const blockRhs = dynamic_cast<const OLDistribution*>(&rhs);
   if (blockRhs) {
-    ret = true;
+    ret = (   this->_overlap_radius == blockRhs->_overlap_radius
+           && this->_padding == blockRhs->_padding);
   }
   return ret;
 }
@@ -190,6 +194,27 @@ size_t sizeForDevice(const std::shared_ptr<Device>& devicePtr,
   }
 }
 
+template <typename T>
+size_t sizeForDevice(const std::shared_ptr<Device>& devicePtr,
+                     const typename Volume<T>::size_type size,
+                     const DeviceList& devices,
+                     unsigned int overlapRadius)
+{
+  // the volume is split along the slices, every device stores overlapRadius
+  // additional slices on both sides of its slab
+  auto id = devicePtr->id();
+  if (id < devices.size() - 1) {
+    auto s = size.sliceCount() / devices.size();
+    s += overlapRadius + overlapRadius;
+    return s * size.sliceSize();
+  } else { // "last" device
+    auto s = size.sliceCount() / devices.size();
+    s += size.sliceCount() % devices.size();
+    s += overlapRadius + overlapRadius;
+    return s * size.sliceSize();
+  }
+}
+
 template <typename T>
 void startUpload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
                  detail::Padding padding, const T& neutralElement,
@@ -211,6 +236,11 @@ void startUpload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
     paddingFront.resize(overlapRadius, neutralElement);
     paddingBack.resize(overlapRadius, neutralElement);
     break;
+  case Padding::CLAMP:
+  case Padding::MIRROR:
+  case Padding::PERIODIC:
+    // handled by the kernel, no padding elements are required
+    break;
 #if 0
   case Padding::NEAREST_INITIAL:
     LOG_ERROR(
@@ -219,45 +249,60 @@ void startUpload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
 #endif
   }
 
-  // upload front padding to first device
+  std::vector<cl::Event> paddingEvents;
   auto& firstDevicePtr = devices.front();
-  auto frontEvent =
-      firstDevicePtr->enqueueWrite(vector.deviceBuffer(*firstDevicePtr),
-                                   paddingFront.begin(), paddingFront.size());
-
-  // upload back padding at the end of last device
   auto& lastDevicePtr = devices.back();
-  // calculate offset on the device ...
-  auto deviceOffset =
-      vector.deviceBuffer(*lastDevicePtr).size() - paddingBack.size();
-
-  auto backEvent = lastDevicePtr->enqueueWrite(
-      vector.deviceBuffer(*lastDevicePtr), paddingBack.begin(),
-      paddingBack.size(), deviceOffset);
+  auto& firstBuffer = vector.deviceBuffer(*firstDevicePtr);
+  auto& lastBuffer = vector.deviceBuffer(*lastDevicePtr);
+
+  if (overlapRadius > 0 && padding == Padding::PERIODIC) {
+    // the halo in front of the first device wraps around to the end of the
+    // vector and vice versa, both are uploaded directly from the host
+    events->insert(firstDevicePtr->enqueueWrite(
+        firstBuffer, vector.hostData(), overlapRadius, 0,
+        vector.size() - overlapRadius));
+    events->insert(lastDevicePtr->enqueueWrite(
+        lastBuffer, vector.hostData(), overlapRadius,
+        lastBuffer.size() - overlapRadius, 0));
+  } else if (overlapRadius > 0 && !paddingFront.empty()) {
+    // upload front padding to first device
+    paddingEvents.push_back(firstDevicePtr->enqueueWrite(
+        firstBuffer, paddingFront.begin(), paddingFront.size(), 0));
+
+    // upload back padding at the end of last device
+    // calculate offset on the device ...
+    auto backOffset = lastBuffer.size() - paddingBack.size();
+
+    paddingEvents.push_back(lastDevicePtr->enqueueWrite(
+        lastBuffer, paddingBack.begin(), paddingBack.size(), backOffset));
+  }
 
   // upload the regular data
   size_t hostOffset = 0;
-  deviceOffset = paddingFront.size();
+  size_t deviceOffset = overlapRadius;
 
   for (size_t i = 0; i < devices.size(); ++i) {
     auto& devicePtr = devices[i];
     auto& buffer = vector.deviceBuffer(*devicePtr);
 
     auto size = buffer.size();
-    if (i == 0) size -= paddingFront.size();
-    if (i == devices.size() - 1) size -= paddingBack.size();
+    if (i == 0) size -= overlapRadius;
+    if (i == devices.size() - 1) size -= overlapRadius;
 
-    auto event = devicePtr->enqueueWrite(buffer, vector.hostBuffer().begin(),
+    auto event = devicePtr->enqueueWrite(buffer, vector.hostData(),
                                           size, deviceOffset, hostOffset);
     events->insert(event);
 
-    hostOffset += size - overlapRadius;
+    // the next device starts overlapRadius elements before the end of the
+    // block of this device
+    hostOffset += size - 2 * overlapRadius;
     deviceOffset = 0; // after the first device, the device offset is 0
   }
 
   // wait for front and back transfer to finish before releasing the memory ...
-  frontEvent.wait();
-  backEvent.wait();
+  for (auto& event : paddingEvents) {
+    event.wait();
+  }
 }
 
 template <typename T>
@@ -297,32 +342,44 @@ void startUpload(Matrix<T>& matrix, Event* events, unsigned int overlapRadius,
     }
   }
 
-  // upload top padding to first device
+  std::vector<cl::Event> paddingEvents;
   auto& firstDevicePtr = devices.front();
-  auto topEvent =
-      firstDevicePtr->enqueueWrite(matrix.deviceBuffer(*firstDevicePtr),
-                                   paddingTop.begin(), paddingTop.size(), 0);
-
-  // upload bottom padding to last device
   auto& lastDevicePtr = devices.back();
-  auto deviceOffset =
-      matrix.deviceBuffer(*lastDevicePtr).size() - paddingBottom.size();
-  auto bottomEvent = lastDevicePtr->enqueueWrite(
-      matrix.deviceBuffer(*lastDevicePtr), paddingBottom.begin(),
-      paddingBottom.size(), deviceOffset, 0);
+  auto& firstBuffer = matrix.deviceBuffer(*firstDevicePtr);
+  auto& lastBuffer = matrix.deviceBuffer(*lastDevicePtr);
+
+  if (newSize > 0 && padding == detail::Padding::PERIODIC) {
+    // the halo above the first device wraps around to the last rows of the
+    // matrix and vice versa, both are uploaded directly from the host
+    events->insert(firstDevicePtr->enqueueWrite(
+        firstBuffer, matrix.hostData(), newSize, 0,
+        matrix.size().elemCount() - newSize));
+    events->insert(lastDevicePtr->enqueueWrite(
+        lastBuffer, matrix.hostData(), newSize, lastBuffer.size() - newSize,
+        0));
+  } else if (newSize > 0 && !paddingTop.empty()) {
+    // upload top padding to first device
+    paddingEvents.push_back(firstDevicePtr->enqueueWrite(
+        firstBuffer, paddingTop.begin(), paddingTop.size(), 0));
+
+    // upload bottom padding to last device
+    paddingEvents.push_back(lastDevicePtr->enqueueWrite(
+        lastBuffer, paddingBottom.begin(), paddingBottom.size(),
+        lastBuffer.size() - paddingBottom.size(), 0));
+  }
 
   // upload the regular parts
   size_t hostOffset = 0;
-  deviceOffset = paddingTop.size();
+  size_t deviceOffset = newSize;
 
   for (size_t i = 0; i < devices.size(); ++i) {
     auto& devicePtr = devices[i];
     auto& buffer = matrix.deviceBuffer(*devicePtr);
 
     auto size = buffer.size();
-    if (i == 0) size -= paddingTop.size();
-    if (i == devices.size() - 1) size -= paddingBottom.size();
-    auto event = devicePtr->enqueueWrite(buffer, matrix.hostBuffer().begin(),
+    if (i == 0) size -= newSize;
+    if (i == devices.size() - 1) size -= newSize;
+    auto event = devicePtr->enqueueWrite(buffer, matrix.hostData(),
                                          size, deviceOffset, hostOffset);
     events->insert(event);
 
@@ -338,8 +395,95 @@ void startUpload(Matrix<T>& matrix, Event* events, unsigned int overlapRadius,
 
   // wait for the data transfers to finish before releasing the memory of
   // paddingTop and paddingBottom
-  topEvent.wait();
-  bottomEvent.wait();
+  for (auto& event : paddingEvents) {
+    event.wait();
+  }
+}
+
+template <typename T>
+void startUpload(Volume<T>& volume, Event* events, unsigned int overlapRadius,
+                 detail::Padding padding, const T& neutralElement,
+                 const detail::DeviceList& devices)
+{
+  ASSERT(events != nullptr);
+
+  auto sliceSize = volume.size().sliceSize();
+  auto newSize = overlapRadius * sliceSize;
+
+  // create padding slices
+  std::vector<T> paddingFront;
+  std::vector<T> paddingBack;
+
+  if (padding == detail::Padding::NEUTRAL) {
+    paddingFront.resize(newSize, neutralElement);
+    paddingBack.resize(newSize, neutralElement);
+  }
+
+  if (padding == detail::Padding::NEAREST) {
+    auto firstSlice = volume.hostData();
+    auto lastSlice = volume.hostData() + volume.size().elemCount() - sliceSize;
+    paddingFront.resize(newSize);
+    paddingBack.resize(newSize);
+    for (auto i = 0u; i < overlapRadius; i++) {
+      std::copy(firstSlice, firstSlice + sliceSize,
+                paddingFront.begin() + i * sliceSize);
+      std::copy(lastSlice, lastSlice + sliceSize,
+                paddingBack.begin() + i * sliceSize);
+    }
+  }
+
+  std::vector<cl::Event> paddingEvents;
+  auto& firstDevicePtr = devices.front();
+  auto& lastDevicePtr = devices.back();
+  auto& firstBuffer = volume.deviceBuffer(*firstDevicePtr);
+  auto& lastBuffer = volume.deviceBuffer(*lastDevicePtr);
+
+  if (newSize > 0 && padding == detail::Padding::PERIODIC) {
+    // the halo in front of the first device wraps around to the last slices
+    // of the volume and vice versa, both are uploaded directly from the host
+    events->insert(firstDevicePtr->enqueueWrite(
+        firstBuffer, volume.hostData(), newSize, 0,
+        volume.size().elemCount() - newSize));
+    events->insert(lastDevicePtr->enqueueWrite(
+        lastBuffer, volume.hostData(), newSize, lastBuffer.size() - newSize,
+        0));
+  } else if (newSize > 0 && !paddingFront.empty()) {
+    // upload front padding to first device
+    paddingEvents.push_back(firstDevicePtr->enqueueWrite(
+        firstBuffer, paddingFront.begin(), paddingFront.size(), 0));
+
+    // upload back padding to last device
+    paddingEvents.push_back(lastDevicePtr->enqueueWrite(
+        lastBuffer, paddingBack.begin(), paddingBack.size(),
+        lastBuffer.size() - paddingBack.size()));
+  }
+
+  // upload the regular slices, including the halo slices of the neighbours
+  size_t hostOffset = 0;
+  size_t deviceOffset = newSize;
+
+  for (size_t i = 0; i < devices.size(); ++i) {
+    auto& devicePtr = devices[i];
+    auto& buffer = volume.deviceBuffer(*devicePtr);
+
+    auto size = buffer.size();
+    if (i == 0) size -= newSize;
+    if (i == devices.size() - 1) size -= newSize;
+
+    auto event = devicePtr->enqueueWrite(buffer, volume.hostData(),
+                                         size, deviceOffset, hostOffset);
+    events->insert(event);
+
+    // the next device starts overlapRadius slices before the end of the
+    // slab of this device
+    hostOffset += size - 2 * newSize;
+    deviceOffset = 0; // after the first device, the device offset is 0
+  }
+
+  // wait for the padding transfers to finish before releasing the memory
+  for (auto& event : paddingEvents) {
+    event.wait();
+  }
 }
 
 template <typename T>
@@ -355,7 +499,7 @@ void startDownload(Vector<T>& vector, Event* events, unsigned int overlapRadius,
 
     auto size = buffer.size() - (2 * overlapRadius);
 
-    auto event = devicePtr->enqueueRead(buffer, vector.hostBuffer().begin(),
+    auto event = devicePtr->enqueueRead(buffer, vector.hostData(),
                                         size, overlapRadius, offset);
     offset += size;
     events->insert(event);
@@ -381,7 +525,7 @@ void startDownload(Matrix<T>& matrix, Event* events, unsigned int overlapRadius,
 
     auto size = buffer.size() - (2 * overlapSize);
 
-    auto event = devicePtr->enqueueRead(buffer, matrix.hostBuffer().begin(),
+    auto event = devicePtr->enqueueRead(buffer, matrix.hostData(),
                                         size, overlapSize, offset);
     offset += size;
     events->insert(event);
@@ -392,6 +536,31 @@ void startDownload(Matrix<T>& matrix, Event* events, unsigned int overlapRadius,
   matrix.dataOnHostModified();
 }
 
+template <typename T>
+void startDownload(Volume<T>& volume, Event* events, unsigned int overlapRadius,
+                   const detail::DeviceList& devices)
+{
+  ASSERT(events != nullptr);
+
+  size_t offset = 0;
+  auto overlapSize = overlapRadius * volume.size().sliceSize();
+
+  for (auto& devicePtr : devices) {
+    auto& buffer = volume.deviceBuffer(*devicePtr);
+
+    auto size = buffer.size() - (2 * overlapSize);
+
+    auto event = devicePtr->enqueueRead(buffer, volume.hostData(),
+                                        size, overlapSize, offset);
+    offset += size;
+    events->insert(event);
+  }
+
+  // the halo slices on the devices are not kept up to date by the kernels,
+  // therefore, the data has to be uploaded again before it is used as input
+  volume.dataOnHostModified();
+}
+
 } // namespace ol_distribution_helper
 
 } // namespace detail
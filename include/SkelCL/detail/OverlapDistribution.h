@@ -30,7 +30,7 @@
  * license, please contact the author at michel.steuwer@uni-muenster.de      *
  *                                                                           *
  *****************************************************************************/
- 
+
 ///
 /// \file OverlapDistribution.h
 ///
@@ -42,12 +42,13 @@
 #define OVERLAP_DISTRIBUTION_H_
 
 #include "Distribution.h"
-
-#include "../Vector.h"
-#include "../Matrix.h"
+#include "OLDistribution.h"
+#include "Padding.h"
 
 namespace skelcl {
 
+template <typename> class Vector;
+
 namespace detail {
 
 class DeviceList;
@@ -55,16 +56,20 @@ class DeviceList;
 template <typename> class OverlapDistribution;
 
 // Vector version
+//
+// Every device stores a block of the vector together with overlapRadius
+// elements of its neighbours on each side. The first and last device store
+// padding elements instead, which are created according to the padding mode.
 template <typename T>
 class OverlapDistribution<Vector<T>> : public Distribution<Vector<T>> {
 public:
-  OverlapDistribution( Vector<T>::size_type overlapRadius = 1,
+  OverlapDistribution( unsigned int overlapRadius = 1,
                        Padding padding = Padding::NEUTRAL,
                        T neutralElement = T(),
                        const DeviceList& deviceList = globalDeviceList );
 
   template <typename U>
-  OverlapDistribution( const OverlapDistribution<Vector<U>>&rhs );
+  OverlapDistribution( const OverlapDistribution<Vector<U>>& rhs );
 
   ~OverlapDistribution();
 
@@ -75,61 +80,21 @@ public:
   void startDownload(Vector<T>& container, Event* events) const;
 
   size_t sizeForDevice(const Vector<T>& container,
-                       const detail::Device::id_type id) const;
+                       const std::shared_ptr<detail::Device>& devicePtr) const;
 
   bool dataExchangeOnDistributionChange(Distribution<Vector<T>>&
                                             newDistribution);
 
-  typename Vector<T>::size_type& overlapRadius() const;
+  unsigned int overlapRadius() const;
 
-  Padding& padding() const;
+  Padding padding() const;
 
-  T& neutralElement() const;
+  const T& neutralElement() const;
 
 private:
   bool doCompare(const Distribution<Vector<T>>& rhs) const;
 
-  Vector<T>::size_type            _overlapRadius;
-  Padding                         _padding;
-  T                               _neutralElement;
-};
-
-// Matrix version
-template <typename T>
-class OverlapDistribution<Matrix<T>> : public Distribution<Matrix<T>> {
-public:
-  OverlapDistribution( Matrix<T>::size_type::size_type overlapRadius = 1,
-                       Padding padding = Padding::NEUTRAL,
-                       T neutralElement = T(),
-                       const DeviceList& deviceList = globalDeviceList );
-
-  template <typename U>
-  OverlapDistribution( const OverlapDistribution<Matrix<U>>&rhs );
-
-  ~OverlapDistribution();
-
-  bool isValid() const;
-
-  void startUpload(Matrix<T>& container, Event* events) const;
-
-  void startDownload(Matrix<T>& container, Event* events) const;
-
-  size_t sizeForDevice(const Matrix<T>& container,
-                       const detail::Device::id_type id) const;
-
-  bool dataExchangeOnDistributionChange(Distribution<Matrix<T>>&
-                                            newDistribution);
-
-  typename Matrix<T>::size_type::size_type& overlapRadius() const;
-
-  Padding& padding() const;
-
-  T& neutralElement() const;
-
-private:
-  bool doCompare(const Distribution<Matrix<T>>& rhs) const;
-
-  Matrix<T>::size_type::size_type _overlapRadius;
+  unsigned int                    _overlapRadius;
   Padding                         _padding;
   T                               _neutralElement;
 };
@@ -138,5 +103,7 @@ private:
 
 } // namespace skelcl
 
-#endif // BLOCK_DISTRIBUTION_H_
+#include "OverlapDistributionDef.h"
+
+#endif // OVERLAP_DISTRIBUTION_H_
 
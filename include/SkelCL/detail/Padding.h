@@ -41,15 +41,119 @@
 #ifndef PADDING_H_
 #define PADDING_H_
 
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <pvsutil/Logger.h>
+
 namespace skelcl {
 
 namespace detail {
 
+///
+/// \brief Defines how the MapOverlap and Convolution skeletons handle accesses
+///        outside of the container.
+///
+/// NEUTRAL and NEAREST store padding elements next to the container on the
+/// devices. The other modes remap out of bound indices inside the kernel,
+/// PERIODIC additionally exchanges the halo between the first and the last
+/// device.
+///
 enum class Padding {
-  NEUTRAL,
-  NEAREST
+  NEUTRAL,  ///< the provided neutral element is used
+  NEAREST,  ///< the nearest element of the container is used
+  CLAMP,    ///< like NEAREST, but without padding elements on the devices
+  MIRROR,   ///< the container is mirrored at its border, i.e. the element at
+            ///< index -i is the element at index i-1
+  PERIODIC  ///< the container wraps around, i.e. the element at index -i is
+            ///< the element at index n-i
 };
 
+///
+/// \brief Returns the OpenCL definitions implementing the given padding mode
+///        inside of a kernel.
+///
+/// SCL_REMAP(i, n) maps an index outside of 0 .. n-1 to the index of the
+/// element used instead. NEUTRAL defines the neutral element instead.
+/// Rows (or slices) outside of the container are read from the halo stored on
+/// the devices, except if SCL_NO_PADDING is defined.
+///
+/// \param padding The padding mode.
+/// \param neutralElement The neutral element used by the NEUTRAL mode.
+///
+template <typename T>
+std::string paddingDefinitions(Padding padding, const T& neutralElement)
+{
+  std::stringstream s;
+
+  switch (padding) {
+  case Padding::NEUTRAL:
+    s << "#define NEUTRAL (" << neutralElement << ")\n";
+    break;
+  case Padding::NEAREST:
+  case Padding::CLAMP:
+    s << "int SCL_REMAP(int i, int n) { return clamp(i, 0, n - 1); }\n";
+    break;
+  case Padding::MIRROR:
+    s << "int SCL_REMAP(int i, int n) {\n"
+         "  if (i < 0) i = -i - 1;\n"
+         "  if (i >= n) i = 2 * n - i - 1;\n"
+         "  return clamp(i, 0, n - 1);\n"
+         "}\n";
+    break;
+  case Padding::PERIODIC:
+    s << "#define SCL_PERIODIC\n"
+         "int SCL_REMAP(int i, int n) { return (i % n + n) % n; }\n";
+    break;
+  }
+  if (padding == Padding::CLAMP || padding == Padding::MIRROR) {
+    s << "#define SCL_NO_PADDING\n";
+  }
+
+  return s.str();
+}
+
+namespace padding_helper {
+
+template <typename T, typename U>
+T convertNeutralElement(const U& neutralElement, Padding, std::true_type)
+{
+  return static_cast<T>(neutralElement);
+}
+
+template <typename T, typename U>
+T convertNeutralElement(const U&, Padding padding, std::false_type)
+{
+  if (padding == Padding::NEUTRAL) {
+    LOG_WARNING("The neutral element of an overlap distribution can not be "
+                "converted to the new element type, a default constructed "
+                "element is used instead");
+  }
+  return T();
+}
+
+} // namespace padding_helper
+
+///
+/// \brief Converts the neutral element of an overlap distribution when the
+///        distribution is converted to another element type.
+///
+/// If the neutral element can not be converted a default constructed element
+/// is used instead. A warning is logged if it is used, i.e. if padding is
+/// NEUTRAL.
+///
+/// \param neutralElement The neutral element of the converted distribution.
+/// \param padding The padding mode of the converted distribution.
+///
+template <typename T, typename U>
+T convertNeutralElement(const U& neutralElement, Padding padding)
+{
+  return padding_helper::convertNeutralElement<T>(neutralElement, padding,
+           std::integral_constant<bool,
+                                  std::is_constructible<T, U>::value>());
+}
+
 } // namespace detail
 
 } // namespace skelcl
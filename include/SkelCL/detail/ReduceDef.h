@@ -64,13 +64,17 @@
 #include "../Distributions.h"
 #include "../Out.h"
 #include "../Source.h"
+#include "../Vector.h"
 
+#include "Batch.h"
 #include "Device.h"
 #include "DeviceBuffer.h"
 #include "DeviceList.h"
 #include "KernelUtil.h"
 #include "Program.h"
+#include "ReduceHelper.h"
 #include "Skeleton.h"
+#include "Streaming.h"
 #include "Util.h"
 
 
@@ -80,7 +84,7 @@ template <typename T>
 Reduce<T(T)>::Reduce(const Source& source, const std::string& id,
                      const std::string& funcName)
   : detail::Skeleton(), _id(id), _funcName(funcName), _userSource(source),
-    _program{createPrepareAndBuildProgram()}
+    _program{createPrepareAndBuildProgram()}, _segmentsProgram()
 {
 }
 
@@ -98,26 +102,39 @@ template <typename... Args>
 Vector<T>& Reduce<T(T)>::operator()(Out<Vector<T>> output,
                                     const Vector<T>& input, Args&&... args)
 {
-  const size_t global_size = 8192;
+  if (   input.hostIsUpToDate()
+      && detail::streaming::isRequired(input.size(), sizeof(T)) ) {
+    prepareAdditionalInput(std::forward<Args>(args)...);
+    executeStreaming(output, input, std::forward<Args>(args)...);
+    return output.container();
+  }
 
   prepareInput(input);
-  ASSERT(input.distribution().devices().size() == 1);
 
-  // TODO: relax to multiple devices later
+  bool isCopy = (dynamic_cast<detail::CopyDistribution<Vector<T>>*>(
+                   &input.distribution()) != nullptr);
+
+  if (input.distribution().devices().size() > 1 && !isCopy) {
+    executeMultiDevice(output, input, std::forward<Args>(args)...);
+    return output.container();
+  }
+
+  // a single device holds all elements
   auto &device = *(input.distribution().devices().front());
 
+  // one partial result per work-group
+  size_t groups = numberOfGroups(device, input.size());
+
   Vector<T> tmpOutput;
-  prepareOutput(tmpOutput, input, global_size);
+  prepareOutput(tmpOutput, input, groups);
   prepareOutput(output.container(), tmpOutput, 1);
 
   execute_first_step(device, input.deviceBuffer(device),
-                     tmpOutput.deviceBuffer(device), input.size(), global_size,
+                     tmpOutput.deviceBuffer(device), input.size(), groups,
                      args...);
 
-  size_t new_data_size = std::min(global_size, input.size());
-
   execute_second_step(device, tmpOutput.deviceBuffer(device),
-                      output.container().deviceBuffer(device), new_data_size,
+                      output.container().deviceBuffer(device), groups,
                       args...);
 
   // ... finally update modification status.
@@ -126,6 +143,91 @@ Vector<T>& Reduce<T(T)>::operator()(Out<Vector<T>> output,
   return output.container();
 }
 
+template <typename T>
+template <typename... Args>
+Vector<T>& Reduce<T(T)>::batch(Out<Vector<T>> output,
+                               const std::vector<Vector<T>>& inputs,
+                               Args&&... args)
+{
+  auto& result = output.container();
+  // the previous results are overwritten, so they are not downloaded
+  result.dataOnHostModified();
+  result.resize(inputs.size());
+  if (inputs.empty()) return result;
+
+  // pack all inputs into a single container and reduce every one of them with
+  // a work-group of its own in a single kernel launch
+  auto offsets = detail::batch::offsets(inputs);
+  Vector<T> packedInput = detail::batch::pack(inputs, offsets);
+  if (packedInput.empty()) {
+    packedInput.resize(1); // device buffers must not be empty, never read
+  }
+
+  Vector<unsigned int> table(offsets.size());
+  std::transform(offsets.begin(), offsets.end(), table.hostData(),
+                 [](size_t offset) {
+                   return static_cast<unsigned int>(offset);
+                 });
+
+  // the batch is processed on a single device
+  packedInput.setDistribution(detail::SingleDistribution<Vector<T>>());
+  auto& devicePtr = packedInput.distribution().devices().front();
+  table.setDistribution(
+      detail::SingleDistribution<Vector<unsigned int>>(devicePtr));
+  result.setDistribution(detail::SingleDistribution<Vector<T>>(devicePtr));
+
+  packedInput.createDeviceBuffers();
+  table.createDeviceBuffers();
+  result.createDeviceBuffers();
+
+  packedInput.startUpload();
+  table.startUpload();
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  auto& program      = segmentsProgram();
+  auto& device       = *devicePtr;
+  auto& inputBuffer  = packedInput.deviceBuffer(device);
+  auto& tableBuffer  = table.deviceBuffer(device);
+  auto& outputBuffer = result.deviceBuffer(device);
+  try {
+    const size_t local_size = detail::reduceHelper::localSize(
+                                program, device, "SCL_REDUCE_SEGMENTS",
+                                this->workGroupSize());
+
+    cl::Kernel kernel = program.kernel(device, "SCL_REDUCE_SEGMENTS");
+    kernel.setArg(0, inputBuffer.clBuffer());
+    kernel.setArg(1, outputBuffer.clBuffer());
+    kernel.setArg(2, cl::__local(local_size * sizeof(T)));
+    kernel.setArg(3, tableBuffer.clBuffer());
+
+    detail::kernelUtil::setKernelArgs(kernel, device, 4,
+                                      std::forward<Args>(args)...);
+
+    auto keepAlive = detail::kernelUtil::keepAlive(device,
+                                                   inputBuffer.clBuffer(),
+                                                   outputBuffer.clBuffer(),
+                                                   tableBuffer.clBuffer(),
+                                                   std::forward<Args>(args)...);
+
+    // after finishing the kernel invoke this function ...
+    auto invokeAfter = [keepAlive]() {};
+
+    device.enqueue(kernel, cl::NDRange(inputs.size() * local_size),
+                   cl::NDRange(local_size),
+                   cl::NullRange, // offset
+                   invokeAfter);
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  // ... finally update modification status.
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  LOG_DEBUG_INFO("Reduce processed a batch of ", inputs.size(), " vectors");
+  return result;
+}
+
 // private member functions
 
 template <typename T>
@@ -133,7 +235,7 @@ void Reduce<T(T)>::prepareInput(const Vector<T>& input)
 {
   // set default distribution if required
   if (!input.distribution().isValid()) {
-    input.setDistribution(detail::SingleDistribution<Vector<T>>());
+    input.setDistribution(detail::BlockDistribution<Vector<T>>());
   }
   // create buffers if required
   input.createDeviceBuffers();
@@ -159,31 +261,61 @@ void Reduce<T(T)>::prepareOutput(Vector<T>& output, const Vector<T>& input,
   output.createDeviceBuffers();
 }
 
+template <typename T>
+size_t Reduce<T(T)>::localSize(const detail::Device& device) const
+{
+  return detail::reduceHelper::localSize(_program, device, "SCL_REDUCE",
+                                         this->workGroupSize());
+}
+
+template <typename T>
+size_t Reduce<T(T)>::numberOfGroups(const detail::Device& device,
+                                    size_t data_size) const
+{
+  // every work-group has to process at least one element (or vector)
+  const size_t items = vectorType().empty()
+                     ? data_size
+                     : std::max(data_size / 4, data_size % 4);
+
+  return detail::reduceHelper::numberOfGroups(device, localSize(device),
+                                              items);
+}
+
+template <typename T>
+template <typename... Args>
+cl::Kernel Reduce<T(T)>::prepareKernel(const detail::Device& device,
+                                       const detail::DeviceBuffer& input,
+                                       const detail::DeviceBuffer& output,
+                                       size_t data_size, size_t local_size,
+                                       Args&&... args)
+{
+  cl::Kernel kernel = _program.kernel(device, "SCL_REDUCE");
+
+  kernel.setArg(0, input.clBuffer());
+  kernel.setArg(1, output.clBuffer());
+  kernel.setArg(2, cl::__local(local_size * sizeof(T)));
+  kernel.setArg(3, static_cast<cl_uint>(data_size));
+
+  detail::kernelUtil::setKernelArgs(kernel, device, 4,
+                                    std::forward<Args>(args)...);
+  return kernel;
+}
+
 template <typename T>
 template <typename... Args>
 void Reduce<T(T)>::execute_first_step(const detail::Device& device,
                                       const detail::DeviceBuffer& input,
                                       detail::DeviceBuffer& output,
-                                      size_t data_size, size_t global_size,
+                                      size_t data_size, size_t groups,
                                       Args&&... args)
 {
+  ASSERT(output.size() >= groups);
   try
   {
-    cl::Kernel kernel = _program.kernel(device, "SCL_REDUCE_1");
-
-    const size_t max_local_size =
-        kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device.clDevice());
-    const size_t local_size = std::min(this->workGroupSize(), max_local_size);
-
-    if (global_size < local_size) global_size = local_size;
-
-    kernel.setArg(0, input.clBuffer());
-    kernel.setArg(1, output.clBuffer());
-    kernel.setArg(2, static_cast<cl_uint>(data_size));
-    kernel.setArg(3, static_cast<cl_uint>(global_size));
+    const size_t local_size = localSize(device);
 
-    detail::kernelUtil::setKernelArgs(kernel, device, 4,
-                                      std::forward<Args>(args)...);
+    cl::Kernel kernel = prepareKernel(device, input, output, data_size,
+                                      local_size, std::forward<Args>(args)...);
 
     auto keepAlive = detail::kernelUtil::keepAlive(device, input.clBuffer(),
                                                    output.clBuffer(),
@@ -192,7 +324,8 @@ void Reduce<T(T)>::execute_first_step(const detail::Device& device,
     // after finishing the kernel invoke this function ...
     auto invokeAfter = [keepAlive]() {};
 
-    device.enqueue(kernel, cl::NDRange(global_size), cl::NDRange(local_size),
+    device.enqueue(kernel, cl::NDRange(groups * local_size),
+                   cl::NDRange(local_size),
                    cl::NullRange, // offset
                    invokeAfter);
   }
@@ -209,39 +342,136 @@ void Reduce<T(T)>::execute_second_step(const detail::Device& device,
                                        detail::DeviceBuffer& output,
                                        size_t data_size, Args&&... args)
 {
-  try
-  {
-    cl::Kernel kernel = _program.kernel(device, "SCL_REDUCE_2");
+  // a single work-group combines all partial results
+  execute_first_step(device, input, output, data_size, 1,
+                     std::forward<Args>(args)...);
+}
+
+template <typename T>
+template <typename... Args>
+void Reduce<T(T)>::executeMultiDevice(Out<Vector<T>> output,
+                                      const Vector<T>& input, Args&&... args)
+{
+  auto& devices = input.distribution().devices();
 
-    const size_t max_local_size =
-        kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device.clDevice());
-    const size_t local_size = std::min(data_size, max_local_size);
+  // 1. every device reduces its block to a single value
+  std::vector<detail::DeviceBuffer> partials;
+  for (auto& devicePtr : devices) {
+    auto& inputBuffer = input.deviceBuffer(*devicePtr);
+    if (inputBuffer.size() == 0) continue;
 
-    kernel.setArg(0, input.clBuffer());
-    kernel.setArg(1, output.clBuffer());
-    kernel.setArg(2, cl::__local(local_size * sizeof(T)));
-    kernel.setArg(3, static_cast<cl_uint>(data_size));
-    kernel.setArg(4, static_cast<cl_uint>(local_size));
+    size_t groups = numberOfGroups(*devicePtr, inputBuffer.size());
+    detail::DeviceBuffer tmpBuffer(devicePtr, groups, sizeof(T));
+    partials.emplace_back(devicePtr, 1, sizeof(T));
 
-    detail::kernelUtil::setKernelArgs(kernel, device, 5,
-                                      std::forward<Args>(args)...);
+    execute_first_step(*devicePtr, inputBuffer, tmpBuffer, inputBuffer.size(),
+                       groups, args...);
 
-    auto keepAlive = detail::kernelUtil::keepAlive(device, input.clBuffer(),
-                                                   output.clBuffer(),
-                                                   std::forward<Args>(args)...);
+    execute_second_step(*devicePtr, tmpBuffer, partials.back(), groups,
+                        args...);
+  }
 
-    // after finishing the kernel invoke this function ...
-    auto invokeAfter = [keepAlive]() {};
+  LOG_DEBUG_INFO("Reduce combines ", partials.size(), " partial results");
 
-    ASSERT(local_size <= data_size);
-    device.enqueue(kernel, cl::NDRange(local_size), cl::NDRange(local_size),
-                   cl::NullRange, // offset
-                   invokeAfter);
+  // 2. combine the partial results on the first device
+  auto& device = *devices.front();
+  auto partialsBuffer = detail::reduceHelper::gatherPartials(partials,
+                                                             devices.front());
+
+  // the result is computed on the first device only
+  auto& result = output.container();
+  if (result.size() < 1) {
+    result.resize(1);
   }
-  catch (cl::Error& err)
-  {
-    ABORT_WITH_ERROR(err);
+  result.setDistribution(
+      detail::SingleDistribution<Vector<T>>(devices.front()));
+  result.createDeviceBuffers();
+
+  execute_second_step(device, partialsBuffer,
+                      result.deviceBuffer(device), partials.size(), args...);
+
+  // ... finally update modification status.
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+}
+
+template <typename T>
+template <typename... Args>
+void Reduce<T(T)>::executeStreaming(Out<Vector<T>> output,
+                                    const Vector<T>& input, Args&&... args)
+{
+  namespace streaming = detail::streaming;
+
+  // upper bounds for the number of chunks and work-groups
+  size_t minChunkSize = input.size();
+  size_t maxGroups    = 1;
+  for (auto& devicePtr : detail::globalDeviceList) {
+    minChunkSize = std::min(minChunkSize,
+                            streaming::chunkSize(*devicePtr, sizeof(T)));
+    maxGroups    = std::max(maxGroups,
+                            numberOfGroups(*devicePtr, input.size()));
   }
+  std::vector<T> partials(detail::util::devideAndRoundUp(input.size(),
+                                                         minChunkSize));
+  size_t chunks = 0;
+
+  const T* inputPtr = input.hostData();
+
+  streaming::Buffers inputBuffers(sizeof(T), sizeof(T));
+  auto tmpBuffers    = streaming::Buffers::withFixedSize(sizeof(T),
+                                                         maxGroups);
+  auto resultBuffers = streaming::Buffers::withFixedSize(sizeof(T), 1);
+
+  auto upload = [&] (const streaming::Chunk& chunk,
+                     const streaming::Events& waitFor) {
+    return streaming::Events(1,
+             chunk.devicePtr->enqueueTransferWrite(inputBuffers[chunk],
+                                                   inputPtr + chunk.offset,
+                                                   chunk.size, waitFor) );
+  };
+
+  // both steps are enqueued on the same (in order) command queue
+  auto compute = [&] (const streaming::Chunk& chunk,
+                      const streaming::Events& waitFor) {
+    auto& device = *chunk.devicePtr;
+    chunks = std::max(chunks, chunk.index + 1);
+    cl::Event event;
+    try {
+      size_t local_size = localSize(device);
+      size_t groups     = numberOfGroups(device, chunk.size);
+
+      cl::Kernel first = prepareKernel(device, inputBuffers[chunk],
+                                       tmpBuffers[chunk], chunk.size,
+                                       local_size, std::forward<Args>(args)...);
+      device.enqueue(first, cl::NDRange(groups * local_size),
+                     cl::NDRange(local_size), waitFor);
+
+      cl::Kernel second = prepareKernel(device, tmpBuffers[chunk],
+                                        resultBuffers[chunk], groups,
+                                        local_size, std::forward<Args>(args)...);
+      event = device.enqueue(second, cl::NDRange(local_size),
+                             cl::NDRange(local_size), streaming::Events());
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+    return event;
+  };
+
+  auto download = [&] (const streaming::Chunk& chunk,
+                       const streaming::Events& waitFor) {
+    return chunk.devicePtr->enqueueTransferRead(resultBuffers[chunk],
+                                                &partials[chunk.index],
+                                                1, waitFor);
+  };
+
+  streaming::process(input.size(), sizeof(T), upload, compute, download);
+
+  LOG_DEBUG_INFO("Reduce streamed ", input.size(), " elements in ", chunks,
+                 " chunks");
+
+  // reduce the partial results of all chunks
+  partials.resize(chunks);
+  Vector<T> partialResults(std::move(partials));
+  this->operator()(output, partialResults, std::forward<Args>(args)...);
 }
 
 template <typename T>
@@ -253,6 +483,10 @@ skelcl::detail::Program Reduce<T(T)>::createPrepareAndBuildProgram()
   std::string s(detail::CommonDefinitions::getSource());
   // second: user defined source
   s.append(_userSource);
+  // third: enable vector loads for built-in scalar types
+  if (!vectorType().empty()) {
+    s.append("\n#define SCL_VECTOR_TYPE " + vectorType() + "\n");
+  }
   // last: append skeleton implementation source
   s.append(
 #include "ReduceKernel.cl"
@@ -262,8 +496,46 @@ skelcl::detail::Program Reduce<T(T)>::createPrepareAndBuildProgram()
       detail::Program(s, skelcl::detail::util::hash("//Reduce\n" + s));
   if (!program.loadBinary()) {
     // append parameters from user function to kernels
-    program.transferParameters(_funcName, 2, "SCL_REDUCE_1");
-    program.transferParameters(_funcName, 2, "SCL_REDUCE_2");
+    program.transferParameters(_funcName, 2, "SCL_REDUCE");
+    program.transferArguments(_funcName, 2, "SCL_FUNC");
+    // rename user function
+    program.renameFunction(_funcName, "SCL_FUNC");
+    // rename typedefs
+    program.adjustTypes<T>();
+  }
+  program.build();
+  return program;
+}
+
+template <typename T>
+const skelcl::detail::Program& Reduce<T(T)>::segmentsProgram()
+{
+  // built on first use only, as it requires the identity
+  if (_segmentsProgram == nullptr) {
+    _segmentsProgram.reset(new detail::Program(createSegmentsProgram()));
+  }
+  return *_segmentsProgram;
+}
+
+template <typename T>
+skelcl::detail::Program Reduce<T(T)>::createSegmentsProgram() const
+{
+  // first: device specific functions
+  std::string s(detail::CommonDefinitions::getSource());
+  // second: identity, which is the result of empty segments
+  s.append("#define SCL_IDENTITY (" + _id + ")\n");
+  // third: user defined source
+  s.append(_userSource);
+  // last: append skeleton implementation source
+  s.append(
+#include "ReduceSegmentsKernel.cl"
+      );
+
+  auto program =
+      detail::Program(s, skelcl::detail::util::hash("//ReduceSegments\n" + s));
+  if (!program.loadBinary()) {
+    // append parameters from user function to kernels
+    program.transferParameters(_funcName, 2, "SCL_REDUCE_SEGMENTS");
     program.transferArguments(_funcName, 2, "SCL_FUNC");
     // rename user function
     program.renameFunction(_funcName, "SCL_FUNC");
@@ -274,6 +546,16 @@ skelcl::detail::Program Reduce<T(T)>::createPrepareAndBuildProgram()
   return program;
 }
 
+template <typename T>
+std::string Reduce<T(T)>::vectorType()
+{
+  if (std::is_same<T, float>::value)        return "float4";
+  if (std::is_same<T, double>::value)       return "double4";
+  if (std::is_same<T, int>::value)          return "int4";
+  if (std::is_same<T, unsigned int>::value) return "uint4";
+  return std::string();
+}
+
 template <typename T>
 std::string Reduce<T(T)>::source() const
 {
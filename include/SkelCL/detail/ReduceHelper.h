@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ReduceHelper.h
+///
+/// \brief Work-group sizing, the final reduction pass and the combination
+///        of partial results of multiple devices shared by the Reduce,
+///        MapReduce and ZipReduce skeletons.
+///
+
+#ifndef REDUCE_HELPER_H_
+#define REDUCE_HELPER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DeviceBuffer.h"
+#include "skelclDll.h"
+
+namespace skelcl {
+
+namespace detail {
+
+class Device;
+class Program;
+
+namespace reduceHelper {
+
+///
+/// \brief Returns the work-group size used for the given kernel on device,
+///        i.e. workGroupSize limited by what the kernel supports.
+///
+SKELCL_DLL size_t localSize(const Program& program, const Device& device,
+                            const std::string& kernelName,
+                            size_t workGroupSize);
+
+///
+/// \brief Returns the number of work-groups for reducing items values:
+///        enough to keep every compute unit busy, but every work-group has
+///        to process at least one value.
+///
+SKELCL_DLL size_t numberOfGroups(const Device& device, size_t localSize,
+                                 size_t items);
+
+///
+/// \brief Combines the elements values stored in input into the first
+///        element of output with a single work-group, using the
+///        SCL_REDUCE_PARTIALS kernel of ReducePartialsKernel.cl.
+///
+SKELCL_DLL void reducePartials(const Program& program, const Device& device,
+                               const DeviceBuffer& input,
+                               const DeviceBuffer& output,
+                               size_t elements, size_t workGroupSize);
+
+///
+/// \brief Downloads the single partial result stored in each of the given
+///        buffers and uploads all of them into a new buffer on the target
+///        device, which is returned.
+///
+SKELCL_DLL DeviceBuffer
+  gatherPartials(const std::vector<DeviceBuffer>& partials,
+                 const std::shared_ptr<Device>& target);
+
+///
+/// \brief Combines the single partial results computed on multiple devices
+///        into the first element of output, on the device of output.
+///
+SKELCL_DLL void combineDevicePartials(const Program& program,
+                                      const std::vector<DeviceBuffer>& partials,
+                                      const DeviceBuffer& output,
+                                      size_t workGroupSize);
+
+} // namespace reduceHelper
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // REDUCE_HELPER_H_
@@ -41,90 +41,79 @@ R"(
 
 typedef float SCL_TYPE_0;
 
-#ifndef SCL_IDENTITY
-#define SCL_IDENTITY (0.0)
-#endif
-
-
-// ------------------------------------ Kernel 1 -----------------------------------------------
-
-__kernel void SCL_REDUCE_1 (
+// Every work-item sequentially combines the elements at its global id plus
+// multiples of the global size. If SCL_VECTOR_TYPE is defined the input is
+// read with 4-wide vector loads. Afterwards each work-group combines the
+// values of its work-items in a tree in local memory and writes one partial
+// result. The work-items holding values always form a prefix of the NDRange,
+// so no identity is required for padding.
+
+__kernel void SCL_REDUCE (
     const __global SCL_TYPE_0* SCL_IN,
           __global SCL_TYPE_0* SCL_OUT,
-    const unsigned int  DATA_SIZE,
-    const unsigned int  GLOBAL_SIZE) 
+          __local  SCL_TYPE_0* SCL_LOCAL, // has size of the work-group
+    const unsigned int         DATA_SIZE)
 {
-    const int my_pos = get_global_id(0);
-    if (my_pos > DATA_SIZE) return;
-        
-    const unsigned int modul = GLOBAL_SIZE;
-
-    SCL_TYPE_0 res = SCL_IN[my_pos];
-    int        i   = my_pos + modul;
-        
-    while ( i < DATA_SIZE )
-    {
-      res = SCL_FUNC( res, SCL_IN[i] );
-      i = i + modul;
+    const unsigned int gid   = get_global_id(0);
+    const unsigned int lid   = get_local_id(0);
+    const unsigned int lsize = get_local_size(0);
+    const unsigned int gsize = get_global_size(0);
+
+    SCL_TYPE_0 res;
+    unsigned int i = gid;
+
+#ifdef SCL_VECTOR_TYPE
+    const unsigned int vectors = DATA_SIZE / 4;
+    const unsigned int tail    = DATA_SIZE - vectors * 4;
+    const unsigned int items   = min( max(vectors, tail), gsize );
+
+    if (gid < vectors) {
+      SCL_VECTOR_TYPE v = vload4(gid, SCL_IN);
+      res = SCL_FUNC( SCL_FUNC(v.s0, v.s1), SCL_FUNC(v.s2, v.s3) );
+      for (i = gid + gsize; i < vectors; i += gsize) {
+        v   = vload4(i, SCL_IN);
+        res = SCL_FUNC( res,
+                        SCL_FUNC( SCL_FUNC(v.s0, v.s1), SCL_FUNC(v.s2, v.s3) ) );
+      }
     }
-    
-    SCL_OUT[my_pos] = res;
-}
-
-
-// ------------------------------------ Kernel 2 -----------------------------------------------
-
-
-__kernel void SCL_REDUCE_2 (
-    const __global SCL_TYPE_0* SCL_IN,
-          __global SCL_TYPE_0* SCL_OUT,
-          __local  SCL_TYPE_0* LOCAL_BUF, // has size LOCAL_SIZE
-          unsigned int         DATA_SIZE,
-    const unsigned int         LOCAL_SIZE)    
-{
-    const int my_pos  = get_global_id(0);
-    
-    int modul;
-    
-    
-    // preprocessing phase
-
-    modul = LOCAL_SIZE;
-
-    SCL_TYPE_0 res = SCL_IN[my_pos];
-    int        i   = my_pos + modul;
-        
-    while ( i < DATA_SIZE )
-    {
-      res = SCL_FUNC( res, SCL_IN[i] );
-      i   = i + modul;
+    // the remaining elements are combined by the first work-items
+    for (i = gid; i < tail; i += gsize) {
+      const SCL_TYPE_0 t = SCL_IN[vectors * 4 + i];
+      res = (gid < vectors || i != gid) ? SCL_FUNC(res, t) : t;
+    }
+#else
+    const unsigned int items = min(DATA_SIZE, gsize);
+
+    if (gid < DATA_SIZE) {
+      res = SCL_IN[gid];
+      for (i = gid + gsize; i < DATA_SIZE; i += gsize) {
+        res = SCL_FUNC( res, SCL_IN[i] );
+      }
     }
-      
-    LOCAL_BUF[my_pos] = res;
+#endif
+
+    SCL_LOCAL[lid] = res;
 
+    // number of work-items in this work-group holding a value
+    const unsigned int groupStart = get_group_id(0) * lsize;
+    unsigned int active = (items > groupStart)
+                        ? min(items - groupStart, lsize) : 0;
 
-    DATA_SIZE = min( LOCAL_SIZE, DATA_SIZE );
-    
-    
-    // less than LOCAL_SIZE elements remaining
+    if (active == 0) return; // whole work-group is idle
 
-    int active;
-    
-    while ( DATA_SIZE > 1)
-    {  
+    while (active > 1) {
       barrier(CLK_LOCAL_MEM_FENCE);
-      
-      modul  = ceil ( DATA_SIZE / 2.0f );
-      active = floor( DATA_SIZE / 2.0f );
-      
-      if ( my_pos < active )
-        LOCAL_BUF[my_pos] = SCL_FUNC( LOCAL_BUF[my_pos], LOCAL_BUF[ my_pos + modul ] );
-      
-      DATA_SIZE = ceil( DATA_SIZE / 2.0f);
-    }
 
-    SCL_OUT[0] = LOCAL_BUF[0];
+      const unsigned int half = (active + 1) / 2;
+      if (lid + half < active) {
+        SCL_LOCAL[lid] = SCL_FUNC( SCL_LOCAL[lid], SCL_LOCAL[lid + half] );
+      }
+      active = half;
+    }
 
+    if (lid == 0) {
+      SCL_OUT[get_group_id(0)] = SCL_LOCAL[0];
+    }
 }
-                                                  
+
 )"
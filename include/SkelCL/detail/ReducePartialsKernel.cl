@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ReducePartialsKernel.cl
+///
+/// \brief Work-group reduction shared by the MapReduce and ZipReduce
+///        kernels. The including program defines SCL_REDUCE_TYPE as the type
+///        of the reduced values, USR_REDUCE as the reduction function and
+///        SCL_IDENTITY as its identity.
+///
+
+R"(
+
+// Combines the values of all work-items of the work-group in a tree in local
+// memory and writes the result of the work-group to SCL_OUT.
+void SCL_WORK_GROUP_REDUCE(__local  SCL_REDUCE_TYPE* SCL_LOCAL,
+                           __global SCL_REDUCE_TYPE* SCL_OUT,
+                           const SCL_REDUCE_TYPE     value)
+{
+    const unsigned int lid   = get_local_id(0);
+    const unsigned int lsize = get_local_size(0);
+
+    SCL_LOCAL[lid] = value;
+
+    unsigned int active = lsize;
+    while (active > 1) {
+      barrier(CLK_LOCAL_MEM_FENCE);
+
+      const unsigned int half = (active + 1) / 2;
+      if (lid + half < active) {
+        SCL_LOCAL[lid] = USR_REDUCE( SCL_LOCAL[lid], SCL_LOCAL[lid + half] );
+      }
+      active = half;
+    }
+
+    if (lid == 0) {
+      SCL_OUT[get_group_id(0)] = SCL_LOCAL[0];
+    }
+}
+
+// A single work-group combines all partial results.
+__kernel void SCL_REDUCE_PARTIALS (
+    const __global SCL_REDUCE_TYPE* SCL_IN,
+          __global SCL_REDUCE_TYPE* SCL_OUT,
+          __local  SCL_REDUCE_TYPE* SCL_LOCAL, // has size of the work-group
+    const unsigned int              DATA_SIZE)
+{
+    const unsigned int gid   = get_global_id(0);
+    const unsigned int gsize = get_global_size(0);
+
+    // work-items without a partial result hold the identity, therefore an
+    // empty input yields the identity
+    SCL_REDUCE_TYPE res = SCL_IDENTITY;
+    for (unsigned int i = gid; i < DATA_SIZE; i += gsize) {
+      res = USR_REDUCE( res, SCL_IN[i] );
+    }
+
+    SCL_WORK_GROUP_REDUCE(SCL_LOCAL, SCL_OUT, res);
+}
+
+)"
@@ -0,0 +1,90 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ReduceSegmentsKernel.cl
+///
+/// \brief Segmented reduction used by Reduce::batch. The including program
+///        defines SCL_TYPE_0 as the type of the elements, SCL_FUNC as the
+///        reduction function and SCL_IDENTITY as its identity.
+///
+
+R"(
+
+typedef float SCL_TYPE_0;
+
+// Reduces every segment of SCL_IN, given by the table of offsets, with a
+// work-group of its own: segment i consists of the elements from
+// SCL_OFFSETS[i] to SCL_OFFSETS[i+1] and its result is written to SCL_OUT[i].
+// The result of an empty segment is the identity.
+__kernel void SCL_REDUCE_SEGMENTS (
+    const __global SCL_TYPE_0*   SCL_IN,
+          __global SCL_TYPE_0*   SCL_OUT,
+          __local  SCL_TYPE_0*   SCL_LOCAL, // has size of the work-group
+    const __global unsigned int* SCL_OFFSETS)
+{
+    const unsigned int segment = get_group_id(0);
+    const unsigned int lid     = get_local_id(0);
+    const unsigned int lsize   = get_local_size(0);
+    const unsigned int begin   = SCL_OFFSETS[segment];
+    const unsigned int end     = SCL_OFFSETS[segment + 1];
+
+    SCL_TYPE_0 res;
+    if (begin + lid < end) {
+      res = SCL_IN[begin + lid];
+      for (unsigned int i = begin + lid + lsize; i < end; i += lsize) {
+        res = SCL_FUNC( res, SCL_IN[i] );
+      }
+    }
+
+    SCL_LOCAL[lid] = res;
+
+    // the number of work-items holding a value is the same for the whole
+    // work-group, so that all of them reach the barriers
+    unsigned int active = min(end - begin, lsize);
+    while (active > 1) {
+      barrier(CLK_LOCAL_MEM_FENCE);
+
+      const unsigned int half = (active + 1) / 2;
+      if (lid + half < active) {
+        SCL_LOCAL[lid] = SCL_FUNC( SCL_LOCAL[lid], SCL_LOCAL[lid + half] );
+      }
+      active = half;
+    }
+
+    if (lid == 0) {
+      SCL_OUT[segment] = (end > begin) ? SCL_LOCAL[0] : SCL_IDENTITY;
+    }
+}
+
+)"
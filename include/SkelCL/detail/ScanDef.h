@@ -47,6 +47,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.h>
@@ -60,6 +61,8 @@
 #include "../Source.h"
 
 #include "Device.h"
+#include "DeviceBuffer.h"
+#include "Event.h"
 #include "KernelUtil.h"
 #include "Program.h"
 #include "Skeleton.h"
@@ -70,9 +73,12 @@ namespace skelcl {
 template<typename T>
 Scan<T(T)>::Scan(const Source& source,
                  const std::string& id,
-                 const std::string& funcName)
+                 const std::string& funcName,
+                 detail::ScanMode mode)
   : detail::Skeleton(),
-    _program(createAndBuildProgram(source, id, funcName))
+    _program(createAndBuildProgram(source, id, funcName)),
+    _mode(mode),
+    _tileStatus()
 {
   LOG_DEBUG_INFO("Create new Scan object (", this, ")");
 }
@@ -105,20 +111,170 @@ Vector<T>& Scan<T(T)>::operator()(Out<Vector<T>> output,
   return output.container();
 }
 
+template <typename T>
+template <typename... Args>
+Vector<T> Scan<T(T)>::segmented(const Vector<T>& input,
+                                const Vector<int>& flags,
+                                Args&&... args)
+{
+  Vector<T> output;
+  this->segmented(out(output), input, flags, std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename T>
+template <typename... Args>
+Vector<T>& Scan<T(T)>::segmented(Out<Vector<T>> output,
+                                 const Vector<T>& input,
+                                 const Vector<int>& flags,
+                                 Args&&... args)
+{
+  ASSERT( flags.size() == input.size() );
+
+  // segments may span the blocks of multiple devices, therefore the segmented
+  // scan is performed on a single device
+  if (!input.distribution().isValid()
+      || input.distribution().devices().size() != 1) {
+    input.setDistribution(detail::SingleDistribution<Vector<T>>());
+  }
+  prepareInput(input);
+
+  flags.setDistribution(input.distribution());
+  flags.createDeviceBuffers();
+  flags.startUpload();
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutput(output.container(), input);
+
+  executeSegmented(output.container(), input, flags,
+                   std::forward<Args>(args)...);
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
 template <typename T>
 template <typename... Args>
 void Scan<T(T)>::execute(Vector<T>& output,
                          const Vector<T>& input,
-                         Args&&... /*args*/)
+                         Args&&... args)
 {
   ASSERT( input.distribution().isValid() );
 
-  // TODO: relax to multiple devices later
-  ASSERT( input.distribution().devices().size() == 1 );
+  auto& devices = input.distribution().devices();
+  bool isCopy = (dynamic_cast<detail::CopyDistribution<Vector<T>>*>(
+                   &input.distribution()) != nullptr);
+
+  if (devices.size() == 1 || isCopy) {
+    auto& devicePtr = devices.front();
+    scanOnDevice(devicePtr, input.deviceBuffer(*devicePtr),
+                 output.deviceBuffer(*devicePtr), _mode, nullptr,
+                 std::forward<Args>(args)...);
+    LOG_DEBUG_INFO("Scan kernels started");
+    return;
+  }
+
+  // 1. every device scans its block and downloads the total of its block
+  std::vector<detail::Device::ptr_type> usedDevices;
+  std::vector<T> totals(devices.size());
+  detail::Event events;
+  for (auto& devicePtr : devices) {
+    auto& inputBuffer = input.deviceBuffer(*devicePtr);
+    if (inputBuffer.size() == 0) continue;
+
+    events.insert(scanOnDevice(devicePtr, inputBuffer,
+                               output.deviceBuffer(*devicePtr), _mode,
+                               &totals[usedDevices.size()],
+                               std::forward<Args>(args)...));
+    usedDevices.push_back(devicePtr);
+  }
+  events.wait();
+
+  // 2. exclusively scan the totals to obtain the offset of every block
+  auto& firstDevice = usedDevices.front();
+  std::vector<T> offsets(usedDevices.size());
+  {
+    detail::DeviceBuffer totalsBuffer(firstDevice, offsets.size(), sizeof(T));
+    detail::DeviceBuffer offsetsBuffer(firstDevice, offsets.size(), sizeof(T));
+    firstDevice->enqueueWrite(totalsBuffer, totals.begin());
+    scanOnDevice(firstDevice, totalsBuffer, offsetsBuffer,
+                 detail::ScanMode::EXCLUSIVE, nullptr,
+                 std::forward<Args>(args)...);
+    firstDevice->enqueueRead(offsetsBuffer, offsets.begin()).wait();
+  }
+
+  // 3. add the offsets to every block, but the first one
+  for (size_t i = 1; i < usedDevices.size(); ++i) {
+    auto& devicePtr = usedDevices[i];
+    addOffset(devicePtr, output.deviceBuffer(*devicePtr), offsets[i],
+              std::forward<Args>(args)...);
+  }
+
+  LOG_DEBUG_INFO("Scan kernels started on ", usedDevices.size(), " devices");
+}
+
+template <typename T>
+template <typename... Args>
+void Scan<T(T)>::executeSegmented(Vector<T>& output,
+                                  const Vector<T>& input,
+                                  const Vector<int>& flags,
+                                  Args&&... args)
+{
+  ASSERT( input.distribution().isValid() );
 
   auto& devicePtr     = input.distribution().devices().front();
   auto& inputBuffer   = input.deviceBuffer(*devicePtr);
+  auto& flagsBuffer   = flags.deviceBuffer(*devicePtr);
   auto& outputBuffer  = output.deviceBuffer(*devicePtr);
+  if (inputBuffer.size() == 0) return;
+
+  if (_mode == detail::ScanMode::INCLUSIVE) {
+    performSegmentedScan(devicePtr, inputBuffer, flagsBuffer, outputBuffer,
+                         std::forward<Args>(args)...);
+    LOG_DEBUG_INFO("Segmented scan kernels started");
+    return;
+  }
+
+  // the exclusive result is obtained by shifting the inclusive one
+  detail::DeviceBuffer inclusiveBuffer(devicePtr, inputBuffer.size(),
+                                       sizeof(T));
+  performSegmentedScan(devicePtr, inputBuffer, flagsBuffer, inclusiveBuffer,
+                       std::forward<Args>(args)...);
+  try {
+    cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_SEGMENTED_EXCLUSIVE"));
+    kernel.setArg(0, inclusiveBuffer.clBuffer());
+    kernel.setArg(1, flagsBuffer.clBuffer());
+    kernel.setArg(2, outputBuffer.clBuffer());
+    kernel.setArg(3, static_cast<cl_uint>(inputBuffer.size()));
+
+    cl_uint local  = static_cast<cl_uint>(
+                       std::min(this->workGroupSize(),
+                                devicePtr->maxWorkGroupSize()) );
+    cl_uint global = static_cast<cl_uint>(
+                       detail::util::ceilToMultipleOf(inputBuffer.size(),
+                                                      local) );
+    devicePtr->enqueue(kernel, cl::NDRange(global), cl::NDRange(local));
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+  LOG_DEBUG_INFO("Segmented scan kernels started");
+}
+
+template <typename T>
+template <typename... Args>
+cl::Event Scan<T(T)>::scanOnDevice(const detail::Device::ptr_type& devicePtr,
+                                   const detail::DeviceBuffer& inputBuffer,
+                                   const detail::DeviceBuffer& outputBuffer,
+                                   detail::ScanMode mode,
+                                   T* total,
+                                   Args&&... args)
+{
+  if (useSinglePass(*devicePtr)) {
+    return performSinglePassScan(devicePtr, inputBuffer, outputBuffer,
+                                 mode, total, std::forward<Args>(args)...);
+  }
 
   size_t elements = inputBuffer.size();
   size_t wgSize   = std::min(this->workGroupSize(),
@@ -131,13 +287,150 @@ void Scan<T(T)>::execute(Vector<T>& output,
 
   // perform scan for each pass
   performScanPasses(passes, wgSize, devicePtr,
-                    tmpBuffers, inputBuffer, outputBuffer);
+                    tmpBuffers, inputBuffer, outputBuffer, mode,
+                    std::forward<Args>(args)...);
 
   // perform uniform combination as last step
   performUniformCombination(passes, wgSize, devicePtr,
-                            tmpBuffers, outputBuffer);
+                            tmpBuffers, outputBuffer,
+                            std::forward<Args>(args)...);
 
-  LOG_DEBUG_INFO("Scan kernels started");
+  if (total == nullptr) {
+    return cl::Event();
+  }
+  // the last intermediate buffer holds the total of all elements
+  return devicePtr->enqueueRead(tmpBuffers.back(), total, 1, 0);
+}
+
+template <typename T>
+bool Scan<T(T)>::useSinglePass(const detail::Device& device) const
+{
+  // the look-back relies on all started work-groups making progress, which
+  // is only assumed for GPUs unless explicitly requested
+  auto env = detail::util::envVarValue("SKELCL_SCAN_SINGLE_PASS");
+  if (!env.empty()) {
+    return env != "0";
+  }
+  return device.isType(detail::Device::Type::GPU);
+}
+
+template <typename T>
+template <typename... Args>
+cl::Event
+  Scan<T(T)>::performSinglePassScan(const detail::Device::ptr_type& devicePtr,
+                                    const detail::DeviceBuffer& inputBuffer,
+                                    const detail::DeviceBuffer& outputBuffer,
+                                    detail::ScanMode mode,
+                                    T* total,
+                                    Args&&... args)
+{
+  size_t elements = inputBuffer.size();
+  if (elements == 0) {
+    return cl::Event();
+  }
+  size_t wgSize   = std::min(this->workGroupSize(),
+                             devicePtr->maxWorkGroupSize());
+  // every work-group scans a tile of wgSize elements
+  cl_uint tiles   = static_cast<cl_uint>( (elements + wgSize - 1) / wgSize );
+  cl_uint local   = static_cast<cl_uint>( wgSize / 2 );
+  cl_uint global  = tiles * local;
+
+  // (re)allocate the tile status buffers only if they are too small;
+  // the flags buffer holds one extra element used as tile counter
+  auto& status = _tileStatus[devicePtr->id()];
+  if (status.empty() || status[0].size() < tiles) {
+    status.clear();
+    status.emplace_back(devicePtr, tiles, sizeof(T));          // aggregates
+    status.emplace_back(devicePtr, tiles, sizeof(T));          // prefixes
+    status.emplace_back(devicePtr, tiles + 1, sizeof(cl_int)); // flags
+  }
+  auto& aggregates = status[0];
+  auto& prefixes   = status[1];
+  auto& flags      = status[2];
+
+  try {
+    cl::Kernel resetKernel(_program.kernel(*devicePtr,
+                                           "SCL_SCAN_RESET_STATUS"));
+    cl_uint count = tiles + 1;
+    resetKernel.setArg(0, flags.clBuffer());
+    resetKernel.setArg(1, count);
+
+    cl_uint resetLocal  = static_cast<cl_uint>(
+                            std::min(this->workGroupSize(),
+                                     devicePtr->maxWorkGroupSize()) );
+    cl_uint resetGlobal = static_cast<cl_uint>(
+                            detail::util::ceilToMultipleOf(count, resetLocal) );
+    devicePtr->enqueue(resetKernel,
+                       cl::NDRange(resetGlobal), cl::NDRange(resetLocal));
+
+    cl::Kernel scanKernel(_program.kernel(*devicePtr, "SCL_SCAN_SINGLE_PASS"));
+    scanKernel.setArg(0, inputBuffer.clBuffer());
+    scanKernel.setArg(1, outputBuffer.clBuffer());
+    scanKernel.setArg(2, cl::__local(sizeof(T) * wgSize));
+    scanKernel.setArg(3, aggregates.clBuffer());
+    scanKernel.setArg(4, prefixes.clBuffer());
+    scanKernel.setArg(5, flags.clBuffer());
+    scanKernel.setArg(6, static_cast<cl_uint>(elements));
+    scanKernel.setArg(7, tiles);
+    scanKernel.setArg(8, static_cast<cl_int>(
+                           mode == detail::ScanMode::INCLUSIVE));
+    detail::kernelUtil::setKernelArgs(scanKernel, *devicePtr, 9,
+                                      std::forward<Args>(args)...);
+
+    devicePtr->enqueue(scanKernel, cl::NDRange(global), cl::NDRange(local));
+    LOG_DEBUG_INFO("Perform single pass scan with ", tiles, " tiles");
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  if (total == nullptr) {
+    return cl::Event();
+  }
+  // the inclusive prefix of the last tile is the total of all elements
+  return devicePtr->enqueueRead(prefixes, total, 1, tiles - 1);
+}
+
+template <typename T>
+template <typename... Args>
+void Scan<T(T)>::addOffset(const detail::Device::ptr_type& devicePtr,
+                           const detail::DeviceBuffer& outputBuffer,
+                           const T& offset,
+                           Args&&... args)
+{
+  size_t wgSize   = std::min(this->workGroupSize(),
+                             devicePtr->maxWorkGroupSize());
+  cl_uint local   = static_cast<cl_uint>( wgSize / 2 );
+  cl_uint global  = static_cast<cl_uint>(
+                      detail::util::ceilToMultipleOf(
+                        (outputBuffer.size() + 1) / 2, local) );
+
+  // every work-group combines its elements with the same offset
+  std::vector<T> offsets(global / local, offset);
+  detail::DeviceBuffer offsetBuffer(devicePtr, offsets.size(), sizeof(T));
+  devicePtr->enqueueWrite(offsetBuffer, offsets.begin());
+
+  try {
+    cl::Kernel uniformCombinationKernel(
+        _program.kernel(*devicePtr, "SCL_UNIFORM_COMBINATION"));
+
+    uniformCombinationKernel.setArg(0, outputBuffer.clBuffer());
+    uniformCombinationKernel.setArg(1, offsetBuffer.clBuffer());
+    uniformCombinationKernel.setArg(2,
+        static_cast<cl_uint>(outputBuffer.size()));
+    detail::kernelUtil::setKernelArgs(uniformCombinationKernel, *devicePtr, 3,
+                                      std::forward<Args>(args)...);
+
+    auto keepAlive = offsetBuffer.clBuffer();
+    // offsets must stay alive until the upload has finished
+    auto keepOffsets = std::make_shared<std::vector<T>>(std::move(offsets));
+
+    devicePtr->enqueue(uniformCombinationKernel,
+                       cl::NDRange(global), cl::NDRange(local),
+                       cl::NullRange, // offset
+                       [keepAlive, keepOffsets] () {});
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
 }
 
 template <typename T>
@@ -174,6 +467,7 @@ std::vector<detail::DeviceBuffer>
 }
 
 template <typename T>
+template <typename... Args>
 void
   Scan<T(T)>::performScanPasses(size_t passes,
                                 size_t wgSize,
@@ -181,7 +475,9 @@ void
                                 const std::vector<detail::DeviceBuffer>&
                                   tmpBuffers,
                                 const detail::DeviceBuffer& inputBuffer,
-                                const detail::DeviceBuffer& outputBuffer)
+                                const detail::DeviceBuffer& outputBuffer,
+                                detail::ScanMode mode,
+                                Args&&... args)
 {
   try {
     cl::Kernel scanKernel(_program.kernel(*devicePtr, "SCL_SCAN"));
@@ -189,6 +485,9 @@ void
     // allocate shared memory
     scanKernel.setArg( 2, cl::__local(sizeof(T) * wgSize) );
 
+    detail::kernelUtil::setKernelArgs(scanKernel, *devicePtr, 6,
+                                      std::forward<Args>(args)...);
+
     auto* currentInput = &inputBuffer;
     auto* currentOutput = &outputBuffer;
     for (unsigned int i = 0; i < passes; i++) {
@@ -202,8 +501,10 @@ void
       scanKernel.setArg(1, currentOutput->clBuffer());
       scanKernel.setArg(3, currentTmp->clBuffer());
       scanKernel.setArg(4, static_cast<cl_uint>(currentTmp->size()));
-
-      // TODO: set additional kernel args
+      // only the first pass produces the final values, the block sums are
+      // always scanned exclusively
+      scanKernel.setArg(5, static_cast<cl_int>(
+                             i == 0 && mode == detail::ScanMode::INCLUSIVE));
 
       // launch kernel
       devicePtr->enqueue(scanKernel, cl::NDRange(global), cl::NDRange(local));
@@ -219,6 +520,7 @@ void
 }
 
 template<typename T>
+template <typename... Args>
 void
   Scan<T(T)>::performUniformCombination(size_t passes,
                                         size_t wgSize,
@@ -226,12 +528,14 @@ void
                                           devicePtr,
                                         const std::vector<detail::DeviceBuffer>&
                                           tmpBuffers,
-                                        const detail::DeviceBuffer& outputBuffer
-                                       )
+                                        const detail::DeviceBuffer& outputBuffer,
+                                        Args&&... args)
 {
   try {
     cl::Kernel uniformCombinationKernel(
         _program.kernel(*devicePtr, "SCL_UNIFORM_COMBINATION"));
+    detail::kernelUtil::setKernelArgs(uniformCombinationKernel, *devicePtr, 3,
+                                      std::forward<Args>(args)...);
     for (long i = passes - 2; i >= 0; i--) {
       auto* currentInput = &tmpBuffers[i];
       const detail::DeviceBuffer* currentOutput = nullptr;
@@ -258,6 +562,94 @@ void
   }
 }
 
+template<typename T>
+template <typename... Args>
+void
+  Scan<T(T)>::performSegmentedScan(const detail::Device::ptr_type& devicePtr,
+                                   const detail::DeviceBuffer& inputBuffer,
+                                   const detail::DeviceBuffer& flagsBuffer,
+                                   const detail::DeviceBuffer& outputBuffer,
+                                   Args&&... args)
+{
+  // every work-group scans one element per work-item
+  size_t wgSize = std::min(this->workGroupSize(),
+                           devicePtr->maxWorkGroupSize());
+  cl_uint local = static_cast<cl_uint>(wgSize);
+
+  // per level: inclusive scanned block aggregates, block flags and the index
+  // of the first segment head inside every block
+  struct Level {
+    size_t elements;
+    detail::DeviceBuffer sums;
+    detail::DeviceBuffer flags;
+    detail::DeviceBuffer heads;
+  };
+  std::vector<Level> levels;
+  size_t n = inputBuffer.size();
+  do {
+    size_t blocks = (n + wgSize - 1) / wgSize;
+    levels.push_back( Level{ n,
+      detail::DeviceBuffer(devicePtr, blocks, sizeof(T)),
+      detail::DeviceBuffer(devicePtr, blocks, sizeof(cl_int)),
+      detail::DeviceBuffer(devicePtr, blocks, sizeof(cl_int)) } );
+    n = blocks;
+  } while (n > 1);
+
+  try {
+    cl::Kernel scanKernel(_program.kernel(*devicePtr, "SCL_SEGMENTED_SCAN"));
+    scanKernel.setArg(3, cl::__local(2 * sizeof(T) * wgSize));
+    scanKernel.setArg(4, cl::__local(2 * sizeof(cl_int) * wgSize));
+    detail::kernelUtil::setKernelArgs(scanKernel, *devicePtr, 9,
+                                      std::forward<Args>(args)...);
+
+    // scan the blocks of every level, the aggregates of a level are the input
+    // of the next one
+    auto* currentInput  = &inputBuffer;
+    auto* currentFlags  = &flagsBuffer;
+    auto* currentOutput = &outputBuffer;
+    for (auto& level : levels) {
+      cl_uint global = static_cast<cl_uint>(
+                         detail::util::ceilToMultipleOf(level.elements, local) );
+      scanKernel.setArg(0, currentInput->clBuffer());
+      scanKernel.setArg(1, currentFlags->clBuffer());
+      scanKernel.setArg(2, currentOutput->clBuffer());
+      scanKernel.setArg(5, level.sums.clBuffer());
+      scanKernel.setArg(6, level.flags.clBuffer());
+      scanKernel.setArg(7, level.heads.clBuffer());
+      scanKernel.setArg(8, static_cast<cl_uint>(level.elements));
+
+      devicePtr->enqueue(scanKernel, cl::NDRange(global), cl::NDRange(local));
+
+      currentInput  = &level.sums;
+      currentFlags  = &level.flags;
+      currentOutput = &level.sums;
+    }
+
+    // carry the aggregates of the preceding blocks into every block up to the
+    // first segment head, starting at the top level
+    cl::Kernel combinationKernel(
+        _program.kernel(*devicePtr, "SCL_SEGMENTED_COMBINATION"));
+    detail::kernelUtil::setKernelArgs(combinationKernel, *devicePtr, 4,
+                                      std::forward<Args>(args)...);
+    for (long i = static_cast<long>(levels.size()) - 2; i >= 0; --i) {
+      auto& level = levels[i];
+      auto* currentOutput = (i > 0) ? &levels[i-1].sums : &outputBuffer;
+
+      cl_uint global = static_cast<cl_uint>(
+                         detail::util::ceilToMultipleOf(level.elements, local) );
+      combinationKernel.setArg(0, currentOutput->clBuffer());
+      combinationKernel.setArg(1, level.sums.clBuffer());
+      combinationKernel.setArg(2, level.heads.clBuffer());
+      combinationKernel.setArg(3, static_cast<cl_uint>(level.elements));
+
+      devicePtr->enqueue(combinationKernel,
+                         cl::NDRange(global), cl::NDRange(local));
+    }
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+}
+
 template<typename T>
 detail::Program
   Scan<T(T)>::createAndBuildProgram(const std::string& source,
@@ -284,6 +676,10 @@ detail::Program
   if (!program.loadBinary()) {
     // append parameters from user function to kernel
     program.transferParameters(funcName, 2, "SCL_SCAN");
+    program.transferParameters(funcName, 2, "SCL_SCAN_SINGLE_PASS");
+    program.transferParameters(funcName, 2, "SCL_UNIFORM_COMBINATION");
+    program.transferParameters(funcName, 2, "SCL_SEGMENTED_SCAN");
+    program.transferParameters(funcName, 2, "SCL_SEGMENTED_COMBINATION");
     program.transferArguments(funcName, 2, "SCL_FUNC");
     // rename user function
     program.renameFunction(funcName, "SCL_FUNC");
@@ -301,7 +697,7 @@ void Scan<T(T)>::prepareInput(const Vector<T>& input)
 {
   // set default distribution if required
   if (!input.distribution().isValid()) {
-    input.setDistribution(detail::SingleDistribution<Vector<T>>());
+    input.setDistribution(detail::BlockDistribution<Vector<T>>());
   }
   // create buffers if required
   input.createDeviceBuffers();
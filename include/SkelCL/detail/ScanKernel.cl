@@ -76,7 +76,8 @@ void SCL_SCAN(__global const SCL_TYPE_0* currentInput,
               __global       SCL_TYPE_0* output,
               __local        SCL_TYPE_0* localBuffer,
               __global       SCL_TYPE_0* blockSums,
-                       const uint        blockSumsSize)
+                       const uint        blockSumsSize,
+                       const int         inclusive)
 {
   const uint gid = get_global_id(0);
   const uint tid = get_local_id(0);
@@ -186,11 +187,16 @@ void SCL_SCAN(__global const SCL_TYPE_0* currentInput,
   output[gai] = (gai < blockSumsSize) * localBuffer[ai + bankOffsetA];
   output[gbi] = (gbi < blockSumsSize) * localBuffer[bi + bankOffsetB];
 #else
+  // for an inclusive scan every element is combined with its own value
   if (gid2_0 < blockSumsSize) {
-    output[gid2_0] = localBuffer[tid2_0];
+    output[gid2_0] = inclusive
+                   ? SCL_FUNC(localBuffer[tid2_0], currentInput[gid2_0])
+                   : localBuffer[tid2_0];
   }
   if (gid2_1 < blockSumsSize) {
-    output[gid2_1] = localBuffer[tid2_1];
+    output[gid2_1] = inclusive
+                   ? SCL_FUNC(localBuffer[tid2_1], currentInput[gid2_1])
+                   : localBuffer[tid2_1];
   }
 #endif
 }
@@ -233,21 +239,273 @@ __kernel void SCL_UNIFORM_COMBINATION(__global       SCL_TYPE_0* output,
 #ifdef SUPPORT_AVOID_BANK_CONFLICT
   unsigned int address = blockId * get_local_size(0) * 2 + get_local_id(0); 
 
-  output[address] = SCL_FUNC(output[address], localBuffer[0]);
+  output[address] = SCL_FUNC(localBuffer[0], output[address]);
   output[address + get_local_size(0)]
-      = SCL_FUNC( output[address + get_local_size(0)],
-                   (get_local_id(0) + get_local_size(0) < outputSize)
-                   * localBuffer[0] );
+      = SCL_FUNC( (get_local_id(0) + get_local_size(0) < outputSize)
+                   * localBuffer[0],
+                   output[address + get_local_size(0)] );
 #else
+  // the prefix of the block is the left operand, as func might not commute
   if (gid < outputSize) {
-    output[gid] = SCL_FUNC(output[gid], localBuffer[0]);
+    output[gid] = SCL_FUNC(localBuffer[0], output[gid]);
   }
   gid++;
   if (gid < outputSize) {
-    output[gid] = SCL_FUNC(output[gid], localBuffer[0]);
+    output[gid] = SCL_FUNC(localBuffer[0], output[gid]);
   }
 #endif
 }
 
-)"
+//------------------------------------------------------------
+// kernel__SinglePassScan
+//
+// Purpose :
+// Exclusive scan in a single pass using decoupled look-back. Every work-group
+// dynamically obtains a tile, publishes the aggregate of its tile and then
+// inspects the status flags of its predecessors until an inclusive prefix is
+// found. Uses the 32 bit atomics on global memory of OpenCL 1.1.
+//------------------------------------------------------------
+
+#define SCL_STATUS_INVALID   0
+#define SCL_STATUS_AGGREGATE 1
+#define SCL_STATUS_PREFIX    2
+
+__kernel void SCL_SCAN_RESET_STATUS(__global int*  flags,
+                                    const    uint  count)
+{
+  const uint gid = get_global_id(0);
+  if (gid < count) {
+    flags[gid] = SCL_STATUS_INVALID;
+  }
+}
+
+__kernel
+void SCL_SCAN_SINGLE_PASS(__global const   SCL_TYPE_0* input,
+                          __global         SCL_TYPE_0* output,
+                          __local          SCL_TYPE_0* localBuffer,
+                          volatile __global SCL_TYPE_0* aggregates,
+                          volatile __global SCL_TYPE_0* prefixes,
+                          volatile __global int*        flags,
+                          const uint                    elements,
+                          const uint                    tiles,
+                          const int                     inclusive)
+{
+  const uint tid = get_local_id(0);
+  const uint lwz = get_local_size(0);
+
+  const uint localBufferSize = lwz << 1;
+  int offset = 1;
+
+  const int tid2_0 = tid << 1;
+  const int tid2_1 = tid2_0 + 1;
+
+  // tiles are handed out in the order work-groups start, so every predecessor
+  // of a tile is guaranteed to make progress
+  __local uint tileId;
+  if (tid < 1) {
+    tileId = atomic_inc(&flags[tiles]);
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+  const uint tile = tileId;
+
+  const uint gid2_0 = tile * localBufferSize + tid2_0;
+  const uint gid2_1 = gid2_0 + 1;
+
+  // Cache the data in local memory
+  localBuffer[tid2_0] = (gid2_0 < elements) ? input[gid2_0] : SCL_IDENTITY;
+  localBuffer[tid2_1] = (gid2_1 < elements) ? input[gid2_1] : SCL_IDENTITY;
+
+  // bottom-up (a.k.a. up-sweep phase)
+  for(uint d = lwz; d > 0; d >>= 1) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (tid < d) {
+      const uint ai = mad24(offset, (tid2_1+0), -1);
+      const uint bi = mad24(offset, (tid2_1+1), -1);
+
+      localBuffer[bi] = SCL_FUNC( localBuffer[bi], localBuffer[ai] );
+    }
+    offset <<= 1;
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (tid < 1) {
+    const SCL_TYPE_0 aggregate = localBuffer[localBufferSize-1];
+    SCL_TYPE_0 exclusive = SCL_IDENTITY;
+
+    if (tile == 0) {
+      prefixes[0] = aggregate;
+      write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+      atomic_xchg(&flags[0], SCL_STATUS_PREFIX);
+    } else {
+      aggregates[tile] = aggregate;
+      write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+      atomic_xchg(&flags[tile], SCL_STATUS_AGGREGATE);
+
+      // look back until a predecessor with an inclusive prefix is found
+      int predecessor = tile - 1;
+      for (;;) {
+        const int flag = atomic_add(&flags[predecessor], 0);
+        if (flag == SCL_STATUS_INVALID) {
+          continue;
+        }
+        read_mem_fence(CLK_GLOBAL_MEM_FENCE);
+        if (flag == SCL_STATUS_PREFIX) {
+          exclusive = SCL_FUNC(prefixes[predecessor], exclusive);
+          break;
+        }
+        exclusive = SCL_FUNC(aggregates[predecessor], exclusive);
+        --predecessor;
+      }
+
+      prefixes[tile] = SCL_FUNC(exclusive, aggregate);
+      write_mem_fence(CLK_GLOBAL_MEM_FENCE);
+      atomic_xchg(&flags[tile], SCL_STATUS_PREFIX);
+    }
+
+    // seed the down-sweep with the prefix of all preceding tiles
+    localBuffer[localBufferSize - 1] = exclusive;
+  }
+
+  // top-down (a.k.a. down-sweep phase)
+  for(uint d = 1; d < localBufferSize; d <<= 1) {
+    offset >>= 1;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (tid < d) {
+      const uint ai = mad24(offset, (tid2_1+0), -1);
+      const uint bi = mad24(offset, (tid2_1+1), -1);
+
+      SCL_TYPE_0 tmp = localBuffer[ai];
+      localBuffer[ai] = localBuffer[bi];
+      localBuffer[bi] = SCL_FUNC(localBuffer[bi], tmp);
+    }
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (gid2_0 < elements) {
+    output[gid2_0] = inclusive ? SCL_FUNC(localBuffer[tid2_0], input[gid2_0])
+                               : localBuffer[tid2_0];
+  }
+  if (gid2_1 < elements) {
+    output[gid2_1] = inclusive ? SCL_FUNC(localBuffer[tid2_1], input[gid2_1])
+                               : localBuffer[tid2_1];
+  }
+}
+
+//------------------------------------------------------------
+// kernel__SegmentedScan
+//
+// Purpose :
+// Inclusive scan of (flag, value) pairs inside a block, where a set flag
+// restarts the scan. Every block stores its aggregate, whether it contains a
+// segment head and the index of its first segment head, so that the blocks can
+// be combined afterwards.
+//------------------------------------------------------------
+
+__kernel
+void SCL_SEGMENTED_SCAN(__global const SCL_TYPE_0* input,
+                        __global const int*        flags,
+                        __global       SCL_TYPE_0* output,
+                        __local        SCL_TYPE_0* localValues,
+                        __local        int*        localFlags,
+                        __global       SCL_TYPE_0* blockSums,
+                        __global       int*        blockFlags,
+                        __global       int*        blockHeads,
+                                 const uint        elements)
+{
+  const uint gid = get_global_id(0);
+  const uint tid = get_local_id(0);
+  const uint bid = get_group_id(0);
+  const uint lwz = get_local_size(0);
+
+  // double buffered Hillis-Steele scan
+  uint pout = 0;
+  uint pin  = 1;
+
+  localValues[tid] = (gid < elements) ? input[gid] : SCL_IDENTITY;
+  localFlags[tid]  = (gid < elements) ? (flags[gid] != 0) : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (uint offset = 1; offset < lwz; offset <<= 1) {
+    pout = 1 - pout;
+    pin  = 1 - pout;
+
+    SCL_TYPE_0 value = localValues[pin * lwz + tid];
+    int        flag  = localFlags[pin * lwz + tid];
+    if (tid >= offset) {
+      if (!flag) {
+        value = SCL_FUNC(localValues[pin * lwz + tid - offset], value);
+      }
+      flag |= localFlags[pin * lwz + tid - offset];
+    }
+    localValues[pout * lwz + tid] = value;
+    localFlags[pout * lwz + tid]  = flag;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  const SCL_TYPE_0 value = localValues[pout * lwz + tid];
+  const int        flag  = localFlags[pout * lwz + tid];
+
+  if (gid < elements) {
+    output[gid] = value;
+  }
+  if (tid == lwz - 1) {
+    blockSums[bid]  = value;
+    blockFlags[bid] = flag;
+    if (!flag) {
+      blockHeads[bid] = lwz;
+    }
+  }
+  // exactly one work-item sees the first segment head of the block
+  if (flag && (tid == 0 || !localFlags[pout * lwz + tid - 1])) {
+    blockHeads[bid] = tid;
+  }
+}
+
+//------------------------------------------------------------
+// kernel__SegmentedCombination
+//
+// Purpose :
+// Combine the elements of every block in front of its first segment head with
+// the scanned aggregate of the preceding blocks.
+//------------------------------------------------------------
 
+__kernel
+void SCL_SEGMENTED_COMBINATION(__global       SCL_TYPE_0* output,
+                               __global const SCL_TYPE_0* blockSums,
+                               __global const int*        blockHeads,
+                                        const uint        outputSize)
+{
+  const uint gid = get_global_id(0);
+  const uint tid = get_local_id(0);
+  const uint bid = get_group_id(0);
+
+  if (bid > 0 && gid < outputSize && tid < blockHeads[bid]) {
+    output[gid] = SCL_FUNC(blockSums[bid - 1], output[gid]);
+  }
+}
+
+//------------------------------------------------------------
+// kernel__SegmentedExclusive
+//
+// Purpose :
+// Derive the exclusive segmented scan from the inclusive one.
+//------------------------------------------------------------
+
+__kernel
+void SCL_SEGMENTED_EXCLUSIVE(__global const SCL_TYPE_0* inclusive,
+                             __global const int*        flags,
+                             __global       SCL_TYPE_0* output,
+                                      const uint        outputSize)
+{
+  const uint gid = get_global_id(0);
+
+  if (gid < outputSize) {
+    output[gid] = (gid == 0 || flags[gid]) ? SCL_IDENTITY : inclusive[gid - 1];
+  }
+}
+
+)"
@@ -87,7 +87,7 @@ void SingleDistribution<C<T>>::startUpload(C<T>& container,
   auto& buffer = container.deviceBuffer(device);
 
   auto event = device.enqueueWrite(buffer,
-                                   container.hostBuffer().begin());
+                                   container.hostData());
 
   events->insert(event);
 }
@@ -103,7 +103,7 @@ void SingleDistribution<C<T>>::startDownload(C<T>& container,
   auto& buffer = container.deviceBuffer(device);
 
   auto event = device.enqueueRead(buffer,
-                                  container.hostBuffer().begin());
+                                  container.hostData());
 
   events->insert(event);
 }
@@ -78,6 +78,14 @@ protected:
   template <typename T, template <typename> class C, typename... Args>
   void prepareAdditionalInput(C<T>& container, Args&&... args) const;
 
+  template <typename... Fields, typename... Args>
+  void prepareAdditionalInput(Out<SoAVector<Fields...>> outContainer,
+                              Args&&... args) const;
+
+  template <typename... Fields, typename... Args>
+  void prepareAdditionalInput(SoAVector<Fields...>& container,
+                              Args&&... args) const;
+
   template <typename T, typename... Args>
   void prepareAdditionalInput(T t, Args&&... args) const;
 
@@ -89,6 +97,10 @@ protected:
   template <typename T, template <typename> class C, typename... Args>
   void updateModifiedStatus(Out<C<T>> outVector, Args&&... args) const;
 
+  template <typename... Fields, typename... Args>
+  void updateModifiedStatus(Out<SoAVector<Fields...>> outContainer,
+                            Args&&... args) const;
+
   template <typename T, typename... Args>
   void updateModifiedStatus(T&& t, Args&&... args) const;
 
@@ -119,6 +131,31 @@ void Skeleton::prepareAdditionalInput(C<T>& container,
   prepareAdditionalInput( std::forward<Args>(args)... );
 }
 
+template <typename... Fields, typename... Args>
+void Skeleton::prepareAdditionalInput(Out<SoAVector<Fields...>> outContainer,
+                                      Args&&... args) const
+{
+  prepareAdditionalInput(outContainer.container(), std::forward<Args>(args)...);
+}
+
+template <typename... Fields, typename... Args>
+void Skeleton::prepareAdditionalInput(SoAVector<Fields...>& container,
+                                      Args&&... args) const
+{
+  // set default distribution for all fields if required
+  if (!container.isDistributionValid()) {
+    container.setDistribution(
+      CopyDistribution<
+        Vector<typename SoAVector<Fields...>::template field_type<0>::type>>());
+  }
+  // create buffers if required
+  container.createDeviceBuffers();
+  // copy data to devices
+  container.startUpload();
+
+  prepareAdditionalInput( std::forward<Args>(args)... );
+}
+
 template <typename T, typename... Args>
 void Skeleton::prepareAdditionalInput(T /*t*/, Args&&... args) const
 {
@@ -134,6 +171,14 @@ void Skeleton::updateModifiedStatus(Out<C<T>> outContainer,
   updateModifiedStatus( std::forward<Args>(args)... );
 }
 
+template <typename... Fields, typename... Args>
+void Skeleton::updateModifiedStatus(Out<SoAVector<Fields...>> outContainer,
+                                    Args&&... args) const
+{
+  outContainer.container().dataOnDeviceModified();
+  updateModifiedStatus( std::forward<Args>(args)... );
+}
+
 template <typename T, typename... Args>
 void Skeleton::updateModifiedStatus(T&& /*t*/, Args&&... args) const
 {
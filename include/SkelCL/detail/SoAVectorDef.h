@@ -0,0 +1,313 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file SoAVectorDef.h
+///
+
+#ifndef SOA_VECTOR_DEF_H_
+#define SOA_VECTOR_DEF_H_
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "Device.h"
+#include "Distribution.h"
+
+namespace skelcl {
+
+/// \cond
+/// Don't show detail namespace in doxygen
+namespace detail {
+
+namespace soa {
+
+// applies f to every element of the tuple t
+template <size_t I, size_t N>
+struct ForEachField {
+  template <typename Tuple, typename F>
+  static void apply(Tuple& t, F& f)
+  {
+    f(std::get<I>(t));
+    ForEachField<I + 1, N>::apply(t, f);
+  }
+};
+
+template <size_t N>
+struct ForEachField<N, N> {
+  template <typename Tuple, typename F>
+  static void apply(Tuple& /*t*/, F& /*f*/)
+  {
+  }
+};
+
+template <typename Tuple, typename F>
+void forEachField(Tuple& t, F f)
+{
+  ForEachField<0, std::tuple_size<
+                    typename std::remove_const<Tuple>::type>::value
+              >::apply(t, f);
+}
+
+struct Resize {
+  size_t size;
+  template <typename V> void operator()(V& v) const { v.resize(size); }
+};
+
+struct CheckSize {
+  size_t size;
+  template <typename V> void operator()(V& v) const
+  {
+    ASSERT_MESSAGE(v.size() == size, "All fields must have the same size");
+    (void)v;
+  }
+};
+
+struct IsDistributionValid {
+  bool& valid;
+  template <typename V> void operator()(V& v) const
+  {
+    valid = valid && v.distribution().isValid();
+  }
+};
+
+template <typename D>
+struct SetDistribution {
+  const D& distribution;
+  template <typename V> void operator()(V& v) const
+  {
+    v.setDistribution(distribution);
+  }
+};
+
+struct CreateDeviceBuffers {
+  template <typename V> void operator()(V& v) const { v.createDeviceBuffers(); }
+};
+
+struct StartUpload {
+  template <typename V> void operator()(V& v) const { v.startUpload(); }
+};
+
+struct CopyDataToDevices {
+  template <typename V> void operator()(V& v) const { v.copyDataToDevices(); }
+};
+
+struct CopyDataToHost {
+  template <typename V> void operator()(V& v) const { v.copyDataToHost(); }
+};
+
+struct DataOnDeviceModified {
+  template <typename V> void operator()(V& v) const
+  {
+    v.dataOnDeviceModified();
+  }
+};
+
+struct DataOnHostModified {
+  template <typename V> void operator()(V& v) const { v.dataOnHostModified(); }
+};
+
+struct CollectBuffers {
+  const Device& device;
+  std::vector<cl::Buffer>& buffers;
+  template <typename V> void operator()(V& v) const
+  {
+    buffers.push_back(v.deviceBuffer(device).clBuffer());
+  }
+};
+
+} // namespace soa
+
+} // namespace detail
+/// \endcond
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector()
+  : _fields()
+{
+  LOG_DEBUG_INFO("Created new SoAVector object (", this, ") with ",
+                 sizeof...(Fields), " fields");
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(const size_type size)
+  : _fields(Vector<Fields>(size)...)
+{
+  LOG_DEBUG_INFO("Created new SoAVector object (", this, ") with ",
+                 sizeof...(Fields), " fields and size ", size);
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(Vector<Fields>&&... fields)
+  : _fields(std::move(fields)...)
+{
+  detail::soa::forEachField(_fields, detail::soa::CheckSize{ size() });
+  LOG_DEBUG_INFO("Created new SoAVector object (", this, ") with ",
+                 sizeof...(Fields), " fields and size ", size());
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(SoAVector<Fields...>&& rhs)
+  : _fields(std::move(rhs._fields))
+{
+}
+
+template <typename... Fields>
+SoAVector<Fields...>&
+  SoAVector<Fields...>::operator=(SoAVector<Fields...>&& rhs)
+{
+  _fields = std::move(rhs._fields);
+  return *this;
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::size_type SoAVector<Fields...>::size() const
+{
+  return std::get<0>(_fields).size();
+}
+
+template <typename... Fields>
+bool SoAVector<Fields...>::empty() const
+{
+  return std::get<0>(_fields).empty();
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::resize(size_type size)
+{
+  detail::soa::forEachField(_fields, detail::soa::Resize{ size });
+}
+
+template <typename... Fields>
+template <size_t I>
+Vector<typename SoAVector<Fields...>::template field_type<I>::type>&
+  SoAVector<Fields...>::field()
+{
+  return std::get<I>(_fields);
+}
+
+template <typename... Fields>
+template <size_t I>
+const Vector<typename SoAVector<Fields...>::template field_type<I>::type>&
+  SoAVector<Fields...>::field() const
+{
+  return std::get<I>(_fields);
+}
+
+template <typename... Fields>
+template <size_t I>
+typename SoAVector<Fields...>::template field_type<I>::type&
+  SoAVector<Fields...>::get(size_type n)
+{
+  return std::get<I>(_fields)[n];
+}
+
+template <typename... Fields>
+template <size_t I>
+const typename SoAVector<Fields...>::template field_type<I>::type&
+  SoAVector<Fields...>::get(size_type n) const
+{
+  return std::get<I>(_fields)[n];
+}
+
+template <typename... Fields>
+bool SoAVector<Fields...>::isDistributionValid() const
+{
+  bool valid = true;
+  detail::soa::forEachField(_fields, detail::soa::IsDistributionValid{ valid });
+  return valid;
+}
+
+template <typename... Fields>
+template <typename U>
+void SoAVector<Fields...>::setDistribution(
+        const detail::Distribution<Vector<U>>& distribution) const
+{
+  detail::soa::forEachField(_fields,
+    detail::soa::SetDistribution<detail::Distribution<Vector<U>>>{
+      distribution });
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::createDeviceBuffers() const
+{
+  detail::soa::forEachField(_fields, detail::soa::CreateDeviceBuffers());
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::startUpload() const
+{
+  detail::soa::forEachField(_fields, detail::soa::StartUpload());
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::copyDataToDevices() const
+{
+  detail::soa::forEachField(_fields, detail::soa::CopyDataToDevices());
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::copyDataToHost() const
+{
+  detail::soa::forEachField(_fields, detail::soa::CopyDataToHost());
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::dataOnDeviceModified() const
+{
+  detail::soa::forEachField(_fields, detail::soa::DataOnDeviceModified());
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::dataOnHostModified() const
+{
+  detail::soa::forEachField(_fields, detail::soa::DataOnHostModified());
+}
+
+template <typename... Fields>
+std::vector<cl::Buffer>
+  SoAVector<Fields...>::clBuffers(const detail::Device& device) const
+{
+  std::vector<cl::Buffer> buffers;
+  detail::soa::forEachField(_fields,
+                            detail::soa::CollectBuffers{ device, buffers });
+  return buffers;
+}
+
+} // namespace skelcl
+
+#endif // SOA_VECTOR_DEF_H_
@@ -0,0 +1,170 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file Streaming.h
+///
+/// \brief Helpers for processing containers which do not fit into the memory
+///        of the devices. The elements are split into chunks, which are
+///        streamed through two buffer sets (slots) per device, so that the
+///        upload of the next chunk overlaps with the kernel processing the
+///        current one.
+///
+
+#ifndef STREAMING_H_
+#define STREAMING_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include "Device.h"
+#include "DeviceBuffer.h"
+#include "skelclDll.h"
+
+namespace skelcl {
+
+template <typename> class Matrix;
+template <typename> class Vector;
+
+namespace detail {
+
+namespace streaming {
+
+typedef VECTOR_CLASS<cl::Event> Events;
+
+///
+/// \brief A consecutive range of elements processed at once on one device.
+///
+struct Chunk {
+  std::shared_ptr<Device> devicePtr;
+  size_t index;  // position of the chunk in the sequence of all chunks
+  size_t offset; // offset of the first element (in elements)
+  size_t size;   // number of elements
+  size_t slot;   // buffer set used on the device (0 or 1)
+};
+
+///
+/// \brief Returns the number of elements processed in one chunk on the given
+///        device.
+///
+/// Two chunks (one per slot) have to fit into half of the global memory and
+/// every buffer has to fit into a single allocation. The size can be
+/// overwritten by setting the environment variable SKELCL_CHUNK_SIZE to the
+/// number of elements.
+///
+/// \param device          The device processing the chunks
+/// \param bytesPerElement Sum of the element sizes of all buffers needed to
+///                        process one element, e.g. sizeof(Tin)+sizeof(Tout)
+///
+SKELCL_DLL size_t chunkSize(const Device& device, size_t bytesPerElement);
+
+///
+/// \brief Returns true if the given number of elements does not fit into the
+///        memory of the devices and has, therefore, to be streamed.
+///
+/// If SKELCL_CHUNK_SIZE is set, streaming is required for every container
+/// larger than one chunk.
+///
+SKELCL_DLL bool isRequired(size_t elements, size_t bytesPerElement);
+
+///
+/// \brief Splits the elements into chunks assigned round robin to all devices
+///        and processes them.
+///
+/// For every chunk upload, compute and download are invoked with the events
+/// the enqueued operations have to wait for. Uploads and downloads should be
+/// enqueued on the transfer queue of the device
+/// (Device::enqueueTransferWrite() / Device::enqueueTransferRead()). The
+/// upload of the next chunk is enqueued before the download of the current
+/// one, so that it overlaps with the current kernel. This function blocks
+/// until all downloads are finished.
+///
+SKELCL_DLL void process(size_t elements, size_t bytesPerElement,
+      const std::function<Events(const Chunk&, const Events&)>& upload,
+      const std::function<cl::Event(const Chunk&, const Events&)>& compute,
+      const std::function<cl::Event(const Chunk&, const Events&)>& download);
+
+///
+/// \brief Buffers for one operand of a streamed skeleton, one per device and
+///        slot. The buffers are created on first use.
+///
+class SKELCL_DLL Buffers {
+public:
+  ///
+  /// \param elemSize        Size of one element stored in the buffers
+  /// \param bytesPerElement Passed to chunkSize() to determine the size of
+  ///                        the buffers in elements
+  ///
+  Buffers(size_t elemSize, size_t bytesPerElement);
+
+  ///
+  /// \param elemSize Size of one element stored in the buffers
+  /// \param size     Fixed size of the buffers in elements
+  ///
+  static Buffers withFixedSize(size_t elemSize, size_t size);
+
+  DeviceBuffer& operator[](const Chunk& chunk);
+
+private:
+  size_t                                  _elemSize;
+  size_t                                  _bytesPerElement;
+  size_t                                  _fixedSize;
+  std::map<std::pair<Device::id_type, size_t>,
+           DeviceBuffer>                  _buffers;
+};
+
+template <typename T>
+size_t elementCount(const Vector<T>& vector)
+{
+  return vector.size();
+}
+
+template <typename T>
+size_t elementCount(const Matrix<T>& matrix)
+{
+  return matrix.size().elemCount();
+}
+
+} // namespace streaming
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // STREAMING_H_
@@ -0,0 +1,158 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file Tuning.h
+///
+/// \brief Helpers for selecting kernel parameters at runtime. Skeletons
+///        benchmark candidate configurations on the first call for a device
+///        and a class of input shapes and persist the fastest one, so that
+///        later runs reuse it without benchmarking again.
+///
+/// Tuning is only performed if the environment variable SKELCL_AUTOTUNE is
+/// set to a value different from 0. The results are stored in the file
+/// .skelcl-tuning in the working directory (like the cached program
+/// binaries), or in the file given by SKELCL_TUNING_FILE.
+///
+
+#ifndef TUNING_H_
+#define TUNING_H_
+
+#include <string>
+#include <vector>
+
+#include "skelclDll.h"
+
+namespace skelcl {
+
+namespace detail {
+
+class Device;
+
+namespace tuning {
+
+///
+/// \brief Kernel variant and tile parameters of the AllPairs skeleton.
+///
+struct SKELCL_DLL AllPairsConfig {
+  ///
+  /// \brief The kernel variants, corresponding to AllPairsKernel.cl,
+  ///        AllPairsKernel2.cl, AllPairsKernel3.cl and AllPairsGemmKernel.cl.
+  ///
+  enum Kernel {
+    TILED   = 1, // C x R work-groups, S sub tiles, segments of length D
+    GENERIC = 2, // C x R work-groups calling the user function
+    SQUARE  = 3, // C x C work-groups with square tiles
+    GEMM    = 4  // C x R output tiles, segments of length D, every work-item
+                 // computes S rows of W adjacent columns
+  };
+
+  AllPairsConfig(unsigned int kernel = TILED, unsigned int C = 32,
+                 unsigned int R = 8, unsigned int S = 16, unsigned int D = 32,
+                 unsigned int W = 1);
+
+  ///
+  /// \brief Returns the size of the work-groups launching the kernel.
+  ///
+  unsigned int workGroupSize(size_t dim) const;
+
+  ///
+  /// \brief Returns the number of bytes of local memory required by the
+  ///        kernel with elements of the given sizes.
+  ///
+  size_t localMemSize(size_t leftElemSize, size_t rightElemSize) const;
+
+  std::string toString() const;
+
+  static bool fromString(const std::string& string, AllPairsConfig& config);
+
+  unsigned int kernel;
+  unsigned int C;
+  unsigned int R;
+  unsigned int S;
+  unsigned int D;
+  unsigned int W;
+};
+
+///
+/// \brief Returns the candidate configurations for the given device which
+///        satisfy its work-group size and local memory limits.
+///
+/// \param device  The device the configurations are benchmarked on
+/// \param kernel  GENERIC for the AllPairs skeleton customized with a user
+///                function, GEMM for a matrix multiplication and TILED for
+///                all other Zip and Reduce customizations. SQUARE kernels are
+///                included in the TILED candidates.
+///
+SKELCL_DLL std::vector<AllPairsConfig>
+  allPairsCandidates(const Device& device, AllPairsConfig::Kernel kernel,
+                     size_t leftElemSize, size_t rightElemSize);
+
+///
+/// \brief Returns true if tuning is enabled by SKELCL_AUTOTUNE.
+///
+SKELCL_DLL bool isEnabled();
+
+///
+/// \brief Returns a string identifying the class of the given extents. Every
+///        extent is classified by its logarithm to the base of four, so
+///        shapes of similar size share their tuning results.
+///
+SKELCL_DLL std::string shapeClass(const std::vector<size_t>& extents);
+
+///
+/// \brief Returns the key used to store the tuning result of the skeleton
+///        identified by id (e.g. a hash of its source) on the given device.
+///
+SKELCL_DLL std::string key(const Device& device, const std::string& id,
+                           const std::string& shapeClass);
+
+///
+/// \brief Looks up a stored tuning result.
+///
+/// \return True if a result for key has been found and stored in value.
+///
+SKELCL_DLL bool lookup(const std::string& key, std::string& value);
+
+///
+/// \brief Stores a tuning result and appends it to the tuning file.
+///
+SKELCL_DLL void store(const std::string& key, const std::string& value);
+
+} // namespace tuning
+
+} // namespace detail
+
+} // namespace skelcl
+
+#endif // TUNING_H_
@@ -78,6 +78,17 @@ SKELCL_DLL int floorPow2(int n);
 
 SKELCL_DLL int ceilPow2(int n);
 
+///
+/// \brief Returns true if the function func defined in source only returns
+///        the result of the binary operator op applied to its two parameters,
+///        e.g. "float func(float x, float y) { return x + y; }" for op "+".
+///        The operands may appear in any order, as op is expected to be
+///        commutative.
+///
+SKELCL_DLL bool isBinaryOperation(const std::string& source,
+                                  const std::string& func,
+                                  const std::string& op);
+
 template<typename T>
 std::string typeToString() {
 #ifdef _WIN32
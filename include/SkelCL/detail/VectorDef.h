@@ -46,6 +46,7 @@
 #include <memory>
 #include <string>
 #include <sstream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -60,6 +61,8 @@
 #include "DeviceList.h"
 #include "Distribution.h"
 #include "Event.h"
+#include "MappedFile.h"
+#include "MemoryManager.h"
 #include "Util.h"
 
 namespace skelcl {
@@ -78,6 +81,8 @@ Vector<T>::Vector()
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(true),
     _hostBuffer(),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerVectorDeviceFunctions;
@@ -94,6 +99,8 @@ Vector<T>::Vector(const size_type size,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(size, value),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerVectorDeviceFunctions;
@@ -109,6 +116,8 @@ Vector<T>::Vector(InputIterator first, InputIterator last)
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(first, last),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerVectorDeviceFunctions;
@@ -126,6 +135,8 @@ Vector<T>::Vector(InputIterator first,
     _hostBufferUpToDate(true),
     _deviceBuffersUpToDate(false),
     _hostBuffer(first, last),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers()
 {
   (void)registerVectorDeviceFunctions;
@@ -133,13 +144,67 @@ Vector<T>::Vector(InputIterator first,
                  getDebugInfo());
 }
 
+template <typename T>
+Vector<T>::Vector(host_buffer_type&& hostBuffer,
+                  const detail::Distribution<Vector<T>>& distribution)
+  : _size(hostBuffer.size()),
+    _distribution(detail::cloneAndConvert<Vector<T>>(distribution)),
+    _hostBufferUpToDate(true),
+    _deviceBuffersUpToDate(false),
+    _hostBuffer(std::move(hostBuffer)),
+    _hostPointer(nullptr),
+    _mappedFile(),
+    _deviceBuffers()
+{
+  (void)registerVectorDeviceFunctions;
+  LOG_DEBUG_INFO("Created new Vector object (", this, ") with ",
+                 getDebugInfo());
+}
+
+template <typename T>
+Vector<T> Vector<T>::wrap(typename Vector<T>::pointer hostPointer,
+                          const size_type size,
+                          const detail::Distribution<Vector<T>>& distribution)
+{
+  ASSERT(hostPointer != nullptr || size == 0);
+
+  Vector<T> v(host_buffer_type(), distribution);
+  v._size        = size;
+  v._hostPointer = hostPointer;
+  LOG_DEBUG_INFO("Vector object (", &v, ") borrows memory (", hostPointer,
+                 ") with ", v.getDebugInfo());
+  return v;
+}
+
+template <typename T>
+Vector<T> Vector<T>::mapFile(const std::string& path,
+                             detail::MapMode mode,
+                             const size_type size,
+                             const detail::Distribution<Vector<T>>& distribution)
+{
+  ASSERT(mode != detail::MapMode::CREATE || size > 0);
+
+  auto mappedFile = std::make_shared<detail::MappedFile>(path, mode,
+                                                         size * sizeof(T));
+  Vector<T> v = wrap(static_cast<pointer>(mappedFile->data()),
+                     mappedFile->sizeInBytes() / sizeof(T),
+                     distribution);
+  v._mappedFile = std::move(mappedFile);
+  return v;
+}
+
 template <typename T>
 Vector<T>::Vector(const Vector<T>& rhs)
   : _size(rhs._size),
     _distribution(detail::cloneAndConvert<Vector<T>>(rhs.distribution())),
     _hostBufferUpToDate(rhs._hostBufferUpToDate),
     _deviceBuffersUpToDate(rhs._deviceBuffersUpToDate),
-    _hostBuffer(rhs._hostBuffer),
+    _hostBuffer(rhs._hostPointer == nullptr
+                  ? rhs._hostBuffer
+                  : host_buffer_type(rhs._hostPointer,
+                                     rhs._hostPointer + rhs._size)),
+    _hostPointer(nullptr),
+    _mappedFile(),
     _deviceBuffers(rhs._deviceBuffers)
 {
   (void)registerVectorDeviceFunctions;
@@ -154,10 +219,14 @@ Vector<T>::Vector(Vector<T>&& rhs)
     _hostBufferUpToDate(std::move(rhs._hostBufferUpToDate)),
     _deviceBuffersUpToDate(std::move(rhs._deviceBuffersUpToDate)),
     _hostBuffer(std::move(rhs._hostBuffer)),
+    _hostPointer(rhs._hostPointer),
+    _mappedFile(std::move(rhs._mappedFile)),
     _deviceBuffers(std::move(rhs._deviceBuffers))
 {
   (void)registerVectorDeviceFunctions;
+  detail::globalMemoryManager.remove(&rhs);
   rhs._size = 0;
+  rhs._hostPointer = nullptr;
   rhs._hostBufferUpToDate = false;
   rhs._deviceBuffersUpToDate = false;
   LOG_DEBUG_INFO("Created new Vector object (", this, ") by moving from (",
@@ -169,10 +238,16 @@ Vector<T>& Vector<T>::operator=(const Vector<T>& rhs)
 {
   if (this == &rhs) return *this; // handle self assignment
   _size                   = rhs._size;
-  _distribution = detail::cloneAndConvert<Vector<T>>(rhs._distribution);
+  _distribution = detail::cloneAndConvert<Vector<T>>(*rhs._distribution);
   _hostBufferUpToDate     = rhs._hostBufferUpToDate;
   _deviceBuffersUpToDate  = rhs._deviceBuffersUpToDate;
-  _hostBuffer             = rhs._hostBuffer;
+  if (rhs._hostPointer == nullptr) {
+    _hostBuffer           = rhs._hostBuffer;
+  } else {
+    _hostBuffer.assign(rhs._hostPointer, rhs._hostPointer + rhs._size);
+  }
+  _hostPointer            = nullptr;
+  _mappedFile.reset();
   _deviceBuffers          = rhs._deviceBuffers;
   LOG_DEBUG_INFO("Assignment to Vector object (", this, ") now with ",
                  getDebugInfo());
@@ -187,8 +262,12 @@ Vector<T>& Vector<T>::operator=(Vector<T>&& rhs)
   _hostBufferUpToDate     = std::move(rhs._hostBufferUpToDate);
   _deviceBuffersUpToDate  = std::move(rhs._deviceBuffersUpToDate);
   _hostBuffer             = std::move(rhs._hostBuffer);
+  _hostPointer            = rhs._hostPointer;
+  _mappedFile             = std::move(rhs._mappedFile);
   _deviceBuffers          = std::move(rhs._deviceBuffers);
+  detail::globalMemoryManager.remove(&rhs);
   rhs._size = 0;
+  rhs._hostPointer = nullptr;
   rhs._hostBufferUpToDate = false;
   rhs._deviceBuffersUpToDate = false;
   LOG_DEBUG_INFO("Move assignment to Vector object (", this, ") from (",
@@ -199,6 +278,7 @@ Vector<T>& Vector<T>::operator=(Vector<T>&& rhs)
 template <typename T>
 Vector<T>::~Vector()
 {
+  detail::globalMemoryManager.remove(this);
   //LOG_DEBUG_INFO("Vector object (", this, ") with ", getDebugInfo(),
   //               " destroyed");
 }
@@ -207,6 +287,7 @@ template <typename T>
 typename Vector<T>::iterator Vector<T>::begin()
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.begin();
 }
 
@@ -214,6 +295,7 @@ template <typename T>
 typename Vector<T>::const_iterator Vector<T>::begin() const
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.begin();
 }
 
@@ -221,6 +303,7 @@ template <typename T>
 typename Vector<T>::iterator Vector<T>::end()
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.end();
 }
 
@@ -228,6 +311,7 @@ template <typename T>
 typename Vector<T>::const_iterator Vector<T>::end() const
 {
   copyDataToHost();
+  detachHostPointer();
   return _hostBuffer.end();
 }
 
@@ -286,6 +370,7 @@ typename Vector<T>::size_type Vector<T>::max_size() const
 template <typename T>
 void Vector<T>::resize( typename Vector<T>::size_type sz, T c )
 {
+  detachHostPointer();
   _size = sz;
   if (_hostBufferUpToDate) {
     _hostBuffer.resize(sz, c);
@@ -311,6 +396,7 @@ bool Vector<T>::empty() const
 template <typename T>
 void Vector<T>::reserve( typename Vector<T>::size_type n )
 {
+  detachHostPointer();
   return _hostBuffer.reserve(n);
 }
 
@@ -318,7 +404,7 @@ template <typename T>
 typename Vector<T>::reference Vector<T>::operator[]( typename Vector<T>::size_type n )
 {
   copyDataToHost();
-  return _hostBuffer.operator[](n);
+  return hostData()[n];
 }
 
 template <typename T>
@@ -326,14 +412,16 @@ typename Vector<T>::const_reference
   Vector<T>::operator[]( typename Vector<T>::size_type n ) const
 {
   copyDataToHost();
-  return _hostBuffer.operator[](n);
+  return hostData()[n];
 }
 
 template <typename T>
 typename Vector<T>::reference Vector<T>::at( typename Vector<T>::size_type n )
 {
   copyDataToHost();
-  return _hostBuffer.at(n);
+  if (_hostPointer == nullptr) return _hostBuffer.at(n);
+  if (n >= _size) throw std::out_of_range("Vector::at");
+  return _hostPointer[n];
 }
 
 template <typename T>
@@ -341,53 +429,58 @@ typename Vector<T>::const_reference
   Vector<T>::at( typename Vector<T>::size_type n ) const
 {
   copyDataToHost();
-  return _hostBuffer.at(n);
+  if (_hostPointer == nullptr) return _hostBuffer.at(n);
+  if (n >= _size) throw std::out_of_range("Vector::at");
+  return _hostPointer[n];
 }
 
 template <typename T>
 typename Vector<T>::reference Vector<T>::front()
 {
   copyDataToHost();
-  return _hostBuffer.front();
+  return *hostData();
 }
 
 template <typename T>
 typename Vector<T>::const_reference Vector<T>::front() const
 {
   copyDataToHost();
-  return _hostBuffer.front();
+  return *hostData();
 }
 
 template <typename T>
 typename Vector<T>::reference Vector<T>::back()
 {
   copyDataToHost();
-  return _hostBuffer.back();
+  return hostData()[_size - 1];
 }
 
 template <typename T>
 typename Vector<T>::const_reference Vector<T>::back() const
 {
   copyDataToHost();
-  return _hostBuffer.back();
+  return hostData()[_size - 1];
 }
 
 template <typename T>
 template <class InputIterator>
 void Vector<T>::assign( InputIterator first, InputIterator last )
 {
+  detachHostPointer();
   _hostBuffer.assign(first, last);
 }
 
 template <typename T>
 void Vector<T>::assign( typename Vector<T>::size_type n, const T& u )
 {
+  detachHostPointer();
   _hostBuffer.assign(n, u);
 }
 
 template <typename T>
 void Vector<T>::push_back( const T& x )
 {
+  detachHostPointer();
   _hostBuffer.push_back(x);
   ++_size;
 }
@@ -395,6 +488,7 @@ void Vector<T>::push_back( const T& x )
 template <typename T>
 void Vector<T>::pop_back()
 {
+  detachHostPointer();
   _hostBuffer.pop_back();
   --_size;
 }
@@ -446,6 +540,8 @@ template <typename T>
 void Vector<T>::swap( Vector<T>& rhs )
 {
   // TODO: swap device buffers
+  detachHostPointer();
+  rhs.detachHostPointer();
   _hostBuffer.swap(rhs._hostBuffer);
   // swap sizes:
   size_type tmp = _size;
@@ -457,6 +553,8 @@ template <typename T>
 void Vector<T>::clear()
 {
   _hostBuffer.clear();
+  _hostPointer = nullptr;
+  _mappedFile.reset();
   _size = 0;
 }
 
@@ -515,6 +613,14 @@ void Vector<T>::setDistribution(
 template <typename T>
 void Vector<T>::createDeviceBuffers() const
 {
+  // mark as used first, so that the buffers are not evicted while created
+  std::vector<detail::Device::id_type> ids;
+  for (auto& devicePtr : _distribution->devices()) {
+    ids.push_back(devicePtr->id());
+  }
+  detail::globalMemoryManager.use(this, ids,
+                                  [this] () { this->evictDeviceBuffers(); });
+
   // create device buffers only if none have been created so far
   if (_deviceBuffers.empty()) {
     forceCreateDeviceBuffers();
@@ -589,7 +695,9 @@ detail::Event Vector<T>::startDownload() const
 
   if (_hostBufferUpToDate) return events;
 
-  _hostBuffer.resize(_size); // make enough room to store data
+  if (_hostPointer == nullptr) {
+    _hostBuffer.resize(_size); // make enough room to store data
+  }
 
   _distribution->startDownload( const_cast<Vector<T>&>(*this), &events );
 
@@ -625,25 +733,65 @@ void Vector<T>::dataOnHostModified() const
   LOG_DEBUG_INFO("Data on host marked as modified");
 }
 
+template <typename T>
+bool Vector<T>::hostIsUpToDate() const
+{
+  return _hostBufferUpToDate;
+}
+
+template <typename T>
+bool Vector<T>::devicesAreUpToDate() const
+{
+  return _deviceBuffersUpToDate;
+}
+
 template <typename T>
 const detail::DeviceBuffer&
   Vector<T>::deviceBuffer(const detail::Device& device) const
 {
+  restoreEvictedDeviceBuffers();
   return _deviceBuffers[device.id()];
 }
 
 template <typename T>
 detail::DeviceBuffer& Vector<T>::deviceBuffer(const detail::Device& device)
 {
+  restoreEvictedDeviceBuffers();
   return _deviceBuffers[device.id()];
 }
 
 template <typename T>
 typename Vector<T>::host_buffer_type& Vector<T>::hostBuffer() const
 {
+  detachHostPointer();
   return _hostBuffer;
 }
 
+template <typename T>
+typename Vector<T>::pointer Vector<T>::hostData() const
+{
+  if (_hostPointer != nullptr) return _hostPointer;
+  return _hostBuffer.data();
+}
+
+template <typename T>
+typename Vector<T>::host_buffer_type Vector<T>::release()
+{
+  copyDataToHost();
+  detachHostPointer();
+
+  host_buffer_type hostBuffer(std::move(_hostBuffer));
+  _hostBuffer.clear();
+  _size = 0;
+  _hostBufferUpToDate = true;
+  _deviceBuffersUpToDate = false; // no device buffers left
+  _deviceBuffers.clear();
+
+  LOG_DEBUG_INFO("Vector object (", this, ") released its elements, now with ",
+                 getDebugInfo());
+  return hostBuffer;
+}
+
 template <typename T>
 std::string Vector<T>::deviceFunctions()
 {
@@ -686,10 +834,47 @@ std::string Vector<T>::getDebugInfo() const
     << ", deviceBuffersCreated: "  << (!_deviceBuffers.empty())
     << ", hostBufferUpToDate: "    << _hostBufferUpToDate
     << ", deviceBuffersUpToDate: " << _deviceBuffersUpToDate
-    << ", hostBuffer: "            << _hostBuffer.data();
+    << ", hostBuffer: "            << hostData();
   return s.str();
 }
 
+template <typename T>
+void Vector<T>::detachHostPointer() const
+{
+  if (_hostPointer == nullptr) return;
+
+  // the borrowed memory is only up to date if the host is,
+  // otherwise the next download fills _hostBuffer
+  if (_hostBufferUpToDate) {
+    _hostBuffer.assign(_hostPointer, _hostPointer + _size);
+  }
+  _hostPointer = nullptr;
+  _mappedFile.reset();
+  LOG_DEBUG_INFO("Vector object (", this, ") copied borrowed memory, now with ",
+                 getDebugInfo());
+}
+
+template <typename T>
+void Vector<T>::restoreEvictedDeviceBuffers() const
+{
+  // device buffers have been evicted by the memory manager
+  if (   _deviceBuffers.empty() && _size > 0
+      && _distribution != nullptr && _distribution->isValid() ) {
+    createDeviceBuffers();
+    startUpload();
+  }
+}
+
+template <typename T>
+void Vector<T>::evictDeviceBuffers() const
+{
+  if (_deviceBuffers.empty()) return;
+  copyDataToHost(); // download modified data first
+  _deviceBuffersUpToDate = false;
+  _deviceBuffers.clear();
+  LOG_DEBUG_INFO("Vector object (", this, ") evicted its device buffers");
+}
+
 } // namespace skelcl
 
 #endif // VECTOR_DEF_H_
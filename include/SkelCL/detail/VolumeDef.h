@@ -0,0 +1,485 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+///  VolumeDef.h
+///
+
+#ifndef VOLUME_DEF_H_
+#define VOLUME_DEF_H_
+
+#include <algorithm>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "../Distributions.h"
+
+#include "Device.h"
+#include "DeviceBuffer.h"
+#include "DeviceList.h"
+#include "Event.h"
+#include "MemoryManager.h"
+#include "Util.h"
+
+namespace skelcl {
+
+template <typename T>
+Volume<T>::Volume()
+  : _size( {0,0,0} ),
+    _distribution(new detail::Distribution<Volume<T>>()),
+    _hostBufferUpToDate(true),
+    _deviceBuffersUpToDate(false),
+    _hostBuffer(),
+    _deviceBuffers()
+{
+  LOG_DEBUG_INFO("Created new Volume object (", this, ") with ",
+      getDebugInfo());
+}
+
+template <typename T>
+Volume<T>::Volume(const size_type& size, const value_type& value)
+  : _size(size),
+    _distribution(new detail::Distribution<Volume<T>>()),
+    _hostBufferUpToDate(true),
+    _deviceBuffersUpToDate(false),
+    _hostBuffer( _size.elemCount(), value ),
+    _deviceBuffers()
+{
+  LOG_DEBUG_INFO("Created new Volume object (", this, ") with ",
+      getDebugInfo());
+}
+
+template <typename T>
+Volume<T>::Volume(Volume<T>&& rhs)
+  : _size(std::move(rhs._size)),
+    _distribution(std::move(rhs._distribution)),
+    _hostBufferUpToDate(std::move(rhs._hostBufferUpToDate)),
+    _deviceBuffersUpToDate(std::move(rhs._deviceBuffersUpToDate)),
+    _hostBuffer(std::move(rhs._hostBuffer)),
+    _deviceBuffers(std::move(rhs._deviceBuffers))
+{
+  detail::globalMemoryManager.remove(&rhs);
+  rhs._size = {0, 0, 0};
+  rhs._hostBuffer.clear();
+
+  LOG_DEBUG_INFO("Created new Volume object (", this, ") with ",
+      getDebugInfo());
+}
+
+template <typename T>
+Volume<T>& Volume<T>::operator=(Volume<T>&& rhs)
+{
+  _size                   = std::move(rhs._size);
+  _distribution           = std::move(rhs._distribution);
+  _hostBufferUpToDate     = std::move(rhs._hostBufferUpToDate);
+  _deviceBuffersUpToDate  = std::move(rhs._deviceBuffersUpToDate);
+  _hostBuffer             = std::move(rhs._hostBuffer);
+  _deviceBuffers          = std::move(rhs._deviceBuffers);
+  detail::globalMemoryManager.remove(&rhs);
+
+  rhs._size = {0, 0, 0};
+  rhs._hostBufferUpToDate = false;
+  rhs._deviceBuffersUpToDate = false;
+  LOG_DEBUG_INFO("Move assignment to Volume object (", this, ") from (",
+                  &rhs,") now with ", getDebugInfo());
+  return *this;
+}
+
+template <typename T>
+Volume<T>::~Volume()
+{
+  detail::globalMemoryManager.remove(this);
+  LOG_DEBUG_INFO("Volume object (", this, ") with ", getDebugInfo(),
+      " destroyed");
+}
+
+template <typename T>
+typename Volume<T>::iterator Volume<T>::begin()
+{
+  return _hostBuffer.begin();
+}
+
+template <typename T>
+typename Volume<T>::const_iterator Volume<T>::begin() const
+{
+  return _hostBuffer.begin();
+}
+
+template <typename T>
+typename Volume<T>::iterator Volume<T>::end()
+{
+  return _hostBuffer.end();
+}
+
+template <typename T>
+typename Volume<T>::const_iterator Volume<T>::end() const
+{
+  return _hostBuffer.end();
+}
+
+template <typename T>
+typename Volume<T>::size_type Volume<T>::size() const
+{
+  return _size;
+}
+
+template <typename T>
+typename Volume<T>::index_type Volume<T>::sliceCount() const
+{
+  return _size.sliceCount();
+}
+
+template <typename T>
+typename Volume<T>::index_type Volume<T>::rowCount() const
+{
+  return _size.rowCount();
+}
+
+template <typename T>
+typename Volume<T>::index_type Volume<T>::columnCount() const
+{
+  return _size.columnCount();
+}
+
+template <typename T>
+bool Volume<T>::empty() const
+{
+  return (_size.elemCount() == 0);
+}
+
+template <typename T>
+void Volume<T>::resize(const size_type& size, T value)
+{
+  // download modified data first, so that it is preserved
+  copyDataToHost();
+  _hostBuffer.resize(size.elemCount(), value);
+  // device buffers are now invalid
+  _deviceBuffers.clear();
+  _hostBufferUpToDate = true;
+  _deviceBuffersUpToDate = false;
+
+  // set size last, to avoid problems, when moving the "old" data around
+  _size = size;
+
+  LOG_DEBUG_INFO("Volume object (", this, ") resized, now with ",
+      getDebugInfo());
+}
+
+template <typename T>
+void Volume<T>::clear()
+{
+  _hostBuffer.clear();
+  _deviceBuffers.clear();
+  _size = {0, 0, 0};
+}
+
+template <typename T>
+typename Volume<T>::reference Volume<T>::operator()(index_type slice,
+                                                    index_type row,
+                                                    index_type column)
+{
+  copyDataToHost();
+  return _hostBuffer[(slice * _size.rowCount() + row) * _size.columnCount()
+                     + column];
+}
+
+template <typename T>
+typename Volume<T>::const_reference Volume<T>::operator()(index_type slice,
+                                                          index_type row,
+                                                          index_type column)
+  const
+{
+  copyDataToHost();
+  return _hostBuffer[(slice * _size.rowCount() + row) * _size.columnCount()
+                     + column];
+}
+
+template <typename T>
+detail::Distribution<Volume<T>>& Volume<T>::distribution() const
+{
+  ASSERT(_distribution != nullptr);
+  return *_distribution;
+}
+
+template <typename T>
+template <typename U>
+void Volume<T>::setDistribution(const detail::Distribution<Volume<U>>&
+                                    origDistribution) const
+{
+  ASSERT(origDistribution.isValid());
+  // only the overlap distribution is implemented for volumes, therefore,
+  // detail::cloneAndConvert can not be used here
+  std::unique_ptr<detail::Distribution<Volume<T>>> newDistribution;
+  auto ol = dynamic_cast<const detail::OLDistribution<Volume<U>>*>(
+                &origDistribution);
+  if (ol != nullptr) {
+    newDistribution.reset(new detail::OLDistribution<Volume<T>>(*ol));
+  } else {
+    newDistribution.reset(
+        new detail::Distribution<Volume<T>>(origDistribution));
+  }
+  this->setDistribution(std::move(newDistribution));
+}
+
+template <typename T>
+void
+  Volume<T>::setDistribution(
+              std::unique_ptr<detail::Distribution<Volume<T>>>&&
+                  newDistribution ) const
+{
+  ASSERT(newDistribution != nullptr);
+  ASSERT(newDistribution->isValid());
+
+  if (   _distribution->isValid()
+      && _distribution->dataExchangeOnDistributionChange(*newDistribution)) {
+    copyDataToHost();
+    _deviceBuffersUpToDate = false;
+    _deviceBuffers.clear(); // delete old device buffers,
+                            // so new can created using the new distribution
+  }
+
+  _distribution = std::move(newDistribution);
+  ASSERT(_distribution->isValid());
+
+  LOG_DEBUG_INFO("Volume object (", this,
+                 ") assigned new distribution, now with ", getDebugInfo());
+}
+
+template <typename T>
+void Volume<T>::createDeviceBuffers() const
+{
+  // mark as used first, so that the buffers are not evicted while created
+  std::vector<detail::Device::id_type> ids;
+  for (auto& devicePtr : _distribution->devices()) {
+    ids.push_back(devicePtr->id());
+  }
+  detail::globalMemoryManager.use(this, ids,
+                                  [this] () { this->evictDeviceBuffers(); });
+
+  // create device buffers only if none have been created so far
+  if (!_deviceBuffers.empty()) return;
+
+  ASSERT(_size.elemCount() > 0);
+  ASSERT(_distribution != nullptr);
+
+  for (auto& devicePtr : _distribution->devices()) {
+    _deviceBuffers.insert(std::make_pair(
+        devicePtr->id(),
+        detail::DeviceBuffer(devicePtr,
+                             _distribution->sizeForDevice(
+                                 const_cast<Volume<T>&>(*this), devicePtr),
+                             sizeof(T))));
+  }
+}
+
+template <typename T>
+detail::Event Volume<T>::startUpload() const
+{
+  ASSERT(_size.elemCount() > 0);
+  ASSERT(_distribution != nullptr);
+  ASSERT(_distribution->isValid());
+  ASSERT(!_deviceBuffers.empty());
+
+  detail::Event events;
+
+  if (_deviceBuffersUpToDate) return events;
+
+  _distribution->startUpload( const_cast<Volume<T>&>(*this), &events );
+
+  _deviceBuffersUpToDate = true;
+
+  LOG_DEBUG_INFO("Started data upload to ", _distribution->devices().size(),
+                 " devices (", getInfo(), ")");
+
+  return events;
+}
+
+template <typename T>
+void Volume<T>::copyDataToDevices() const
+{
+  if (_hostBufferUpToDate && !_deviceBuffersUpToDate) {
+    startUpload().wait();
+  }
+}
+
+template <typename T>
+detail::Event Volume<T>::startDownload() const
+{
+  ASSERT(_size.elemCount() > 0);
+  ASSERT(_distribution != nullptr);
+  ASSERT(_distribution->isValid());
+  ASSERT(!_deviceBuffers.empty());
+
+  detail::Event events;
+
+  if (_hostBufferUpToDate) return events;
+
+  _hostBuffer.resize(_size.elemCount()); // make enough room to store data
+
+  _distribution->startDownload( const_cast<Volume<T>&>(*this), &events );
+
+  _hostBufferUpToDate = true;
+
+  LOG_DEBUG_INFO("Started data download from ", _distribution->devices().size(),
+                 " devices (", getInfo() ,")");
+
+  return events;
+}
+
+template <typename T>
+void Volume<T>::copyDataToHost() const
+{
+  if (_deviceBuffersUpToDate && !_hostBufferUpToDate) {
+    startDownload().wait();
+  }
+}
+
+template <typename T>
+void Volume<T>::dataOnDeviceModified() const
+{
+  _hostBufferUpToDate     = false;
+  _deviceBuffersUpToDate  = true;
+  LOG_DEBUG_INFO("Data on devices marked as modified");
+}
+
+template <typename T>
+void Volume<T>::dataOnHostModified() const
+{
+  _hostBufferUpToDate     = true;
+  _deviceBuffersUpToDate  = false;
+  LOG_DEBUG_INFO("Data on host marked as modified");
+}
+
+template <typename T>
+bool Volume<T>::hostIsUpToDate() const
+{
+  return _hostBufferUpToDate;
+}
+
+template <typename T>
+bool Volume<T>::devicesAreUpToDate() const
+{
+  return _deviceBuffersUpToDate;
+}
+
+template <typename T>
+const detail::DeviceBuffer&
+  Volume<T>::deviceBuffer(const detail::Device& device) const
+{
+  restoreEvictedDeviceBuffers();
+  return _deviceBuffers[device.id()];
+}
+
+template <typename T>
+typename Volume<T>::host_buffer_type& Volume<T>::hostBuffer() const
+{
+  return _hostBuffer;
+}
+
+template <typename T>
+typename Volume<T>::pointer Volume<T>::hostData() const
+{
+  return _hostBuffer.data();
+}
+
+template <typename T>
+std::string Volume<T>::deviceFunctions()
+{
+  std::string type = detail::util::typeToString<T>();
+  std::stringstream s;
+
+  // found "double" => enable double
+  if (type.find("double") != std::string::npos) {
+    s << "#if defined(cl_khr_fp64)\n"
+         "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+         "#elif defined(cl_amd_fp64)\n"
+         "#pragma OPENCL EXTENSION cl_amd_fp64 : enable\n"
+         "#endif\n";
+  }
+
+  return s.str();
+}
+
+template <typename T>
+std::string Volume<T>::getInfo() const
+{
+  std::stringstream s;
+  s << "size: " << _size.elemCount();
+  return s.str();
+}
+
+template <typename T>
+std::string Volume<T>::getDebugInfo() const
+{
+  std::stringstream s;
+  s << getInfo()
+    << std::boolalpha
+    << ", deviceBuffersCreated: "  << (!_deviceBuffers.empty())
+    << ", hostBufferUpToDate: "    << _hostBufferUpToDate
+    << ", deviceBuffersUpToDate: " << _deviceBuffersUpToDate
+    << ", hostBuffer: "            << _hostBuffer.data();
+  return s.str();
+}
+
+template <typename T>
+void Volume<T>::restoreEvictedDeviceBuffers() const
+{
+  // device buffers have been evicted by the memory manager
+  if (   _deviceBuffers.empty() && _size.elemCount() > 0
+      && _distribution != nullptr && _distribution->isValid() ) {
+    createDeviceBuffers();
+    startUpload();
+  }
+}
+
+template <typename T>
+void Volume<T>::evictDeviceBuffers() const
+{
+  if (_deviceBuffers.empty()) return;
+  copyDataToHost(); // download modified data first
+  _deviceBuffersUpToDate = false;
+  _deviceBuffers.clear();
+  LOG_DEBUG_INFO("Volume object (", this, ") evicted its device buffers");
+}
+
+} // namespace skelcl
+
+#endif // VOLUME_DEF_H_
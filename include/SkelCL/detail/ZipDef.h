@@ -44,9 +44,11 @@
 #include <istream>
 #include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.hpp>
@@ -56,13 +58,17 @@
 #include <pvsutil/Logger.h>
 
 #include "../Distributions.h"
+#include "../Expression.h"
 #include "../Out.h"
 #include "../Source.h"
 
+#include "Batch.h"
 #include "Device.h"
+#include "ExpressionNode.h"
 #include "KernelUtil.h"
 #include "Program.h"
 #include "Skeleton.h"
+#include "Streaming.h"
 #include "Util.h"
 
 namespace skelcl {
@@ -100,6 +106,22 @@ C<Tout>& Zip<Tout(Tleft, Tright)>::operator()(Out<C<Tout>> output,
 {
   ASSERT(left.size() <= right.size());
 
+  if (   left.hostIsUpToDate() && right.hostIsUpToDate()
+      && detail::streaming::isRequired(
+           detail::streaming::elementCount(left),
+           sizeof(Tleft) + sizeof(Tright) + sizeof(Tout)) ) {
+    prepareAdditionalInput(std::forward<Args>(args)...);
+
+    executeStreaming(output.container(), left, right,
+                     std::forward<Args>(args)...);
+
+    // output is only modified on the host
+    output.container().dataOnHostModified();
+    updateModifiedStatus(std::forward<Args>(args)...);
+
+    return output.container();
+  }
+
   prepareInput(left, right);
 
   prepareAdditionalInput(std::forward<Args>(args)...);
@@ -113,6 +135,36 @@ C<Tout>& Zip<Tout(Tleft, Tright)>::operator()(Out<C<Tout>> output,
   return output.container();
 }
 
+template <typename Tleft, typename Tright, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+std::vector<C<Tout>>& Zip<Tout(Tleft, Tright)>::batch(
+                                        std::vector<C<Tout>>& outputs,
+                                        const std::vector<C<Tleft>>& lefts,
+                                        const std::vector<C<Tright>>& rights,
+                                        Args&&... args)
+{
+  ASSERT(lefts.size() == rights.size());
+
+  // the right containers are packed with the offsets of the left ones
+  auto offsets = detail::batch::offsets(lefts);
+
+  detail::batch::prepareOutputs(outputs, lefts);
+  if (offsets.back() == 0) return outputs; // nothing to compute
+
+  // pack all inputs into single containers, process them with a single
+  // kernel launch and unpack the results
+  Vector<Tleft>  packedLeft  = detail::batch::pack(lefts, offsets);
+  Vector<Tright> packedRight = detail::batch::pack(rights, offsets);
+  Vector<Tout>   packedOutput;
+  this->operator()(out(packedOutput), packedLeft, packedRight,
+                   std::forward<Args>(args)...);
+  detail::batch::unpack(packedOutput, offsets, outputs);
+
+  LOG_DEBUG_INFO("Zip processed a batch of ", lefts.size(), " containers");
+  return outputs;
+}
+
 template <typename Tleft, typename Tright, typename Tout>
 template <template <typename> class C,
           typename... Args>
@@ -172,6 +224,91 @@ void Zip<Tout(Tleft, Tright)>::execute(C<Tout>& output,
   LOG_DEBUG_INFO("Zip kernel started");
 }
 
+template <typename Tleft, typename Tright, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+void Zip<Tout(Tleft, Tright)>::executeStreaming(C<Tout>& output,
+                                                const C<Tleft>& left,
+                                                const C<Tright>& right,
+                                                Args&&... args)
+{
+  namespace streaming = detail::streaming;
+
+  auto elements = streaming::elementCount(left);
+  const size_t bytesPerElement = sizeof(Tleft) + sizeof(Tright) + sizeof(Tout);
+
+  if (   static_cast<void*>(&output) != static_cast<const void*>(&left)
+      && static_cast<void*>(&output) != static_cast<const void*>(&right) ) {
+    // resize container if required
+    if (streaming::elementCount(output) < elements) {
+      output.resize(left.size());
+    }
+  }
+
+  const Tleft*  leftPtr   = left.hostData();
+  const Tright* rightPtr  = right.hostData();
+  Tout*         outputPtr = output.hostData();
+
+  streaming::Buffers leftBuffers(sizeof(Tleft), bytesPerElement);
+  streaming::Buffers rightBuffers(sizeof(Tright), bytesPerElement);
+  streaming::Buffers outputBuffers(sizeof(Tout), bytesPerElement);
+
+  auto upload = [&] (const streaming::Chunk& chunk,
+                     const streaming::Events& waitFor) {
+    streaming::Events events;
+    events.push_back(
+      chunk.devicePtr->enqueueTransferWrite(leftBuffers[chunk],
+                                            leftPtr + chunk.offset,
+                                            chunk.size, waitFor) );
+    events.push_back(
+      chunk.devicePtr->enqueueTransferWrite(rightBuffers[chunk],
+                                            rightPtr + chunk.offset,
+                                            chunk.size, waitFor) );
+    return events;
+  };
+
+  auto compute = [&] (const streaming::Chunk& chunk,
+                      const streaming::Events& waitFor) {
+    auto& devicePtr = chunk.devicePtr;
+    cl_uint elements  = static_cast<cl_uint>( chunk.size );
+    cl_uint local     = static_cast<cl_uint>(
+                          std::min(this->workGroupSize(),
+                                   devicePtr->maxWorkGroupSize()) );
+    cl_uint global    = static_cast<cl_uint>(
+                          detail::util::ceilToMultipleOf(elements, local) );
+    cl::Event event;
+    try {
+      cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_ZIP"));
+
+      kernel.setArg(0, leftBuffers[chunk].clBuffer());
+      kernel.setArg(1, rightBuffers[chunk].clBuffer());
+      kernel.setArg(2, outputBuffers[chunk].clBuffer());
+      kernel.setArg(3, elements);
+
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, 4,
+                                        std::forward<Args>(args)...);
+
+      event = devicePtr->enqueue(kernel,
+                                 cl::NDRange(global), cl::NDRange(local),
+                                 waitFor);
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+    return event;
+  };
+
+  auto download = [&] (const streaming::Chunk& chunk,
+                       const streaming::Events& waitFor) {
+    return chunk.devicePtr->enqueueTransferRead(outputBuffers[chunk],
+                                                outputPtr + chunk.offset,
+                                                chunk.size, waitFor);
+  };
+
+  streaming::process(elements, bytesPerElement, upload, compute, download);
+
+  LOG_DEBUG_INFO("Zip streamed ", elements, " elements");
+}
+
 template<typename Tleft, typename Tright, typename Tout>
 detail::Program
   Zip<Tout(Tleft, Tright)>::createAndBuildProgram(
@@ -270,6 +407,19 @@ void Zip<Tout(Tleft, Tright)>::prepareOutput(C<Tout>& output,
   output.createDeviceBuffers();
 }
 
+template <typename Tleft, typename Tright, typename Tout>
+Expression<Tout>
+  Zip<Tout(Tleft, Tright)>::operator()(const Expression<Tleft>& left,
+                                       const Expression<Tright>& right)
+{
+  auto node = std::make_shared<const detail::ExpressionNode>(
+                _source, _funcName,
+                std::vector<detail::ExpressionNode::ptr_type>{ left.node(),
+                                                               right.node() },
+                this->workGroupSize());
+  return Expression<Tout>(node, left);
+}
+
 template <typename Tleft, typename Tright, typename Tout>
 const std::string& Zip<Tout(Tleft, Tright)>::source() const
 {
@@ -441,6 +591,308 @@ void Zip<void(Tleft, Tright)>::prepareInput(const C<Tleft>& left,
   right.startUpload();
 }
 
+// ## Zip<T1, Tn..., Tout> ##########################################
+
+namespace detail {
+
+namespace zip_helper {
+
+inline void setBlockDistribution()
+{
+}
+
+template <typename C, typename... Cs>
+void setBlockDistribution(const C& container, const Cs&... containers)
+{
+  container.setDistribution(BlockDistribution<C>());
+  setBlockDistribution(containers...);
+}
+
+template <typename Target>
+void adoptFirstValidDistribution(const Target& /*target*/)
+{
+}
+
+template <typename Target, typename C, typename... Cs>
+void adoptFirstValidDistribution(const Target& target,
+                                 const C& container, const Cs&... containers)
+{
+  if (container.distribution().isValid()) {
+    target.setDistribution(container.distribution());
+  } else {
+    adoptFirstValidDistribution(target, containers...);
+  }
+}
+
+template <typename Reference>
+bool adoptOrCompareDistribution(const Reference& /*reference*/)
+{
+  return true;
+}
+
+// containers without a valid distribution adopt the one of reference, all
+// others are compared with it
+template <typename Reference, typename C, typename... Cs>
+bool adoptOrCompareDistribution(const Reference& reference,
+                                const C& container, const Cs&... containers)
+{
+  bool equal = true;
+  if (!container.distribution().isValid()) {
+    container.setDistribution(reference.distribution());
+  } else {
+    equal = (   reference.distribution()
+             == *cloneAndConvert<Reference>(container.distribution()) );
+  }
+  return adoptOrCompareDistribution(reference, containers...) && equal;
+}
+
+inline void createDeviceBuffersAndUpload()
+{
+}
+
+template <typename C, typename... Cs>
+void createDeviceBuffersAndUpload(const C& container, const Cs&... containers)
+{
+  // create buffers if required
+  container.createDeviceBuffers();
+  // copy data to devices
+  container.startUpload();
+  createDeviceBuffersAndUpload(containers...);
+}
+
+template <typename Reference>
+bool haveSameSize(const Reference& /*reference*/)
+{
+  return true;
+}
+
+template <typename Reference, typename C, typename... Cs>
+bool haveSameSize(const Reference& reference,
+                  const C& container, const Cs&... containers)
+{
+  return    reference.size() == container.size()
+         && haveSameSize(reference, containers...);
+}
+
+} // namespace zip_helper
+
+} // namespace detail
+
+template <typename T1, typename... Tn, typename Tout>
+Zip<Tout(T1, Tn...)>::Zip(const Source& source,
+                          const std::string& funcName)
+  : detail::Skeleton(),
+    _source(source),
+    _funcName(funcName),
+    _program(createAndBuildProgram(source, funcName))
+{
+  LOG_DEBUG_INFO("Create new Zip object (", this, ") with ",
+                 1 + sizeof...(Tn), " inputs");
+}
+
+template <typename T1, typename... Tn, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+C<Tout> Zip<Tout(T1, Tn...)>::operator()(const C<T1>& first,
+                                         const C<Tn>&... rest,
+                                         Args&&... args)
+{
+  C<Tout> output;
+  this->operator()(out(output), first, rest..., std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename T1, typename... Tn, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+C<Tout>& Zip<Tout(T1, Tn...)>::operator()(Out<C<Tout>> output,
+                                          const C<T1>& first,
+                                          const C<Tn>&... rest,
+                                          Args&&... args)
+{
+  ASSERT_MESSAGE(detail::zip_helper::haveSameSize(first, rest...),
+                 "All inputs of the Zip skeleton must have the same size.");
+
+  prepareInput(first, rest...);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  prepareOutput(output.container(), first);
+
+  execute(output.container(), first, rest..., std::forward<Args>(args)...);
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename T1, typename... Tn, typename Tout>
+const std::string& Zip<Tout(T1, Tn...)>::source() const
+{
+  return _source;
+}
+
+template <typename T1, typename... Tn, typename Tout>
+const std::string& Zip<Tout(T1, Tn...)>::func() const
+{
+  return _funcName;
+}
+
+template <typename T1, typename... Tn, typename Tout>
+template <template <typename> class C,
+          typename... Args>
+void Zip<Tout(T1, Tn...)>::execute(C<Tout>& output,
+                                   const C<T1>& first,
+                                   const C<Tn>&... rest,
+                                   Args&&... args)
+{
+  ASSERT( first.distribution().isValid() );
+  ASSERT( output.size() >= first.size() );
+
+  for (auto& devicePtr : first.distribution().devices()) {
+    auto& outputBuffer= output.deviceBuffer(*devicePtr);
+    auto& firstBuffer = first.deviceBuffer(*devicePtr);
+
+    cl_uint elements  = static_cast<cl_uint>( firstBuffer.size() );
+    cl_uint local     = static_cast<cl_uint>(
+                          std::min(this->workGroupSize(),
+                                   devicePtr->maxWorkGroupSize()) );
+    cl_uint global    = static_cast<cl_uint>(
+                          detail::util::ceilToMultipleOf(elements, local) );
+
+    try {
+      cl::Kernel kernel(_program.kernel(*devicePtr, "SCL_ZIP"));
+
+      // one buffer per input, the output buffer, the number of elements and
+      // the additional arguments
+      kernel.setArg(0, firstBuffer.clBuffer());
+      detail::kernelUtil::setKernelArgs(kernel, *devicePtr, 1,
+                                        rest.deviceBuffer(*devicePtr)
+                                            .clBuffer()...,
+                                        outputBuffer.clBuffer(),
+                                        elements,
+                                        std::forward<Args>(args)...);
+
+      auto keepAlive = detail::kernelUtil::keepAlive(*devicePtr,
+                                                     firstBuffer.clBuffer(),
+                                                     rest.deviceBuffer(
+                                                       *devicePtr).clBuffer()...,
+                                                     outputBuffer.clBuffer(),
+                                                     std::forward<Args>(args)...
+                                                    );
+
+      // after finishing the kernel invoke this function ...
+      auto invokeAfter = [=] () {
+                                  (void)keepAlive;
+                                };
+
+      devicePtr->enqueue(kernel,
+                         cl::NDRange(global), cl::NDRange(local),
+                         cl::NullRange, // offset
+                         invokeAfter);
+
+    } catch (cl::Error& err) {
+      ABORT_WITH_ERROR(err);
+    }
+  }
+  LOG_DEBUG_INFO("Zip kernel started");
+}
+
+template <typename T1, typename... Tn, typename Tout>
+template <template <typename> class C>
+void Zip<Tout(T1, Tn...)>::prepareInput(const C<T1>& first,
+                                        const C<Tn>&... rest)
+{
+  namespace zip_helper = detail::zip_helper;
+
+  // set default distribution if required
+  if (!first.distribution().isValid()) {
+    zip_helper::adoptFirstValidDistribution(first, rest...);
+  }
+  if (!first.distribution().isValid()) {
+    zip_helper::setBlockDistribution(first, rest...);
+  } else if (!zip_helper::adoptOrCompareDistribution(first, rest...)) {
+    // inputs are distributed differently
+    zip_helper::setBlockDistribution(first, rest...);
+  }
+  // create buffers if required and copy data to devices
+  zip_helper::createDeviceBuffersAndUpload(first, rest...);
+}
+
+template <typename T1, typename... Tn, typename Tout>
+template <template <typename> class C>
+void Zip<Tout(T1, Tn...)>::prepareOutput(C<Tout>& output,
+                                         const C<T1>& first)
+{
+  // resize container if required
+  if (output.size() < first.size()) {
+    output.resize(first.size());
+  }
+  // adopt distribution from first input
+  output.setDistribution(first.distribution());
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
+template <typename T1, typename... Tn, typename Tout>
+detail::Program
+    Zip<Tout(T1, Tn...)>::createAndBuildProgram(const std::string& source,
+                                                const std::string& funcName)
+                                                                        const
+{
+  ASSERT_MESSAGE(!source.empty(),
+    "Tried to create program with empty user source.");
+
+  const size_t inputs = 1 + sizeof...(Tn);
+
+  // generate the kernel signature for all inputs
+  std::stringstream kernel;
+  for (size_t i = 0; i <= inputs; ++i) {
+    kernel << "typedef float SCL_TYPE_" << i << ";\n";
+  }
+  kernel << "\n__kernel void SCL_ZIP(\n";
+  for (size_t i = 0; i < inputs; ++i) {
+    kernel << "    const __global SCL_TYPE_" << i << "*  SCL_IN_" << i
+           << ",\n";
+  }
+  kernel << "          __global SCL_TYPE_" << inputs << "*  SCL_OUT,\n"
+         << "    const unsigned int          SCL_ELEMENTS ) {\n"
+         << "  if (get_global_id(0) < SCL_ELEMENTS) {\n"
+         << "    SCL_OUT[get_global_id(0)] = SCL_FUNC(";
+  for (size_t i = 0; i < inputs; ++i) {
+    kernel << (i > 0 ? ", " : "") << "SCL_IN_" << i << "[get_global_id(0)]";
+  }
+  kernel << ");\n"
+         << "  }\n"
+         << "}\n";
+
+  // create program
+  // first: device specific functions
+  std::string s(detail::CommonDefinitions::getSource());
+  // second: user defined source
+  s.append(source);
+  // last: append skeleton implementation source
+  s.append("\n");
+  s.append(kernel.str());
+
+  auto program = detail::Program(s, detail::util::hash(s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    // append parameters from user function to kernel
+    program.transferParameters(funcName, inputs, "SCL_ZIP");
+    program.transferArguments(funcName, inputs, "SCL_FUNC");
+    // rename user function
+    program.renameFunction(funcName, "SCL_FUNC");
+    // rename typedefs
+    program.adjustTypes<T1, Tn..., Tout>();
+  }
+  // build program
+  program.build();
+
+  return program;
+}
+
 } // namespace skelcl
 
 #endif // ZIP_DEF_H_
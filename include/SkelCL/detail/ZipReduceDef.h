@@ -0,0 +1,335 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ZipReduceDef.h
+///
+
+#ifndef ZIP_REDUCE_DEF_H_
+#define ZIP_REDUCE_DEF_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include <stooling/SourceCode.h>
+
+#include "../Distributions.h"
+#include "../Out.h"
+#include "../Vector.h"
+
+#include "Device.h"
+#include "DeviceBuffer.h"
+#include "DeviceList.h"
+#include "KernelUtil.h"
+#include "Program.h"
+#include "ReduceHelper.h"
+#include "Skeleton.h"
+#include "Util.h"
+
+namespace skelcl {
+
+template <typename Tleft, typename Tright, typename Tout>
+ZipReduce<Tout(Tleft, Tright)>::ZipReduce(const Source& zipSource,
+                                          const Source& reduceSource,
+                                          const std::string& id,
+                                          const std::string& zipFunc,
+                                          const std::string& reduceFunc)
+  : detail::Skeleton(),
+    _srcZip(zipSource),
+    _srcReduce(reduceSource),
+    _funcZip(zipFunc),
+    _funcReduce(reduceFunc),
+    _idReduce(id),
+    _program(createAndBuildProgram())
+{
+  LOG_DEBUG_INFO("Create new ZipReduce object (", this, ")");
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+Vector<Tout> ZipReduce<Tout(Tleft, Tright)>::operator()(
+                                                const Vector<Tleft>& left,
+                                                const Vector<Tright>& right,
+                                                Args&&... args)
+{
+  Vector<Tout> output;
+  this->operator()(out(output), left, right, std::forward<Args>(args)...);
+  return output;
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+Vector<Tout>& ZipReduce<Tout(Tleft, Tright)>::operator()(
+                                                Out<Vector<Tout>> output,
+                                                const Vector<Tleft>& left,
+                                                const Vector<Tright>& right,
+                                                Args&&... args)
+{
+  ASSERT( left.size() == right.size() );
+
+  if (left.size() == 0) {
+    // the result for empty inputs is the identity
+    auto& devicePtr = detail::globalDeviceList.front();
+    prepareOutput(output.container(), devicePtr);
+
+    auto& outputBuffer = output.container().deviceBuffer(*devicePtr);
+    detail::reduceHelper::reducePartials(_program, *devicePtr, outputBuffer,
+                                         outputBuffer, 0,
+                                         this->workGroupSize());
+
+    updateModifiedStatus(output, std::forward<Args>(args)...);
+    return output.container();
+  }
+
+  prepareInput(left, right);
+
+  prepareAdditionalInput(std::forward<Args>(args)...);
+
+  auto& devices = left.distribution().devices();
+  bool isCopy = (dynamic_cast<detail::CopyDistribution<Vector<Tleft>>*>(
+                   &left.distribution()) != nullptr);
+
+  if (devices.size() == 1 || isCopy) {
+    auto& devicePtr = devices.front();
+    prepareOutput(output.container(), devicePtr);
+
+    size_t groups = numberOfGroups(*devicePtr, left.size());
+    detail::DeviceBuffer tmpBuffer(devicePtr, groups, sizeof(Tout));
+
+    executeZipReduce(*devicePtr, left.deviceBuffer(*devicePtr),
+                     right.deviceBuffer(*devicePtr), tmpBuffer,
+                     left.size(), groups, std::forward<Args>(args)...);
+    detail::reduceHelper::reducePartials(
+        _program, *devicePtr, tmpBuffer,
+        output.container().deviceBuffer(*devicePtr), groups,
+        this->workGroupSize());
+  } else {
+    // 1. every device reduces its block to a single value
+    std::vector<detail::DeviceBuffer> partials;
+    for (auto& devicePtr : devices) {
+      auto& leftBuffer = left.deviceBuffer(*devicePtr);
+      if (leftBuffer.size() == 0) continue;
+
+      size_t groups = numberOfGroups(*devicePtr, leftBuffer.size());
+      detail::DeviceBuffer tmpBuffer(devicePtr, groups, sizeof(Tout));
+      partials.emplace_back(devicePtr, 1, sizeof(Tout));
+
+      executeZipReduce(*devicePtr, leftBuffer, right.deviceBuffer(*devicePtr),
+                       tmpBuffer, leftBuffer.size(), groups,
+                       std::forward<Args>(args)...);
+      detail::reduceHelper::reducePartials(_program, *devicePtr, tmpBuffer,
+                                           partials.back(), groups,
+                                           this->workGroupSize());
+    }
+
+    // 2. combine the partial results on the first device
+    auto& devicePtr = devices.front();
+    prepareOutput(output.container(), devicePtr);
+
+    detail::reduceHelper::combineDevicePartials(
+        _program, partials, output.container().deviceBuffer(*devicePtr),
+        this->workGroupSize());
+  }
+
+  LOG_DEBUG_INFO("ZipReduce kernels started");
+
+  updateModifiedStatus(output, std::forward<Args>(args)...);
+
+  return output.container();
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+void ZipReduce<Tout(Tleft, Tright)>::prepareInput(const Vector<Tleft>& left,
+                                                  const Vector<Tright>& right)
+{
+  // set default distribution if required
+  if (   !left.distribution().isValid()
+      && !right.distribution().isValid() ) {
+    left.setDistribution(detail::BlockDistribution<Vector<Tleft>>());
+    right.setDistribution(detail::BlockDistribution<Vector<Tright>>());
+  } else if (!left.distribution().isValid()) {
+    left.setDistribution(right.distribution());
+  } else if (!right.distribution().isValid()) {
+    right.setDistribution(left.distribution());
+  } else if ( left.distribution() != right.distribution() ) {
+    left.setDistribution(detail::BlockDistribution<Vector<Tleft>>());
+    right.setDistribution(detail::BlockDistribution<Vector<Tright>>());
+  }
+  // create buffers if required
+  left.createDeviceBuffers();
+  right.createDeviceBuffers();
+  // copy data to devices
+  left.startUpload();
+  right.startUpload();
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+void ZipReduce<Tout(Tleft, Tright)>::prepareOutput(
+                                      Vector<Tout>& output,
+                                      const detail::Device::ptr_type& devicePtr)
+{
+  // resize container if required
+  if (output.size() < 1) {
+    output.resize(1);
+  }
+  // the result is computed on a single device
+  output.setDistribution(detail::SingleDistribution<Vector<Tout>>(devicePtr));
+  // create buffers if required
+  output.createDeviceBuffers();
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+size_t ZipReduce<Tout(Tleft, Tright)>::numberOfGroups(
+                                      const detail::Device& device,
+                                      size_t data_size) const
+{
+  return detail::reduceHelper::numberOfGroups(
+           device,
+           detail::reduceHelper::localSize(_program, device, "SCL_ZIP_REDUCE",
+                                           this->workGroupSize()),
+           data_size);
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+template <typename... Args>
+void ZipReduce<Tout(Tleft, Tright)>::executeZipReduce(
+                                      const detail::Device& device,
+                                      const detail::DeviceBuffer& left,
+                                      const detail::DeviceBuffer& right,
+                                      const detail::DeviceBuffer& output,
+                                      size_t data_size, size_t groups,
+                                      Args&&... args)
+{
+  ASSERT(output.size() >= groups);
+  try {
+    const size_t local_size = detail::reduceHelper::localSize(
+                                _program, device, "SCL_ZIP_REDUCE",
+                                this->workGroupSize());
+
+    cl::Kernel kernel = _program.kernel(device, "SCL_ZIP_REDUCE");
+    kernel.setArg(0, left.clBuffer());
+    kernel.setArg(1, right.clBuffer());
+    kernel.setArg(2, output.clBuffer());
+    kernel.setArg(3, cl::__local(local_size * sizeof(Tout)));
+    kernel.setArg(4, static_cast<cl_uint>(data_size));
+
+    detail::kernelUtil::setKernelArgs(kernel, device, 5,
+                                      std::forward<Args>(args)...);
+
+    auto keepAlive = detail::kernelUtil::keepAlive(device, left.clBuffer(),
+                                                   right.clBuffer(),
+                                                   output.clBuffer(),
+                                                   std::forward<Args>(args)...);
+
+    // after finishing the kernel invoke this function ...
+    auto invokeAfter = [keepAlive]() {};
+
+    device.enqueue(kernel, cl::NDRange(groups * local_size),
+                   cl::NDRange(local_size),
+                   cl::NullRange, // offset
+                   invokeAfter);
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+}
+
+template <typename Tleft, typename Tright, typename Tout>
+detail::Program
+  ZipReduce<Tout(Tleft, Tright)>::createAndBuildProgram() const
+{
+  ASSERT_MESSAGE( !_srcZip.empty(),
+                  "Tried to create program with empty user zip source." );
+  ASSERT_MESSAGE( !_srcReduce.empty(),
+                  "Tried to create program with empty user reduce source." );
+
+  // _srcZip: replace func by TMP_ZIP
+  stooling::SourceCode zSource(_srcZip);
+  zSource.renameFunction(_funcZip, "TMP_ZIP");
+
+  // _srcReduce: replace func by TMP_REDUCE
+  stooling::SourceCode rSource(_srcReduce);
+  rSource.renameFunction(_funcReduce, "TMP_REDUCE");
+
+  // create program
+  // first: device specific functions
+  std::string s(detail::CommonDefinitions::getSource());
+  // second: identity
+  s.append("#define SCL_IDENTITY (" + _idReduce + ")\n");
+  // next: user defined sources
+  s.append(zSource.code());
+  s.append("\n");
+  s.append(rSource.code());
+  s.append("\n");
+  // last: append skeleton implementation source
+  s.append(R"(
+typedef float SCL_TYPE_0;
+typedef float SCL_TYPE_1;
+typedef float SCL_TYPE_2;
+#define SCL_REDUCE_TYPE SCL_TYPE_2
+)");
+  s.append(
+    #include "ReducePartialsKernel.cl"
+  );
+  s.append(
+    #include "ZipReduceKernel.cl"
+  );
+
+  auto program = detail::Program(s, detail::util::hash("//ZipReduce\n" + s));
+
+  // modify program
+  if (!program.loadBinary()) {
+    // additional arguments are passed to the zip function only
+    program.transferParameters("TMP_ZIP", 2, "SCL_ZIP_REDUCE");
+    program.transferArguments("TMP_ZIP", 2, "USR_ZIP");
+
+    program.renameFunction("TMP_ZIP", "USR_ZIP");
+    program.renameFunction("TMP_REDUCE", "USR_REDUCE");
+
+    program.adjustTypes<Tleft, Tright, Tout>();
+  }
+  program.build();
+
+  return program;
+}
+
+} // namespace skelcl
+
+#endif // ZIP_REDUCE_DEF_H_
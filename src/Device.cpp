@@ -53,6 +53,7 @@
 #include "SkelCL/detail/Device.h"
 
 #include "SkelCL/detail/DeviceBuffer.h"
+#include "SkelCL/detail/MemoryManager.h"
 
 namespace {
 
@@ -95,7 +96,7 @@ namespace detail {
 Device::Device(const cl::Device& device,
                const cl::Platform& platform,
                const Device::id_type id)
-  : _device(device), _context(), _commandQueue(), _id(id)
+  : _device(device), _context(), _commandQueue(), _transferQueue(), _id(id)
 {
   try {
     VECTOR_CLASS<cl::Device> devices(1, _device);
@@ -111,6 +112,10 @@ Device::Device(const cl::Device& device,
     // create command queue for every device
     _commandQueue = cl::CommandQueue(_context, _device,
                                      CL_QUEUE_PROFILING_ENABLE);
+
+    // create a second command queue for transfers overlapping with kernels
+    _transferQueue = cl::CommandQueue(_context, _device,
+                                      CL_QUEUE_PROFILING_ENABLE);
   } catch (cl::Error& err) {
     ABORT_WITH_ERROR(err);
   }
@@ -147,6 +152,8 @@ cl::Event Device::enqueue(const cl::Kernel& kernel,
     _commandQueue.enqueueNDRangeKernel(kernel, offset, global, local,
                                        NULL, &event);
     _commandQueue.flush(); // always start calculation right away
+    // buffers used by the kernel might be evicted from now on
+    globalMemoryManager.kernelEnqueued();
   } catch (cl::Error& err) {
     ABORT_WITH_ERROR(err);
   }
@@ -166,6 +173,31 @@ cl::Event Device::enqueue(const cl::Kernel& kernel,
   return event;
 }
 
+cl::Event Device::enqueue(const cl::Kernel& kernel,
+                          const cl::NDRange& global,
+                          const cl::NDRange& local,
+                          const VECTOR_CLASS<cl::Event>& waitFor) const
+{
+  ASSERT(global.dimensions() == local.dimensions());
+
+  cl::Event event;
+  try {
+    _commandQueue.enqueueNDRangeKernel(kernel, cl::NullRange, global, local,
+                                       (waitFor.empty() ? NULL : &waitFor),
+                                       &event);
+    _commandQueue.flush(); // always start calculation right away
+    // buffers used by the kernel might be evicted from now on
+    globalMemoryManager.kernelEnqueued();
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  LOG_DEBUG_INFO("Kernel for device ", _id, " enqueued with global range: ",
+                 ::printNDRange(global), ", local: ", ::printNDRange(local),
+                 ", waiting for ", waitFor.size(), " events");
+  return event;
+}
+
 cl::Event Device::enqueueWrite(const  DeviceBuffer& buffer,
                                const void* hostPointer,
                                size_t hostOffset) const
@@ -298,6 +330,115 @@ cl::Event Device::enqueueRead(const DeviceBuffer& buffer,
   return event;
 }
 
+cl::Event Device::enqueueReadRect(const DeviceBuffer& buffer,
+                                  void* const hostPointer,
+                                  size_t rows,
+                                  size_t columns,
+                                  size_t deviceRowPitch,
+                                  size_t hostRowPitch,
+                                  size_t deviceOffset,
+                                  size_t hostOffset) const
+{
+  auto elemSize = buffer.elemSize();
+
+  cl::size_t<3> bufferOrigin;
+  bufferOrigin[0] = deviceOffset * elemSize;
+  cl::size_t<3> hostOrigin;
+  hostOrigin[0] = hostOffset * elemSize;
+  cl::size_t<3> region;
+  region[0] = columns * elemSize;
+  region[1] = rows;
+  region[2] = 1;
+
+  cl::Event event;
+  try {
+    _commandQueue.enqueueReadBufferRect(buffer.clBuffer(),
+                                        CL_FALSE,
+                                        bufferOrigin,
+                                        hostOrigin,
+                                        region,
+                                        deviceRowPitch * elemSize,
+                                        0,
+                                        hostRowPitch * elemSize,
+                                        0,
+                                        hostPointer,
+                                        NULL,
+                                        &event);
+    _commandQueue.flush(); // always start operation right away
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  LOG_DEBUG_INFO("Enqueued read buffer rect for device ", _id,
+                 " (rows: ", rows,
+                 ", row size: ", columns * elemSize,
+                 ", clBuffer: ", buffer.clBuffer()(),
+                 ", deviceOffset: ", deviceOffset * elemSize,
+                 ", hostPointer: ", hostPointer,
+                 ", hostOffset: ", hostOffset * elemSize, ")");
+  return event;
+}
+
+cl::Event Device::enqueueTransferWrite(const DeviceBuffer& buffer,
+                                       const void* hostPointer,
+                                       size_t size,
+                                       const VECTOR_CLASS<cl::Event>& waitFor
+                                      ) const
+{
+  ASSERT(size <= buffer.size());
+
+  cl::Event event;
+  try {
+    _transferQueue.enqueueWriteBuffer(buffer.clBuffer(),
+                                      CL_FALSE,
+                                      0,
+                                      size * buffer.elemSize(),
+                                      hostPointer,
+                                      (waitFor.empty() ? NULL : &waitFor),
+                                      &event);
+    _transferQueue.flush(); // always start operation right away
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  LOG_DEBUG_INFO("Enqueued transfer write buffer for device ", _id,
+                 " (size: ", size * buffer.elemSize(),
+                 ", clBuffer: ", buffer.clBuffer()(),
+                 ", hostPointer: ", hostPointer,
+                 ", waiting for ", waitFor.size(), " events)");
+  return event;
+}
+
+cl::Event Device::enqueueTransferRead(const DeviceBuffer& buffer,
+                                      void* hostPointer,
+                                      size_t size,
+                                      const VECTOR_CLASS<cl::Event>& waitFor
+                                     ) const
+{
+  ASSERT(size <= buffer.size());
+
+  cl::Event event;
+  try {
+    _transferQueue.enqueueReadBuffer(buffer.clBuffer(),
+                                     CL_FALSE,
+                                     0,
+                                     size * buffer.elemSize(),
+                                     hostPointer,
+                                     (waitFor.empty() ? NULL : &waitFor),
+                                     &event);
+    _transferQueue.flush(); // always start operation right away
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+
+  LOG_DEBUG_INFO("Enqueued transfer read buffer for device ", _id,
+                 " (size: ", size * buffer.elemSize(),
+                 ", clBuffer: ", buffer.clBuffer()(),
+                 ", hostPointer: ", hostPointer,
+                 ", waiting for ", waitFor.size(), " events)");
+  return event;
+}
+
 cl::Event Device::enqueueCopy(const DeviceBuffer& from,
                               const DeviceBuffer& to,
                               size_t fromOffset,
@@ -334,6 +475,7 @@ void Device::wait() const
   LOG_DEBUG_INFO("Start waiting for device with id: ", _id);
   try {
     _commandQueue.finish();
+    _transferQueue.finish();
   } catch (cl::Error& err) {
     ABORT_WITH_ERROR(err);
   }
@@ -52,6 +52,7 @@
 
 #include "SkelCL/detail/Device.h"
 #include "SkelCL/detail/DeviceList.h"
+#include "SkelCL/detail/MemoryManager.h"
 
 namespace {
 
@@ -61,15 +62,39 @@ cl::Buffer createCLBuffer(const std::shared_ptr<Device>& devicePtr,
                           const size_t size,
                           const size_t elemSize,
                           cl_mem_flags flags) {
+  // make room for the new buffer, if the budget of the device is exhausted
+  globalMemoryManager.allocate(*devicePtr, size * elemSize);
+
   cl::Buffer buffer;
   try {
     buffer = cl::Buffer(devicePtr->clContext(), flags, size * elemSize);
   } catch (cl::Error& err) {
-    ABORT_WITH_ERROR(err);
+    if (   (   err.err() == CL_MEM_OBJECT_ALLOCATION_FAILURE
+            || err.err() == CL_OUT_OF_RESOURCES)
+        && globalMemoryManager.evict(*devicePtr,
+                                     devicePtr->globalMemSize()) ) {
+      // retry once after evicting all buffers which are not in use
+      try {
+        buffer = cl::Buffer(devicePtr->clContext(), flags, size * elemSize);
+      } catch (cl::Error& err) {
+        ABORT_WITH_ERROR(err);
+      }
+    } else {
+      ABORT_WITH_ERROR(err);
+    }
   }
   return buffer;
 }
 
+void releaseCLBuffer(const std::shared_ptr<Device>& devicePtr,
+                     const size_t size,
+                     const size_t elemSize)
+{
+  if (devicePtr != nullptr && size > 0) {
+    globalMemoryManager.release(*devicePtr, size * elemSize);
+  }
+}
+
 } // namespace
 
 namespace skelcl {
@@ -127,6 +152,8 @@ DeviceBuffer::DeviceBuffer(DeviceBuffer&& rhs)
 DeviceBuffer& DeviceBuffer::operator=(const DeviceBuffer& rhs)
 {
   if (this == &rhs) return *this; // handle self assignement
+  ::releaseCLBuffer(_device, _size, _elemSize);
+  _buffer   = cl::Buffer();
   _device   = rhs._device;
   _size     = rhs._size;
   _elemSize = rhs._elemSize;
@@ -143,6 +170,7 @@ DeviceBuffer& DeviceBuffer::operator=(const DeviceBuffer& rhs)
 DeviceBuffer& DeviceBuffer::operator=(DeviceBuffer&& rhs)
 {
   if (this == &rhs) return *this;
+  ::releaseCLBuffer(_device, _size, _elemSize);
   _device   = std::move(rhs._device);
   _size     = std::move(rhs._size);
   _elemSize = std::move(rhs._elemSize);
@@ -159,6 +187,7 @@ DeviceBuffer& DeviceBuffer::operator=(DeviceBuffer&& rhs)
 
 DeviceBuffer::~DeviceBuffer()
 {
+  ::releaseCLBuffer(_device, _size, _elemSize);
   if (_size == 0) {
     LOG_DEBUG_INFO("Empty DeviceBuffer object (", this, ") destroyed");
   } else {
@@ -0,0 +1,289 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ExpressionNode.cpp
+///
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stooling/SourceCode.h>
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/Source.h"
+
+#include "SkelCL/detail/Device.h"
+#include "SkelCL/detail/ExpressionNode.h"
+#include "SkelCL/detail/Util.h"
+
+namespace {
+
+std::string functionName(size_t index)
+{
+  std::stringstream name;
+  name << "SCL_FUSED_FUNC_" << index;
+  return name.str();
+}
+
+std::string inputName(size_t index)
+{
+  std::stringstream name;
+  name << "SCL_IN_" << index;
+  return name.str();
+}
+
+} // namespace
+
+namespace skelcl {
+
+namespace detail {
+
+ExpressionLeaf::~ExpressionLeaf()
+{
+}
+
+ExpressionNode::ExpressionNode(std::shared_ptr<const ExpressionLeaf> leaf)
+  : _leaf(std::move(leaf)), _source(), _funcName(), _operands(),
+    _workGroupSize(0), _program()
+{
+  ASSERT(_leaf != nullptr);
+}
+
+ExpressionNode::ExpressionNode(const std::string& source,
+                               const std::string& funcName,
+                               std::vector<ptr_type> operands,
+                               size_t workGroupSize)
+  : _leaf(), _source(source), _funcName(funcName),
+    _operands(std::move(operands)), _workGroupSize(workGroupSize),
+    _program()
+{
+  ASSERT_MESSAGE(!_source.empty(),
+                 "Tried to create expression with empty user source.");
+  ASSERT(!_operands.empty());
+  for (auto& operand : _operands) {
+    ASSERT_MESSAGE(operand->size() == _operands.front()->size(),
+                   "All operands of a fused expression must have the same "
+                   "size.");
+  }
+}
+
+ExpressionNode::~ExpressionNode()
+{
+}
+
+size_t ExpressionNode::size() const
+{
+  if (_leaf) {
+    return _leaf->size();
+  }
+  return _operands.front()->size();
+}
+
+size_t ExpressionNode::workGroupSize() const
+{
+  if (_leaf) {
+    return 0;
+  }
+  // the largest work-group size requested by one of the fused skeletons
+  size_t size = _workGroupSize;
+  for (auto& operand : _operands) {
+    size = std::max(size, operand->workGroupSize());
+  }
+  return size;
+}
+
+ExpressionNode::leaves_type ExpressionNode::leaves() const
+{
+  leaves_type leaves;
+  std::vector<const ExpressionNode*> functions;
+  collect(leaves, functions);
+  return leaves;
+}
+
+void ExpressionNode::prepareLeaves(const leaves_type& leaves)
+{
+  ASSERT(!leaves.empty());
+
+  for (auto& leaf : leaves) {
+    leaf->distribute(false);
+  }
+
+  // the fused kernel processes element i of every leaf in the same
+  // work-item, therefore all leaves have to be partitioned alike
+  auto& front = *leaves.front();
+  bool alike = true;
+  for (auto& leaf : leaves) {
+    if (!(leaf->devices() == front.devices())) {
+      alike = false;
+      break;
+    }
+    for (auto& devicePtr : front.devices()) {
+      if (   leaf->deviceBuffer(*devicePtr).size()
+          != front.deviceBuffer(*devicePtr).size()) {
+        alike = false;
+      }
+    }
+  }
+  if (!alike) {
+    LOG_DEBUG_INFO("Redistribute inputs of fused kernel");
+    for (auto& leaf : leaves) {
+      leaf->distribute(true);
+    }
+  }
+
+  for (auto& leaf : leaves) {
+    leaf->startUpload();
+  }
+}
+
+const Program& ExpressionNode::program(const std::string& outputType) const
+{
+  if (_program) {
+    return *_program;
+  }
+
+  leaves_type leaves;
+  std::vector<const ExpressionNode*> functions;
+  collect(leaves, functions);
+
+  // create program
+  // first: device specific functions
+  std::string s(CommonDefinitions::getSource());
+  // second: user defined sources, every function renamed to a unique name
+  for (size_t i = 0; i < functions.size(); ++i) {
+    stooling::SourceCode source(functions[i]->_source);
+    source.renameFunction(functions[i]->_funcName, functionName(i));
+    s.append(source.code());
+    s.append("\n");
+  }
+  // last: the fused kernel evaluating the whole expression per element
+  std::stringstream kernel;
+  kernel << "\n__kernel void SCL_FUSED(\n";
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    kernel << "    const __global " << leaves[i]->typeName() << "* "
+           << inputName(i) << ",\n";
+  }
+  kernel << "          __global " << outputType << "* SCL_OUT,\n"
+         << "    const unsigned int SCL_ELEMENTS)\n"
+         << "{\n"
+         << "  const unsigned int SCL_ID = get_global_id(0);\n"
+         << "  if (SCL_ID < SCL_ELEMENTS) {\n"
+         << "    SCL_OUT[SCL_ID] = " << code(leaves, functions) << ";\n"
+         << "  }\n"
+         << "}\n";
+  s.append(kernel.str());
+
+  _program.reset(new Program(s, util::hash("//Fused\n" + s)));
+  // the user functions are already renamed, so there is nothing to modify
+  // if the binary could not be loaded
+  _program->loadBinary();
+  _program->build();
+
+  LOG_DEBUG_INFO("Fused ", functions.size(), " functions reading ",
+                 leaves.size(), " containers into a single kernel");
+
+  return *_program;
+}
+
+void ExpressionNode::collect(leaves_type& leaves,
+                             std::vector<const ExpressionNode*>& functions)
+                                                                        const
+{
+  if (_leaf) {
+    auto pos = std::find_if(leaves.begin(), leaves.end(),
+                            [this](const std::shared_ptr<const ExpressionLeaf>&
+                                     leaf) {
+                              return leaf->container() == _leaf->container();
+                            });
+    if (pos == leaves.end()) {
+      leaves.push_back(_leaf);
+    }
+    return;
+  }
+
+  for (auto& operand : _operands) {
+    operand->collect(leaves, functions);
+  }
+  // the same user function applied multiple times is only emitted once
+  auto pos = std::find_if(functions.begin(), functions.end(),
+                          [this](const ExpressionNode* function) {
+                            return    function->_source   == _source
+                                   && function->_funcName == _funcName;
+                          });
+  if (pos == functions.end()) {
+    functions.push_back(this);
+  }
+}
+
+std::string ExpressionNode::code(
+                        const leaves_type& leaves,
+                        const std::vector<const ExpressionNode*>& functions)
+                                                                        const
+{
+  if (_leaf) {
+    auto pos = std::find_if(leaves.begin(), leaves.end(),
+                            [this](const std::shared_ptr<const ExpressionLeaf>&
+                                     leaf) {
+                              return leaf->container() == _leaf->container();
+                            });
+    ASSERT(pos != leaves.end());
+    return inputName(static_cast<size_t>(pos - leaves.begin())) + "[SCL_ID]";
+  }
+
+  auto pos = std::find_if(functions.begin(), functions.end(),
+                          [this](const ExpressionNode* function) {
+                            return    function->_source   == _source
+                                   && function->_funcName == _funcName;
+                          });
+  ASSERT(pos != functions.end());
+
+  std::string call(functionName(static_cast<size_t>(pos - functions.begin())));
+  call.append("(");
+  for (size_t i = 0; i < _operands.size(); ++i) {
+    if (i > 0) call.append(", ");
+    call.append(_operands[i]->code(leaves, functions));
+  }
+  call.append(")");
+  return call;
+}
+
+} // namespace detail
+
+} // namespace skelcl
@@ -180,6 +180,12 @@ std::vector<IndexPoint>& Matrix<IndexPoint>::hostBuffer() const
   return v;
 }
 
+IndexPoint* Matrix<IndexPoint>::hostData() const
+{
+  ASSERT_MESSAGE(false, "This function should never be called!");
+  return nullptr;
+}
+
 void Matrix<IndexPoint>::dataOnDeviceModified() const
 {
   ASSERT_MESSAGE(false, "This function should never be called!");
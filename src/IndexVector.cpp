@@ -190,6 +190,12 @@ namespace skelcl {
     return v;
   }
   
+  Index* Vector<Index>::hostData() const
+  {
+    ASSERT_MESSAGE(false, "This function should never be called!");
+    return nullptr;
+  }
+  
   void Vector<Index>::dataOnDeviceModified() const
   {
     ASSERT_MESSAGE(false, "This function should never be called!");
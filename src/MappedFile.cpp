@@ -0,0 +1,162 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file MappedFile.cpp
+///
+
+#include <string>
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/detail/MappedFile.h"
+
+namespace skelcl {
+
+namespace detail {
+
+#ifndef _WIN32
+namespace {
+
+// closes the file descriptor when leaving the scope, including error exits
+class FileDescriptorGuard {
+public:
+  explicit FileDescriptorGuard(int fd) : _fd(fd) {}
+  ~FileDescriptorGuard() { ::close(_fd); }
+private:
+  FileDescriptorGuard(const FileDescriptorGuard&);
+  FileDescriptorGuard& operator=(const FileDescriptorGuard&);
+
+  int _fd;
+};
+
+} // namespace
+#endif
+
+MappedFile::MappedFile(const std::string& path,
+                       MapMode mode,
+                       size_t sizeInBytes)
+  : _path(path), _sizeInBytes(sizeInBytes), _data(nullptr)
+{
+#ifdef _WIN32
+  (void)mode;
+  ABORT_WITH_ERROR("Mapping files is not supported on this platform");
+#else
+  int flags = O_RDONLY;
+  if (mode == MapMode::READ_WRITE) flags = O_RDWR;
+  if (mode == MapMode::CREATE)     flags = O_RDWR | O_CREAT | O_TRUNC;
+
+  int fd = ::open(path.c_str(), flags, 0644);
+  if (fd == -1) {
+    ABORT_WITH_ERROR("Could not open file " + path + ": "
+                     + std::strerror(errno));
+  }
+  // the mapping stays valid after closing the file descriptor
+  FileDescriptorGuard guard(fd);
+
+  if (mode == MapMode::CREATE) {
+    if (::ftruncate(fd, static_cast<off_t>(_sizeInBytes)) == -1) {
+      ABORT_WITH_ERROR("Could not resize file " + path + ": "
+                       + std::strerror(errno));
+    }
+  } else {
+    struct stat info;
+    if (::fstat(fd, &info) == -1) {
+      ABORT_WITH_ERROR("Could not query size of file " + path + ": "
+                       + std::strerror(errno));
+    }
+    auto fileSize = static_cast<size_t>(info.st_size);
+    if (_sizeInBytes == 0) {
+      _sizeInBytes = fileSize;
+    }
+    if (_sizeInBytes > fileSize) {
+      ABORT_WITH_ERROR("File " + path + " is smaller than the requested size");
+    }
+  }
+
+  if (_sizeInBytes > 0) {
+    // READ maps privately, so that downloads into the mapping do not modify
+    // the file
+    void* data = ::mmap(nullptr, _sizeInBytes, PROT_READ | PROT_WRITE,
+                        (mode == MapMode::READ ? MAP_PRIVATE : MAP_SHARED),
+                        fd, 0);
+    if (data == MAP_FAILED) {
+      ABORT_WITH_ERROR("Could not map file " + path + ": "
+                       + std::strerror(errno));
+    }
+    _data = data;
+  }
+#endif
+  LOG_DEBUG_INFO("Mapped file ", _path, " (", _sizeInBytes, " bytes) to ",
+                 _data);
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (_data != nullptr) {
+    ::munmap(_data, _sizeInBytes);
+  }
+#endif
+  LOG_DEBUG_INFO("Unmapped file ", _path);
+}
+
+void* MappedFile::data() const
+{
+  return _data;
+}
+
+size_t MappedFile::sizeInBytes() const
+{
+  return _sizeInBytes;
+}
+
+const std::string& MappedFile::path() const
+{
+  return _path;
+}
+
+} // namespace detail
+
+} // namespace skelcl
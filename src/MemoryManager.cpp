@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file MemoryManager.cpp
+///
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/detail/MemoryManager.h"
+
+#include "SkelCL/detail/Device.h"
+#include "SkelCL/detail/Util.h"
+
+namespace skelcl {
+
+namespace detail {
+
+SKELCL_DLL MemoryManager globalMemoryManager;
+
+MemoryManager::MemoryManager()
+  : _entries(), _index(), _used(), _generation(0), _budget(0)
+{
+  auto budgetInMB = util::envVarValue("SKELCL_DEVICE_MEMORY_BUDGET");
+  if (!budgetInMB.empty()) {
+    _budget = std::strtoul(budgetInMB.c_str(), nullptr, 10) * 1024 * 1024;
+  }
+}
+
+void MemoryManager::allocate(const Device& device, size_t sizeInBytes)
+{
+  if (usedMemory(device) + sizeInBytes > budget(device)) {
+    evict(device, sizeInBytes);
+  }
+  _used[device.id()] += sizeInBytes;
+}
+
+void MemoryManager::release(const Device& device, size_t sizeInBytes)
+{
+  auto& used = _used[device.id()];
+  ASSERT(used >= sizeInBytes);
+  used -= sizeInBytes;
+}
+
+void MemoryManager::use(const void* owner,
+                        const std::vector<Device::id_type>& devices,
+                        evict_function evict)
+{
+  auto iter = _index.find(owner);
+  if (iter != _index.end()) {
+    _entries.erase(iter->second);
+  }
+  _entries.push_back( { owner, devices, std::move(evict), _generation } );
+  _index[owner] = std::prev(_entries.end());
+}
+
+void MemoryManager::remove(const void* owner)
+{
+  auto iter = _index.find(owner);
+  if (iter == _index.end()) return;
+  _entries.erase(iter->second);
+  _index.erase(iter);
+}
+
+void MemoryManager::kernelEnqueued()
+{
+  ++_generation;
+}
+
+bool MemoryManager::evict(const Device& device, size_t sizeInBytes)
+{
+  bool evicted = false;
+  auto iter = _entries.begin();
+  while (   iter != _entries.end()
+         && usedMemory(device) + sizeInBytes > budget(device) ) {
+    auto& entry = *iter;
+    if (   entry.lastUse == _generation // still in use
+        || std::find(entry.devices.begin(), entry.devices.end(),
+                     device.id()) == entry.devices.end() ) {
+      ++iter;
+      continue;
+    }
+    // unregister first, as evicting releases device buffers
+    auto evictFunction = std::move(entry.evict);
+    LOG_DEBUG_INFO("Evict device buffers of (", entry.owner,
+                   ") from device ", device.id());
+    _index.erase(entry.owner);
+    iter = _entries.erase(iter);
+
+    evictFunction();
+    evicted = true;
+  }
+
+  if (usedMemory(device) + sizeInBytes > budget(device)) {
+    LOG_WARNING("Memory budget of device ", device.id(), " exceeded (used: ",
+                usedMemory(device), " bytes, requested: ", sizeInBytes,
+                " bytes, budget: ", budget(device), " bytes)");
+  }
+  return evicted;
+}
+
+size_t MemoryManager::usedMemory(const Device& device) const
+{
+  auto iter = _used.find(device.id());
+  if (iter == _used.end()) return 0;
+  return iter->second;
+}
+
+size_t MemoryManager::budget(const Device& device) const
+{
+  if (_budget != 0) return _budget;
+  return device.globalMemSize();
+}
+
+} // namespace detail
+
+} // namespace skelcl
@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file ReduceHelper.cpp
+///
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/detail/ReduceHelper.h"
+
+#include "SkelCL/detail/Device.h"
+#include "SkelCL/detail/DeviceBuffer.h"
+#include "SkelCL/detail/Event.h"
+#include "SkelCL/detail/Program.h"
+#include "SkelCL/detail/Util.h"
+
+namespace skelcl {
+
+namespace detail {
+
+namespace reduceHelper {
+
+size_t localSize(const Program& program, const Device& device,
+                 const std::string& kernelName, size_t workGroupSize)
+{
+  cl::Kernel kernel = program.kernel(device, kernelName);
+
+  const size_t max_local_size =
+      kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device.clDevice());
+  return std::min(workGroupSize, max_local_size);
+}
+
+size_t numberOfGroups(const Device& device, size_t localSize, size_t items)
+{
+  // enough work-groups to keep every compute unit busy ...
+  const size_t groups_per_unit =
+      std::max<size_t>(1, device.maxWorkGroupSize() / localSize);
+  const size_t groups = device.maxComputeUnits() * groups_per_unit;
+
+  // ... but every work-group has to process at least one item
+  return std::max<size_t>(1,
+      std::min(groups, util::devideAndRoundUp(items, localSize)));
+}
+
+void reducePartials(const Program& program, const Device& device,
+                    const DeviceBuffer& input, const DeviceBuffer& output,
+                    size_t elements, size_t workGroupSize)
+{
+  try {
+    // a single work-group combines all partial results
+    const size_t local_size = localSize(program, device,
+                                        "SCL_REDUCE_PARTIALS", workGroupSize);
+
+    cl::Kernel kernel = program.kernel(device, "SCL_REDUCE_PARTIALS");
+    kernel.setArg(0, input.clBuffer());
+    kernel.setArg(1, output.clBuffer());
+    kernel.setArg(2, cl::__local(local_size * output.elemSize()));
+    kernel.setArg(3, static_cast<cl_uint>(elements));
+
+    device.enqueue(kernel, cl::NDRange(local_size), cl::NDRange(local_size));
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+}
+
+DeviceBuffer gatherPartials(const std::vector<DeviceBuffer>& partials,
+                            const std::shared_ptr<Device>& target)
+{
+  ASSERT(!partials.empty());
+  const size_t elemSize = partials.front().elemSize();
+
+  // only a single value is downloaded from every device
+  std::vector<char> values(partials.size() * elemSize);
+  Event events;
+  for (size_t i = 0; i < partials.size(); ++i) {
+    ASSERT(partials[i].size() == 1 && partials[i].elemSize() == elemSize);
+    events.insert(partials[i].devicePtr()->enqueueRead(
+                    partials[i], static_cast<void*>(values.data()), i));
+  }
+  events.wait();
+
+  DeviceBuffer buffer(target, partials.size(), elemSize);
+  target->enqueueWrite(buffer, static_cast<const void*>(values.data())).wait();
+  return buffer;
+}
+
+void combineDevicePartials(const Program& program,
+                           const std::vector<DeviceBuffer>& partials,
+                           const DeviceBuffer& output,
+                           size_t workGroupSize)
+{
+  LOG_DEBUG_INFO("Combine ", partials.size(), " partial results");
+
+  auto target = output.devicePtr();
+  auto buffer = gatherPartials(partials, target);
+  reducePartials(program, *target, buffer, output, partials.size(),
+                 workGroupSize);
+}
+
+} // namespace reduceHelper
+
+} // namespace detail
+
+} // namespace skelcl
@@ -0,0 +1,190 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file Streaming.cpp
+///
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+#undef  __CL_ENABLE_EXCEPTIONS
+
+#include <pvsutil/Assert.h>
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/detail/Streaming.h"
+
+#include "SkelCL/detail/Device.h"
+#include "SkelCL/detail/DeviceBuffer.h"
+#include "SkelCL/detail/DeviceList.h"
+#include "SkelCL/detail/Util.h"
+
+namespace {
+
+size_t chunkSizeOverride()
+{
+  auto value = skelcl::detail::util::envVarValue("SKELCL_CHUNK_SIZE");
+  if (value.empty()) return 0;
+  return static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10));
+}
+
+} // namespace
+
+namespace skelcl {
+
+namespace detail {
+
+namespace streaming {
+
+size_t chunkSize(const Device& device, size_t bytesPerElement)
+{
+  ASSERT(bytesPerElement > 0);
+
+  auto size = chunkSizeOverride();
+  if (size > 0) return size;
+
+  auto bytes = std::min(device.maxMemAllocSize(), device.globalMemSize() / 4);
+  return std::max<size_t>(bytes / bytesPerElement, 1);
+}
+
+bool isRequired(size_t elements, size_t bytesPerElement)
+{
+  ASSERT(bytesPerElement > 0);
+  ASSERT(!globalDeviceList.empty());
+
+  auto size = chunkSizeOverride();
+  if (size > 0) return (elements > size);
+
+  // every device stores at most its share of the elements
+  auto share = util::devideAndRoundUp(elements, globalDeviceList.size());
+  for (auto& devicePtr : globalDeviceList) {
+    auto bytes = std::min(devicePtr->maxMemAllocSize(),
+                          devicePtr->globalMemSize() / 2);
+    if (share > bytes / bytesPerElement) return true;
+  }
+  return false;
+}
+
+void process(size_t elements, size_t bytesPerElement,
+      const std::function<Events(const Chunk&, const Events&)>& upload,
+      const std::function<cl::Event(const Chunk&, const Events&)>& compute,
+      const std::function<cl::Event(const Chunk&, const Events&)>& download)
+{
+  ASSERT(!globalDeviceList.empty());
+
+  // split elements into chunks, which are assigned round robin to the devices
+  std::vector<std::vector<Chunk>> chunks(globalDeviceList.size());
+  size_t offset = 0;
+  size_t index  = 0;
+  while (offset < elements) {
+    auto id = index % globalDeviceList.size();
+    auto& devicePtr = globalDeviceList[id];
+    auto size = std::min(chunkSize(*devicePtr, bytesPerElement),
+                         elements - offset);
+    chunks[id].push_back( { devicePtr, index, offset, size,
+                            chunks[id].size() % 2 } );
+    offset += size;
+    ++index;
+  }
+
+  LOG_DEBUG_INFO("Streaming ", elements, " elements in ", index, " chunks");
+
+  Events downloads;
+  for (auto& deviceChunks : chunks) {
+    if (deviceChunks.empty()) continue;
+
+    std::vector<Events>    uploaded(deviceChunks.size());
+    std::vector<cl::Event> released(deviceChunks.size());
+
+    uploaded[0] = upload(deviceChunks[0], Events());
+    for (size_t i = 0; i < deviceChunks.size(); ++i) {
+      auto computed = compute(deviceChunks[i], uploaded[i]);
+
+      // upload the next chunk while the current one is processed, as soon as
+      // the chunk previously using the same slot has been downloaded
+      if (i + 1 < deviceChunks.size()) {
+        Events waitFor;
+        if (i > 0) waitFor.push_back(released[i - 1]);
+        uploaded[i + 1] = upload(deviceChunks[i + 1], waitFor);
+      }
+
+      released[i] = download(deviceChunks[i], Events(1, computed));
+      downloads.push_back(released[i]);
+    }
+  }
+
+  try {
+    cl::Event::waitForEvents(downloads);
+  } catch (cl::Error& err) {
+    ABORT_WITH_ERROR(err);
+  }
+}
+
+Buffers::Buffers(size_t elemSize, size_t bytesPerElement)
+  : _elemSize(elemSize), _bytesPerElement(bytesPerElement), _fixedSize(0),
+    _buffers()
+{
+}
+
+Buffers Buffers::withFixedSize(size_t elemSize, size_t size)
+{
+  Buffers buffers(elemSize, elemSize);
+  buffers._fixedSize = size;
+  return buffers;
+}
+
+DeviceBuffer& Buffers::operator[](const Chunk& chunk)
+{
+  auto& buffer = _buffers[std::make_pair(chunk.devicePtr->id(), chunk.slot)];
+  if (!buffer.isValid()) {
+    auto size = (_fixedSize > 0 ? _fixedSize
+                                : chunkSize(*chunk.devicePtr, _bytesPerElement));
+    buffer = DeviceBuffer(chunk.devicePtr, size, _elemSize);
+  }
+  return buffer;
+}
+
+} // namespace streaming
+
+} // namespace detail
+
+} // namespace skelcl
@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+ 
+///
+/// \file Tuning.cpp
+///
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <pvsutil/Logger.h>
+
+#include "SkelCL/detail/Tuning.h"
+
+#include "SkelCL/detail/Device.h"
+#include "SkelCL/detail/Util.h"
+
+namespace {
+
+std::string tuningFilename()
+{
+  auto filename = skelcl::detail::util::envVarValue("SKELCL_TUNING_FILE");
+  if (filename.empty()) return ".skelcl-tuning";
+  return filename;
+}
+
+// results read from or written to the tuning file, the file is read on first
+// access
+std::map<std::string, std::string>& results()
+{
+  static std::map<std::string, std::string> results;
+  static bool loaded = false;
+  if (!loaded) {
+    loaded = true;
+    std::ifstream file(tuningFilename());
+    std::string line;
+    while (std::getline(file, line)) {
+      auto pos = line.find(' ');
+      if (pos == std::string::npos) continue;
+      // later entries overwrite earlier ones
+      results[line.substr(0, pos)] = line.substr(pos + 1);
+    }
+  }
+  return results;
+}
+
+} // namespace
+
+namespace skelcl {
+
+namespace detail {
+
+namespace tuning {
+
+AllPairsConfig::AllPairsConfig(unsigned int kernel, unsigned int C,
+                               unsigned int R, unsigned int S, unsigned int D,
+                               unsigned int W)
+  : kernel(kernel), C(C), R(R), S(S), D(D), W(W)
+{
+}
+
+unsigned int AllPairsConfig::workGroupSize(size_t dim) const
+{
+  if (kernel == GEMM) {
+    return dim == 0 ? C / W : R / S;
+  }
+  return dim == 0 ? C : R;
+}
+
+size_t AllPairsConfig::localMemSize(size_t leftElemSize,
+                                    size_t rightElemSize) const
+{
+  switch (kernel) {
+  case TILED:   return R * D * leftElemSize + D * C * rightElemSize;
+  case SQUARE:  return C * C * (leftElemSize + rightElemSize);
+  // two buffers per tile
+  case GEMM:    return 2 * D * (R * leftElemSize + C * rightElemSize);
+  default:      return 0;
+  }
+}
+
+std::string AllPairsConfig::toString() const
+{
+  std::stringstream s;
+  s << kernel << " " << C << " " << R << " " << S << " " << D << " " << W;
+  return s.str();
+}
+
+bool AllPairsConfig::fromString(const std::string& string,
+                                AllPairsConfig& config)
+{
+  std::stringstream s(string);
+  AllPairsConfig c;
+  s >> c.kernel >> c.C >> c.R >> c.S >> c.D >> c.W;
+  if (s.fail() || c.kernel < TILED || c.kernel > GEMM) return false;
+  config = c;
+  return true;
+}
+
+std::vector<AllPairsConfig> allPairsCandidates(const Device& device,
+                                               AllPairsConfig::Kernel kernel,
+                                               size_t leftElemSize,
+                                               size_t rightElemSize)
+{
+  std::vector<AllPairsConfig> candidates;
+  if (kernel == AllPairsConfig::GENERIC) {
+    const unsigned int sizes[][2] = { {16, 16}, {32, 8}, {64, 4}, {8, 8},
+                                      {32, 4}, {128, 1}, {256, 1} };
+    for (auto& size : sizes) {
+      candidates.push_back(AllPairsConfig(AllPairsConfig::GENERIC,
+                                          size[0], size[1], 1, 1));
+    }
+  } else if (kernel == AllPairsConfig::GEMM) {
+    for (unsigned int tile : {32u, 64u, 128u}) {
+      for (unsigned int D : {8u, 16u}) {
+        for (unsigned int S : {2u, 4u, 8u}) {
+          for (unsigned int W : {2u, 4u, 8u}) {
+            candidates.push_back(AllPairsConfig(AllPairsConfig::GEMM,
+                                                tile, tile, S, D, W));
+          }
+        }
+      }
+    }
+  } else {
+    for (unsigned int C : {16u, 32u, 64u}) {
+      for (unsigned int R : {4u, 8u, 16u}) {
+        for (unsigned int S : {1u, 8u, 16u}) {
+          for (unsigned int D : {16u, 32u}) {
+            candidates.push_back(AllPairsConfig(AllPairsConfig::TILED,
+                                                C, R, S, D));
+          }
+        }
+      }
+    }
+    for (unsigned int size : {8u, 16u, 32u}) {
+      candidates.push_back(AllPairsConfig(AllPairsConfig::SQUARE,
+                                          size, size, 1, size));
+    }
+  }
+
+  // remove configurations exceeding the limits of the device
+  candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+        [&](const AllPairsConfig& c) {
+          auto size = c.workGroupSize(0) * c.workGroupSize(1);
+          return size > device.maxWorkGroupSize()
+              || size < 16 // too few work-items
+              || c.localMemSize(leftElemSize, rightElemSize)
+                   > device.localMemSize();
+        }), candidates.end());
+  return candidates;
+}
+
+bool isEnabled()
+{
+  auto value = util::envVarValue("SKELCL_AUTOTUNE");
+  return !value.empty() && value != "0";
+}
+
+std::string shapeClass(const std::vector<size_t>& extents)
+{
+  std::stringstream s;
+  for (size_t i = 0; i < extents.size(); ++i) {
+    unsigned int log4 = 0;
+    for (size_t n = extents[i]; n >= 4; n /= 4) ++log4;
+    s << (i > 0 ? "x" : "") << log4;
+  }
+  return s.str();
+}
+
+std::string key(const Device& device, const std::string& id,
+                const std::string& shapeClass)
+{
+  // escape spaces in device name
+  std::string devName = device.name();
+  std::replace(devName.begin(), devName.end(), ' ', '_');
+  return id + "-" + devName + "-" + shapeClass;
+}
+
+bool lookup(const std::string& key, std::string& value)
+{
+  auto& r = results();
+  auto iter = r.find(key);
+  if (iter == r.end()) return false;
+  value = iter->second;
+  return true;
+}
+
+void store(const std::string& key, const std::string& value)
+{
+  results()[key] = value;
+
+  std::ofstream file(tuningFilename(), std::ios_base::app);
+  file << key << " " << value << "\n";
+  if (file.fail()) {
+    LOG_WARNING("Failed to store tuning result in ", tuningFilename());
+  } else {
+    LOG_DEBUG_INFO("Stored tuning result ", key, ": ", value);
+  }
+}
+
+} // namespace tuning
+
+} // namespace detail
+
+} // namespace skelcl
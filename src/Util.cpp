@@ -37,11 +37,14 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <algorithm>
 #include <iomanip>
 #include <ios>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include <cctype>
 #include <cmath>
 #include <cstdlib>
 
@@ -228,6 +231,60 @@ int ceilPow2(int n)
   return 1 << exp;
 }
 
+bool isBinaryOperation(const std::string& source, const std::string& func,
+                       const std::string& op)
+{
+  auto isIdentifierChar = [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  };
+  auto removeSpaces = [](std::string s) {
+    s.erase(std::remove_if(s.begin(), s.end(),
+                           [](char c) {
+                             return std::isspace(static_cast<unsigned char>(c));
+                           }),
+            s.end());
+    return s;
+  };
+
+  // find the definition of func
+  size_t pos = source.find(func);
+  while (pos != std::string::npos) {
+    auto next = source.find_first_not_of(" \t\r\n", pos + func.size());
+    bool isDefinition = (pos == 0 || !isIdentifierChar(source[pos - 1]))
+                     && next != std::string::npos && source[next] == '(';
+    if (isDefinition) break;
+    pos = source.find(func, pos + 1);
+  }
+  if (pos == std::string::npos) return false;
+
+  auto open  = source.find('(', pos);
+  auto close = source.find(')', open);
+  if (close == std::string::npos) return false;
+
+  // the names of the two parameters
+  std::vector<std::string> names;
+  std::stringstream params(source.substr(open + 1, close - open - 1));
+  std::string param;
+  while (std::getline(params, param, ',')) {
+    auto end = param.find_last_not_of(" \t\r\n");
+    if (end == std::string::npos) return false;
+    auto begin = end;
+    while (begin > 0 && isIdentifierChar(param[begin - 1])) --begin;
+    names.push_back(param.substr(begin, end - begin + 1));
+  }
+  if (names.size() != 2) return false;
+
+  // the body has to consist of the single return statement
+  auto body = removeSpaces(source.substr(close + 1));
+  for (auto& expr : { names[0] + op + names[1], names[1] + op + names[0] }) {
+    if (   body == "{return" + expr + ";}"
+        || body == "{return(" + expr + ");}") {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace util
 
 } // namespace detail
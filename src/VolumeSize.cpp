@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+///
+/// \file VolumeSize.cpp
+///
+
+#include "SkelCL/Volume.h"
+
+namespace skelcl {
+
+// VolumeSize
+
+VolumeSize::VolumeSize(size_type sliceCount, size_type rowCount,
+                       size_type columnCount)
+: _sliceCount(sliceCount), _rowCount(rowCount), _columnCount(columnCount)
+{
+}
+
+VolumeSize::size_type VolumeSize::elemCount() const
+{
+  return (_sliceCount * _rowCount * _columnCount);
+}
+
+VolumeSize::size_type VolumeSize::sliceSize() const
+{
+  return (_rowCount * _columnCount);
+}
+
+VolumeSize::size_type VolumeSize::sliceCount() const
+{
+  return _sliceCount;
+}
+
+VolumeSize::size_type VolumeSize::rowCount() const
+{
+  return _rowCount;
+}
+
+VolumeSize::size_type VolumeSize::columnCount() const
+{
+  return _columnCount;
+}
+
+bool VolumeSize::operator==(const VolumeSize& rhs) const
+{
+  return (   (_sliceCount  == rhs._sliceCount)
+          && (_rowCount    == rhs._rowCount)
+          && (_columnCount == rhs._columnCount) );
+}
+
+bool VolumeSize::operator!=(const VolumeSize& rhs) const
+{
+  return !this->operator==(rhs);
+}
+
+} // namespace skelcl
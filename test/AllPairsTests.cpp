@@ -35,8 +35,11 @@
 /// \author Malte Friese <malte.friese@uni-muenster.de>
 ///
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <string>
 #include <vector>
 
 #include <pvsutil/Logger.h>
@@ -47,6 +50,8 @@
 #include <SkelCL/Zip.h>
 #include <SkelCL/Reduce.h>
 
+#include <SkelCL/detail/DeviceList.h>
+
 #include "Test.h"
 /// \cond
 /// Don't show this test in doxygen
@@ -89,6 +94,150 @@ TEST_F(AllPairsTest, ArbitraryMatrices) {
     testAllPairsWithMatrices(100, 60, 11);
 }
 
+// Tests the selection of the kernel configuration by benchmarking
+TEST_F(AllPairsTest, Autotuning) {
+    const char* path = "AllPairsTest_Autotuning.tuning";
+    std::remove(path);
+    setenv("SKELCL_AUTOTUNE", "1", 1);
+    setenv("SKELCL_TUNING_FILE", path, 1);
+
+    testAllPairsWithMatrices(100, 60, 11);
+
+    unsetenv("SKELCL_AUTOTUNE");
+    unsetenv("SKELCL_TUNING_FILE");
+
+    // the selected configuration has been persisted
+    std::ifstream file(path);
+    std::string line;
+    EXPECT_TRUE(std::getline(file, line));
+    EXPECT_FALSE(line.empty());
+    std::remove(path);
+}
+
+// Tests the register blocked kernel with double precision
+TEST_F(AllPairsTest, MatrixMultiplicationDouble) {
+    if (!skelcl::detail::globalDeviceList.front()->supportsDouble()) return;
+
+    skelcl::Zip<double(double, double)> zip("double func(double x, double y){ return x * y; }");
+    skelcl::Reduce<double(double)> reduce("double func(double x, double y){ return x + y; }");
+    skelcl::AllPairs<double(double, double)> allpairs(reduce, zip);
+
+    const size_t height = 70, dim = 45, width = 90;
+    skelcl::Matrix<double> left(skelcl::MatrixSize(height, dim));
+    skelcl::Matrix<double> right(skelcl::MatrixSize(dim, width));
+    for (size_t i = 0; i < height; ++i)
+        for (size_t k = 0; k < dim; ++k)
+            left[i][k] = static_cast<double>(rand() % 100);
+    for (size_t k = 0; k < dim; ++k)
+        for (size_t j = 0; j < width; ++j)
+            right[k][j] = static_cast<double>(rand() % 101);
+
+    skelcl::Matrix<double> output = allpairs(left, right);
+
+    for (size_t i = 0; i < height; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+            double tmp = 0;
+            for (size_t k = 0; k < dim; ++k) {
+                tmp += left[i][k] * right[k][j];
+            }
+            EXPECT_EQ(tmp, output[i][j]);
+        }
+    }
+}
+
+// Tests the matrix multiplication kernel with differently named functions
+TEST_F(AllPairsTest, MatrixMultiplicationWithNamedFunctions) {
+    skelcl::Zip<float(float, float)> zip("float mult(float x, float y){ return x * y; }", "mult");
+    skelcl::Reduce<float(float)> reduce("float add(float x, float y){ return x + y; }", "0", "add");
+    skelcl::AllPairs<float(float, float)> allpairs(reduce, zip);
+
+    skelcl::Matrix<float> left(skelcl::MatrixSize(40, 12), 2.0f);
+    skelcl::Matrix<float> right(skelcl::MatrixSize(12, 36), 3.0f);
+
+    skelcl::Matrix<float> output = allpairs(left, right);
+
+    for (size_t i = 0; i < 40; ++i) {
+        for (size_t j = 0; j < 36; ++j) {
+            EXPECT_EQ(12 * 6, output[i][j]);
+        }
+    }
+}
+
+// Tests a customization which is no matrix multiplication
+TEST_F(AllPairsTest, SquaredDistances) {
+    skelcl::Zip<float(float, float)> zip("float func(float x, float y){ return (x - y) * (x - y); }");
+    skelcl::Reduce<float(float)> reduce("float func(float x, float y){ return x + y; }");
+    skelcl::AllPairs<float(float, float)> allpairs(reduce, zip);
+
+    skelcl::Matrix<float> left(skelcl::MatrixSize(20, 7), 3.0f);
+    skelcl::Matrix<float> right(skelcl::MatrixSize(7, 30), 1.0f);
+
+    skelcl::Matrix<float> output = allpairs(left, right);
+
+    for (size_t i = 0; i < 20; ++i) {
+        for (size_t j = 0; j < 30; ++j) {
+            EXPECT_EQ(7 * 4, output[i][j]);
+        }
+    }
+}
+
+// Tests blocks of rows on all devices with the right matrix reused
+TEST_F(AllPairsTest, MultiDeviceRowBlocks) {
+    // use all available devices
+    skelcl::terminate();
+    skelcl::init(skelcl::allDevices());
+
+    testAllPairsWithMatrices(256, 40, 96);
+}
+
+// Tests blocks of columns on all devices for a wide output
+TEST_F(AllPairsTest, MultiDeviceWideOutput) {
+    // use all available devices
+    skelcl::terminate();
+    skelcl::init(skelcl::allDevices());
+
+    testAllPairsWithMatrices(3, 50, 1000);
+}
+
+// Tests that the right matrix stays on the devices between executions
+TEST_F(AllPairsTest, RightMatrixIsReused) {
+    skelcl::terminate();
+    skelcl::init(skelcl::allDevices());
+
+    skelcl::Zip<float(float, float)> zip("float func(float x, float y){ return x*y; }");
+    skelcl::Reduce<float(float)> reduce("float func(float x, float y){ return x+y; }");
+    skelcl::AllPairs<float(float, float)> allpairs(reduce, zip);
+
+    skelcl::Matrix<float> right(skelcl::MatrixSize(32, 64), 2.0f);
+    std::vector<cl_mem> buffers;
+
+    for (int i = 1; i <= 3; ++i) {
+        skelcl::Matrix<float> left(skelcl::MatrixSize(128, 32),
+                                  static_cast<float>(i));
+        skelcl::Matrix<float> output = allpairs(left, right);
+
+        // the right matrix has been uploaded once and is still valid
+        EXPECT_TRUE(right.devicesAreUpToDate());
+        EXPECT_EQ(i * 2 * 32, output[127][63]);
+
+        // the device buffers of the right matrix are kept ...
+        auto& devices = right.distribution().devices();
+        for (size_t d = 0; d < devices.size(); ++d) {
+            cl_mem buffer = right.deviceBuffer(*devices[d]).clBuffer()();
+            if (i == 1) {
+                buffers.push_back(buffer);
+            } else {
+                EXPECT_EQ(buffers[d], buffer);
+            }
+        }
+
+        // ... and not uploaded again: the host data is changed behind the
+        // back of the matrix, a new upload would use the new values
+        std::fill(right.hostData(),
+                  right.hostData() + right.size().elemCount(), 5.0f);
+    }
+}
+
 // M * N = D
 //----------------
 // M: height x dim
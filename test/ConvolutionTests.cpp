@@ -0,0 +1,165 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/Matrix.h>
+#include <SkelCL/Convolution.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class ConvolutionTest : public ::testing::Test {
+protected:
+  ConvolutionTest() {
+    //pvsutil::defaultLogger.setLoggingLevel(
+    //    pvsutil::Logger::Severity::DebugInfo);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~ConvolutionTest() {
+    skelcl::terminate();
+  }
+};
+
+// computes the separable convolution on the host, indices outside of the
+// matrix are remapped by the given function
+template <typename T, typename Remap>
+std::vector<T> reference(const std::vector<T>& in, int rows, int cols,
+                         const std::vector<T>& rc, const std::vector<T>& cc,
+                         Remap remap)
+{
+  const int rx = static_cast<int>(rc.size() / 2);
+  const int ry = static_cast<int>(cc.size() / 2);
+  std::vector<T> out(in.size());
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      T sum = 0;
+      for (int j = -ry; j <= ry; ++j) {
+        for (int i = -rx; i <= rx; ++i) {
+          sum += cc[j + ry] * rc[i + rx] *
+                 in[remap(y + j, rows) * cols + remap(x + i, cols)];
+        }
+      }
+      out[y * cols + x] = sum;
+    }
+  }
+  return out;
+}
+
+int nearest(int i, int n) { return std::min(std::max(i, 0), n - 1); }
+
+int periodic(int i, int n) { return (i % n + n) % n; }
+
+TEST_F(ConvolutionTest, CreateConvolution) {
+  skelcl::Convolution<float(float)> c({0.25f, 0.5f, 0.25f},
+                                      {0.25f, 0.5f, 0.25f});
+}
+
+TEST_F(ConvolutionTest, SeparableNearest) {
+  const std::vector<int> coefficients = {1, 2, 1};
+  skelcl::Convolution<int(int)> c(coefficients, coefficients);
+
+  const int rows = 37;
+  const int cols = 45;
+  std::vector<int> data(rows * cols);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int>((i * 7) % 13);
+  }
+  skelcl::Matrix<int> m(data, skelcl::MatrixSize(rows, cols));
+
+  skelcl::Matrix<int> o = c(m);
+
+  auto expected = reference(data, rows, cols, coefficients, coefficients,
+                            nearest);
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      EXPECT_EQ(expected[y * cols + x], o[y][x]);
+    }
+  }
+}
+
+TEST_F(ConvolutionTest, NeutralWithDifferentRadii) {
+  // 1x5 box filter along the rows, zero outside of the matrix
+  skelcl::Convolution<int(int)> c({1, 1, 1, 1, 1}, {1},
+                                  skelcl::detail::Padding::NEUTRAL, 0);
+
+  skelcl::Matrix<int> m({8, 10}, 1);
+
+  skelcl::Matrix<int> o = c(m);
+
+  for (int y = 0; y < 8; ++y) {
+    for (int x = 0; x < 10; ++x) {
+      EXPECT_EQ(std::min(x, 2) + std::min(9 - x, 2) + 1, o[y][x]);
+    }
+  }
+}
+
+TEST_F(ConvolutionTest, BlurPeriodicMultiDevice) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  // normalized binomial filter of radius 4
+  const std::vector<float> coefficients = {1.0f/256, 8.0f/256, 28.0f/256,
+                                           56.0f/256, 70.0f/256, 56.0f/256,
+                                           28.0f/256, 8.0f/256, 1.0f/256};
+  skelcl::Convolution<float(float)> c(coefficients, coefficients,
+                                      skelcl::detail::Padding::PERIODIC);
+
+  const int rows = 128;
+  const int cols = 100;
+  std::vector<float> data(rows * cols);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 31) % 17);
+  }
+  skelcl::Matrix<float> m(data, skelcl::MatrixSize(rows, cols));
+
+  skelcl::Matrix<float> o = c(m);
+
+  auto expected = reference(data, rows, cols, coefficients, coefficients,
+                            periodic);
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      EXPECT_NEAR(expected[y * cols + x], o[y][x], 1e-4);
+    }
+  }
+}
+
+/// \endcond
+
@@ -35,6 +35,9 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <algorithm>
+#include <vector>
+
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Distributions.h>
 #include <SkelCL/IndexVector.h>
@@ -42,6 +45,9 @@
 #include <SkelCL/Matrix.h>
 #include <SkelCL/Vector.h>
 
+#include <SkelCL/detail/Device.h>
+#include <SkelCL/detail/DeviceList.h>
+
 #include "Test.h"
 /// \cond
 /// Don't show this test in doxygen
@@ -377,5 +383,56 @@ TEST_F(DistributionTest, CopyDistribution6)
   }
 }
 
+TEST_F(DistributionTest, OverlapDistribution)
+{
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const unsigned int radius = 3;
+  skelcl::Vector<int> vi(1001);
+  for (size_t i = 0; i < vi.size(); ++i) {
+    vi[i] = static_cast<int>(i);
+  }
+  vi.setDistribution(skelcl::detail::OverlapDistribution< skelcl::Vector<int> >(
+        radius, skelcl::detail::Padding::NEAREST));
+  vi.createDeviceBuffers();
+  vi.copyDataToDevices();
+
+  // every device buffer stores its block plus radius elements on each side
+  int first = 0;
+  auto& devices = vi.distribution().devices();
+  for (size_t d = 0; d < devices.size(); ++d) {
+    auto& buffer = vi.deviceBuffer(*devices[d]);
+    std::vector<int> data(buffer.size());
+    devices[d]->enqueueRead(buffer, data.begin()).wait();
+
+    for (size_t i = 0; i < data.size(); ++i) {
+      int expected = first + static_cast<int>(i) - static_cast<int>(radius);
+      expected = std::max(0, std::min(expected, static_cast<int>(vi.size()) - 1));
+      EXPECT_EQ(expected, data[i]);
+    }
+    first += static_cast<int>(buffer.size() - 2 * radius);
+  }
+
+  // the halo is not written back to the host
+  vi.dataOnDeviceModified();
+  vi.copyDataToHost();
+  for (size_t i = 0; i < vi.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i), vi[i]);
+  }
+}
+
+TEST_F(DistributionTest, OverlapDistributionConversionKeepsNeutralElement)
+{
+  skelcl::detail::OverlapDistribution< skelcl::Vector<int> > dist(
+      2, skelcl::detail::Padding::NEUTRAL, -7);
+
+  skelcl::detail::OverlapDistribution< skelcl::Vector<float> > converted(dist);
+
+  EXPECT_EQ(2, converted.overlapRadius());
+  EXPECT_EQ(skelcl::detail::Padding::NEUTRAL, converted.padding());
+  EXPECT_EQ(-7.0f, converted.neutralElement());
+}
+
 /// \endcond
 
@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/Distributions.h>
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/Vector.h>
+#include <SkelCL/Expression.h>
+#include <SkelCL/Map.h>
+#include <SkelCL/Reduce.h>
+#include <SkelCL/Zip.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class ExpressionTest : public ::testing::Test {
+protected:
+  ExpressionTest() {
+    pvsutil::defaultLogger.setLoggingLevel(pvsutil::Logger::Severity::Debug);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~ExpressionTest() {
+    skelcl::terminate();
+  }
+};
+
+TEST_F(ExpressionTest, FusedMapZip) {
+  skelcl::Map<float(float)> square("float func(float x){ return x*x; }");
+  skelcl::Zip<float(float, float)> add(
+      "float func(float x, float y){ return x+y; }");
+
+  skelcl::Vector<float> a(1000);
+  skelcl::Vector<float> b(1000);
+  for (unsigned int i = 0; i < a.size(); ++i) {
+    a[i] = i % 10;
+    b[i] = 1.0f;
+  }
+
+  // b is converted into an expression reading it
+  skelcl::Vector<float> c = add(square(skelcl::lazy(a)), b);
+
+  EXPECT_EQ(a.size(), c.size());
+  for (unsigned int i = 0; i < c.size(); ++i) {
+    EXPECT_EQ((i % 10) * (i % 10) + 1.0f, c[i]);
+  }
+}
+
+TEST_F(ExpressionTest, DifferentTypesAndSharedInput) {
+  skelcl::Map<float(int)> half("float func(int x){ return x / 2.0f; }");
+  skelcl::Map<float(float)> twice("float func(float x){ return 2*x; }");
+  skelcl::Zip<float(float, float)> sub(
+      "float func(float x, float y){ return x-y; }");
+
+  skelcl::Vector<int> a(100);
+  for (unsigned int i = 0; i < a.size(); ++i) {
+    a[i] = i;
+  }
+
+  // a is read by both operands, but uploaded only once
+  auto input = skelcl::lazy(a);
+  auto expr = sub(twice(half(input)), half(input));
+
+  EXPECT_EQ(a.size(), expr.size());
+
+  skelcl::Vector<float> c;
+  expr.eval(skelcl::out(c));
+
+  for (unsigned int i = 0; i < c.size(); ++i) {
+    EXPECT_EQ(i / 2.0f, c[i]);
+  }
+}
+
+TEST_F(ExpressionTest, ConsumedByReduce) {
+  skelcl::Zip<int(int, int)> mult("int func(int x, int y){ return x*y; }");
+  skelcl::Reduce<int(int)> sum("int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> a(1000);
+  skelcl::Vector<int> b(1000);
+  for (unsigned int i = 0; i < a.size(); ++i) {
+    a[i] = i % 10;
+    b[i] = 2;
+  }
+
+  skelcl::Vector<int> output = sum(mult(skelcl::lazy(a), b));
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(9000, output[0]);
+}
+
+TEST_F(ExpressionTest, BlockDistributedExpression) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::Map<int(int)> inc("int func(int x){ return x+1; }");
+  skelcl::Zip<int(int, int)> add("int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> a(100003);
+  skelcl::Vector<int> b(100003);
+  for (unsigned int i = 0; i < a.size(); ++i) {
+    a[i] = i;
+    b[i] = 1;
+  }
+  // a and b are partitioned differently and have to be redistributed
+  a.setDistribution(skelcl::detail::BlockDistribution<skelcl::Vector<int>>());
+  b.setDistribution(skelcl::detail::SingleDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> c = add(inc(skelcl::lazy(a)), inc(skelcl::lazy(b)));
+
+  EXPECT_EQ(a.size(), c.size());
+  for (unsigned int i = 0; i < c.size(); ++i) {
+    EXPECT_EQ(i + 3, c[i]);
+  }
+}
+
+/// \endcond
+
@@ -35,14 +35,18 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <algorithm>
 #include <fstream>
 #include <cstdio>
+#include <string>
+#include <vector>
 
 #include <pvsutil/Logger.h>
 
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Matrix.h>
 #include <SkelCL/Vector.h>
+#include <SkelCL/Volume.h>
 #include <SkelCL/MapOverlap.h>
 
 #include "Test.h"
@@ -68,7 +72,6 @@ TEST_F(MapOverlapTest, CreateMapOverlapWithString) {
     { return -getData(f, 0, 0); }", 1};
 }
 
-#if 0
 TEST_F(MapOverlapTest, SimpleMapOverlap) {
   skelcl::MapOverlap<int(int)> m{
     "int func(__local int* f){ return f[0]; }", 1 };
@@ -89,7 +92,8 @@ TEST_F(MapOverlapTest, SimpleMapOverlap) {
 
 TEST_F(MapOverlapTest, SimpleMapOverlap2) {
   skelcl::MapOverlap<int(int)> m{
-    "int func(__local int* f){ return f[-1]+f[0]+f[1]; }", 1 };
+    "int func(__local int* f){ return f[-1]+f[0]+f[1]; }", 1,
+    skelcl::detail::Padding::NEUTRAL, 0 };
 
   skelcl::Vector<int> input(10);
   for (size_t i = 0; i < input.size(); ++i) {
@@ -127,7 +131,7 @@ TEST_F(MapOverlapTest, SimpleMapOverlapWithZeroOverlap) {
 
 TEST_F(MapOverlapTest, SimpleMultiDeviceMapOverlap) {
   skelcl::terminate();
-  skelcl::init(skelcl::nDevices(2));
+  skelcl::init(skelcl::allDevices());
   skelcl::MapOverlap<int(int)> m{
     "int func(__local int* f){ return f[0]; }", 1 };
 
@@ -147,9 +151,10 @@ TEST_F(MapOverlapTest, SimpleMultiDeviceMapOverlap) {
 
 TEST_F(MapOverlapTest, SimpleMultiDeviceMapOverlap2) {
   skelcl::terminate();
-  skelcl::init(skelcl::nDevices(2));
+  skelcl::init(skelcl::allDevices());
   skelcl::MapOverlap<int(int)> m{
-    "int func(__local int* f){ return f[-1] + f[0] + f[+1]; }", 1 };
+    "int func(__local int* f){ return f[-1] + f[0] + f[+1]; }", 1,
+    skelcl::detail::Padding::NEUTRAL, 0 };
 
   skelcl::Vector<int> input(499);
   for (size_t i = 0; i < input.size(); ++i) {
@@ -166,7 +171,27 @@ TEST_F(MapOverlapTest, SimpleMultiDeviceMapOverlap2) {
   }
   EXPECT_EQ(input[input.size()-2]+input[input.size()-1]+0, output.back());
 }
-#endif
+TEST_F(MapOverlapTest, VectorNearestPadding) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+  skelcl::MapOverlap<float(float)> m{
+    "float func(__local float* f){ return f[-2] + f[+2]; }", 2 };
+
+  skelcl::Vector<float> input(1000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = i;
+  }
+
+  skelcl::Vector<float> output;
+  m(skelcl::out(output), input);
+
+  EXPECT_EQ(1000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    auto left = (i < 2) ? 0 : i - 2;
+    auto right = (i + 2 >= input.size()) ? input.size() - 1 : i + 2;
+    EXPECT_EQ(input[left] + input[right], output[i]);
+  }
+}
 
 
 #if 0
@@ -510,5 +535,422 @@ TEST_F(MapOverlapTest, SimpleMatrixMultiDeviceMapOverlap2) {
 }
 #endif
 
+TEST_F(MapOverlapTest, IterateMatrixDownShift) {
+  auto size = 100u;
+  auto iterations = 5u;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f){ return getData(f, 0, -1); }", 1};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize{size, size} );
+  for (size_t i = 0; i < input.size().rowCount(); ++i) {
+    for (size_t j = 0; j < input.size().columnCount(); ++j) {
+      input[i][j] = i * size + j;
+    }
+  }
+
+  skelcl::Matrix<int> output;
+  m.iterate(iterations, skelcl::out(output), input);
+
+  EXPECT_EQ(size, output.size().rowCount());
+  EXPECT_EQ(size, output.size().columnCount());
+
+  for (size_t i = 0; i < output.size().rowCount(); ++i) {
+    auto row = (i < iterations) ? 0 : i - iterations;
+    for (size_t j = 0; j < output.size().columnCount(); ++j) {
+      EXPECT_EQ(input[row][j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, IterateMatrixMultiDeviceNeutral) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  auto size = 128u;
+  auto iterations = 4u;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return getData(f, 0, -1) + getData(f, 0, +1); }", 1,
+      skelcl::detail::Padding::NEUTRAL, 0};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize{size, size} );
+  for (size_t i = 0; i < input.size().rowCount(); ++i) {
+    for (size_t j = 0; j < input.size().columnCount(); ++j) {
+      input[i][j] = (i + j) % 7;
+    }
+  }
+
+  // compute the reference by repeatedly calling the skeleton
+  skelcl::Matrix<int> expected = m(input);
+  for (auto k = 1u; k < iterations; ++k) {
+    expected = m(expected);
+  }
+
+  skelcl::Matrix<int> output;
+  m.iterate(iterations, skelcl::out(output), input);
+
+  EXPECT_EQ(size, output.size().rowCount());
+  EXPECT_EQ(size, output.size().columnCount());
+
+  for (size_t i = 0; i < output.size().rowCount(); ++i) {
+    for (size_t j = 0; j < output.size().columnCount(); ++j) {
+      EXPECT_EQ(expected[i][j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, IterateMatrixTemporalBlocking) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  auto size = 128u;
+  auto iterations = 7u;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return (getData(f, -1, 0) + getData(f, +1, 0) \
+               + getData(f, 0, -1) + getData(f, 0, +1)) % 17; }", 1};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize{size, size} );
+  for (size_t i = 0; i < input.size().rowCount(); ++i) {
+    for (size_t j = 0; j < input.size().columnCount(); ++j) {
+      input[i][j] = (i * j + j) % 13;
+    }
+  }
+
+  skelcl::Matrix<int> expected;
+  m.iterate(iterations, skelcl::out(expected), input);
+
+  // perform three steps per kernel launch
+  m.setTimeSteps(3);
+  EXPECT_EQ(3, m.timeSteps());
+
+  skelcl::Matrix<int> output;
+  m.iterate(iterations, skelcl::out(output), input);
+
+  EXPECT_EQ(size, output.size().rowCount());
+  EXPECT_EQ(size, output.size().columnCount());
+
+  for (size_t i = 0; i < output.size().rowCount(); ++i) {
+    for (size_t j = 0; j < output.size().columnCount(); ++j) {
+      EXPECT_EQ(expected[i][j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, IterateMatrixTemporalBlockingNeutral) {
+  auto size = 100u;
+  auto iterations = 4u;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return getData(f, -2, 0) + getData(f, 0, +2); }", 2,
+      skelcl::detail::Padding::NEUTRAL, 1};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize{size, size} );
+  for (size_t i = 0; i < input.size().rowCount(); ++i) {
+    for (size_t j = 0; j < input.size().columnCount(); ++j) {
+      input[i][j] = (i + 2 * j) % 5;
+    }
+  }
+
+  skelcl::Matrix<int> expected;
+  m.iterate(iterations, skelcl::out(expected), input);
+
+  m.setTimeSteps(iterations);
+
+  skelcl::Matrix<int> output;
+  m.iterate(iterations, skelcl::out(output), input);
+
+  for (size_t i = 0; i < output.size().rowCount(); ++i) {
+    for (size_t j = 0; j < output.size().columnCount(); ++j) {
+      EXPECT_EQ(expected[i][j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, VolumeSevenPointNearest) {
+  const size_t slices = 20, rows = 19, cols = 23;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_volume_t v) \
+       { return getData(v, -1, 0, 0) + getData(v, +1, 0, 0) \
+              + getData(v, 0, -1, 0) + getData(v, 0, +1, 0) \
+              + getData(v, 0, 0, -1) + getData(v, 0, 0, +1) \
+              - 6 * getData(v, 0, 0, 0); }", 1};
+
+  skelcl::Volume<int> input( skelcl::VolumeSize{slices, rows, cols} );
+  for (size_t z = 0; z < slices; ++z) {
+    for (size_t y = 0; y < rows; ++y) {
+      for (size_t x = 0; x < cols; ++x) {
+        input(z, y, x) = (z * z + 3 * y + x * y) % 11;
+      }
+    }
+  }
+
+  skelcl::Volume<int> output = m(input);
+
+  EXPECT_EQ(input.size(), output.size());
+
+  auto at = [&](int z, int y, int x) {
+    z = std::min(std::max(z, 0), static_cast<int>(slices) - 1);
+    y = std::min(std::max(y, 0), static_cast<int>(rows) - 1);
+    x = std::min(std::max(x, 0), static_cast<int>(cols) - 1);
+    return input(z, y, x);
+  };
+  for (int z = 0; z < static_cast<int>(slices); ++z) {
+    for (int y = 0; y < static_cast<int>(rows); ++y) {
+      for (int x = 0; x < static_cast<int>(cols); ++x) {
+        auto expected = at(z, y, x - 1) + at(z, y, x + 1)
+                      + at(z, y - 1, x) + at(z, y + 1, x)
+                      + at(z - 1, y, x) + at(z + 1, y, x)
+                      - 6 * at(z, y, x);
+        EXPECT_EQ(expected, output(z, y, x));
+      }
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, VolumeTwentySevenPointMultiDeviceNeutral) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const size_t slices = 41, rows = 17, cols = 16;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_volume_t v) \
+       { int sum = 0; \
+         for (int z = -1; z <= 1; ++z) \
+           for (int y = -1; y <= 1; ++y) \
+             for (int x = -1; x <= 1; ++x) \
+               sum += getData(v, x, y, z); \
+         return sum; }", 1, skelcl::detail::Padding::NEUTRAL, 0};
+
+  skelcl::Volume<int> input( skelcl::VolumeSize{slices, rows, cols}, 1 );
+
+  skelcl::Volume<int> output;
+  m(skelcl::out(output), input);
+
+  // every element counts its neighbours inside of the volume
+  auto count = [](int i, int n) { return (i > 0) + 1 + (i < n - 1); };
+  for (int z = 0; z < static_cast<int>(slices); ++z) {
+    for (int y = 0; y < static_cast<int>(rows); ++y) {
+      for (int x = 0; x < static_cast<int>(cols); ++x) {
+        EXPECT_EQ(count(z, slices) * count(y, rows) * count(x, cols),
+                  output(z, y, x));
+      }
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, VolumeFewerSlicesThanDevices) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  // all devices but the last one store no slice of their own
+  const size_t slices = 1, rows = 9, cols = 11;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_volume_t v) \
+       { return getData(v, 0, 0, -1) + getData(v, 0, 0, 0) \
+              + getData(v, 0, 0, 1); }", 1,
+      skelcl::detail::Padding::NEUTRAL, 0};
+
+  skelcl::Volume<int> input( skelcl::VolumeSize{slices, rows, cols}, 3 );
+
+  skelcl::Volume<int> output = m(input);
+
+  EXPECT_EQ(input.size(), output.size());
+  for (size_t y = 0; y < rows; ++y) {
+    for (size_t x = 0; x < cols; ++x) {
+      EXPECT_EQ(3, output(0, y, x));
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, MatrixPeriodicMultiDevice) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const int rows = 37, cols = 29;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return getData(f, -1, 0) + 2 * getData(f, +1, 0) \
+              + 3 * getData(f, 0, -1) + 4 * getData(f, 0, +1); }", 1,
+      skelcl::detail::Padding::PERIODIC};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize(rows, cols) );
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      input[i][j] = (i * 7 + j * 3) % 19;
+    }
+  }
+
+  skelcl::Matrix<int> output = m(input);
+
+  auto at = [&](int i, int j) {
+    return input[(i + rows) % rows][(j + cols) % cols];
+  };
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      EXPECT_EQ(at(i, j - 1) + 2 * at(i, j + 1)
+                + 3 * at(i - 1, j) + 4 * at(i + 1, j),
+                output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, MatrixMirror) {
+  const int rows = 20, cols = 18;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return getData(f, -2, 0) + 10 * getData(f, 0, +2); }", 2,
+      skelcl::detail::Padding::MIRROR};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize(rows, cols) );
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      input[i][j] = i * cols + j;
+    }
+  }
+
+  skelcl::Matrix<int> output = m(input);
+
+  auto mirror = [](int i, int n) {
+    return (i < 0) ? -i - 1 : (i >= n) ? 2 * n - i - 1 : i;
+  };
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      EXPECT_EQ(input[i][mirror(j - 2, cols)]
+                + 10 * input[mirror(i + 2, rows)][j],
+                output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, MatrixClampMultiDevice) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const size_t size = 64;
+  const std::string func =
+      "int func(input_matrix_t f) \
+       { return getData(f, -2, -1) - getData(f, +2, +2); }";
+  skelcl::MapOverlap<int(int)> nearest{func, 2,
+                                       skelcl::detail::Padding::NEAREST};
+  skelcl::MapOverlap<int(int)> clamp{func, 2, skelcl::detail::Padding::CLAMP};
+
+  skelcl::Matrix<int> input( skelcl::MatrixSize(size, size) );
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      input[i][j] = (i * i + 5 * j) % 23;
+    }
+  }
+
+  skelcl::Matrix<int> expected = nearest(input);
+  skelcl::Matrix<int> output = clamp(input);
+
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      EXPECT_EQ(expected[i][j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, IterateMatrixPeriodicTemporalBlocking) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const int size = 48;
+  const unsigned int iterations = 5;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_matrix_t f) \
+       { return (getData(f, -1, 0) + getData(f, 0, +1) \
+               + 2 * getData(f, 0, 0)) % 101; }", 1,
+      skelcl::detail::Padding::PERIODIC};
+  m.setTimeSteps(2);
+
+  std::vector<int> expected(size * size);
+  skelcl::Matrix<int> input( skelcl::MatrixSize(size, size) );
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      input[i][j] = expected[i * size + j] = (3 * i + j) % 11;
+    }
+  }
+
+  for (unsigned int k = 0; k < iterations; ++k) {
+    std::vector<int> next(expected.size());
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        next[i * size + j] = (expected[i * size + (j + size - 1) % size]
+                              + expected[((i + 1) % size) * size + j]
+                              + 2 * expected[i * size + j]) % 101;
+      }
+    }
+    expected.swap(next);
+  }
+
+  skelcl::Matrix<int> output;
+  m.iterate(iterations, skelcl::out(output), input);
+
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      EXPECT_EQ(expected[i * size + j], output[i][j]);
+    }
+  }
+}
+
+TEST_F(MapOverlapTest, VectorMirror) {
+  skelcl::MapOverlap<int(int)> m{
+      "int func(__local int* f){ return f[-2] - f[+1]; }", 2,
+      skelcl::detail::Padding::MIRROR};
+
+  skelcl::Vector<int> input(10);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = i * i;
+  }
+
+  skelcl::Vector<int> output = m(input);
+
+  // mirrored: ... 1 0 | 0 1 4 .. 81 | 81 ...
+  EXPECT_EQ(1 - 1, output[0]);
+  EXPECT_EQ(0 - 4, output[1]);
+  for (size_t i = 2; i < 9; ++i) {
+    EXPECT_EQ(static_cast<int>((i - 2) * (i - 2) - (i + 1) * (i + 1)),
+              output[i]);
+  }
+  EXPECT_EQ(49 - 81, output[9]);
+}
+
+TEST_F(MapOverlapTest, VolumePeriodicMultiDevice) {
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  const int slices = 24, rows = 9, cols = 10;
+  skelcl::MapOverlap<int(int)> m{
+      "int func(input_volume_t v) \
+       { return getData(v, 0, 0, -1) + 2 * getData(v, 0, +1, 0) \
+              + 3 * getData(v, -1, 0, 0); }", 1,
+      skelcl::detail::Padding::PERIODIC};
+
+  skelcl::Volume<int> input( skelcl::VolumeSize(slices, rows, cols) );
+  for (int z = 0; z < slices; ++z) {
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        input(z, y, x) = (z * 5 + y * 3 + x) % 17;
+      }
+    }
+  }
+
+  skelcl::Volume<int> output = m(input);
+
+  auto at = [&](int z, int y, int x) {
+    return input((z + slices) % slices, (y + rows) % rows, (x + cols) % cols);
+  };
+  for (int z = 0; z < slices; ++z) {
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        EXPECT_EQ(at(z - 1, y, x) + 2 * at(z, y + 1, x) + 3 * at(z, y, x - 1),
+                  output(z, y, x));
+      }
+    }
+  }
+}
+
 /// \endcond
 
@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/Distributions.h>
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/Vector.h>
+#include <SkelCL/MapReduce.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class MapReduceTest : public ::testing::Test {
+protected:
+  MapReduceTest() {
+    pvsutil::defaultLogger.setLoggingLevel(pvsutil::Logger::Severity::Debug);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~MapReduceTest() {
+    skelcl::terminate();
+  }
+};
+
+TEST_F(MapReduceTest, SumOfSquares) {
+  skelcl::MapReduce<int(int)> mr("int func(int x){ return x*x; }",
+                                 "int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> input(1000);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = i % 10;
+  }
+
+  skelcl::Vector<int> output = mr(input);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(28500, output[0]); // 100 * (0 + 1 + 4 + ... + 81)
+}
+
+TEST_F(MapReduceTest, DifferentTypesAndAdditionalArg) {
+  skelcl::MapReduce<float(int)> mr(
+      "float func(int x, float scale){ return x * scale; }",
+      "float func(float x, float y){ return x+y; }");
+
+  skelcl::Vector<int> input(100);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = i;
+  }
+
+  skelcl::Vector<float> output = mr(input, 0.5f);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(2475.0f, output[0]);
+}
+
+TEST_F(MapReduceTest, EmptyInputYieldsIdentity) {
+  skelcl::MapReduce<int(int)> mr("int func(int x){ return x*x; }",
+                                 "int func(int x, int y){ return x*y; }",
+                                 "1");
+
+  skelcl::Vector<int> input;
+
+  skelcl::Vector<int> output = mr(input);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(1, output[0]);
+}
+
+TEST_F(MapReduceTest, BlockDistributedMapReduce) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::MapReduce<int(int)> mr("int func(int x){ return 2*x; }",
+                                 "int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> input(100003);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+  input.setDistribution(skelcl::detail::BlockDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> output = mr(input);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(200006, output[0]);
+}
+
+/// \endcond
+
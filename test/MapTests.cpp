@@ -37,7 +37,10 @@
 
 #include <fstream>
 
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <tuple>
 
 #include <pvsutil/Logger.h>
 
@@ -414,5 +417,169 @@ TEST_F(MapTest, MapDouble4) {
   }
 }
 
+TEST_F(MapTest, StreamingMap) {
+  // force streaming in chunks of 100 elements
+  setenv("SKELCL_CHUNK_SIZE", "100", 1);
+
+  skelcl::Map<float(float)> m{ "float func(float f){ return -f; }" };
+
+  skelcl::Vector<float> input(1050);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = i * 2.5f;
+  }
+
+  skelcl::Vector<float> output = m(input);
+
+  unsetenv("SKELCL_CHUNK_SIZE");
+
+  EXPECT_EQ(1050, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(-input[i], output[i]);
+  }
+}
+
+TEST_F(MapTest, MultipleOutputs) {
+  skelcl::Map<std::tuple<float, float, int>(float)> m(
+      "void func(float f, float* lo, float* hi, int* i)"
+      "{ *lo = floor(f); *hi = ceil(f); *i = (int)f; }");
+
+  skelcl::Vector<float> input(1000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = i * 0.25f;
+  }
+
+  skelcl::Vector<float> lo;
+  skelcl::Vector<float> hi;
+  skelcl::Vector<int>   truncated;
+  m(skelcl::out(lo), skelcl::out(hi), skelcl::out(truncated), input);
+
+  EXPECT_EQ(1000, lo.size());
+  EXPECT_EQ(1000, hi.size());
+  EXPECT_EQ(1000, truncated.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(std::floor(input[i]), lo[i]);
+    EXPECT_EQ(std::ceil(input[i]), hi[i]);
+    EXPECT_EQ(static_cast<int>(input[i]), truncated[i]);
+  }
+}
+
+TEST_F(MapTest, MultipleOutputsAddArgs) {
+  skelcl::Map<std::tuple<float, float>(float)> m(
+      "void func(float f, float* re, float* im, float scale)"
+      "{ *re = scale * cos(f); *im = scale * sin(f); }");
+
+  skelcl::Vector<float> input(100);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 0.0f;
+  }
+
+  skelcl::Vector<float> re;
+  skelcl::Vector<float> im;
+  m(skelcl::out(re), skelcl::out(im), input, 2.0f);
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(2.0f, re[i]);
+    EXPECT_EQ(0.0f, im[i]);
+  }
+}
+
+TEST_F(MapTest, BatchOfVectors) {
+  skelcl::Map<int(int)> m("int func(int x, int y){ return x * y; }");
+
+  std::vector<skelcl::Vector<int>> inputs;
+  for (int i = 0; i < 100; ++i) {
+    inputs.push_back(skelcl::Vector<int>(static_cast<size_t>(i % 7 + 1), i));
+  }
+  inputs.push_back(skelcl::Vector<int>());
+
+  std::vector<skelcl::Vector<int>> outputs;
+  m.batch(outputs, inputs, 3);
+
+  ASSERT_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(inputs[i].size(), outputs[i].size());
+    for (size_t j = 0; j < inputs[i].size(); ++j) {
+      EXPECT_EQ(3 * inputs[i][j], outputs[i][j]);
+    }
+  }
+}
+
+TEST_F(MapTest, BatchOfMatrices) {
+  skelcl::Map<float(float)> m("float func(float f){ return -f; }");
+
+  std::vector<skelcl::Matrix<float>> inputs;
+  for (size_t i = 1; i <= 10; ++i) {
+    inputs.push_back(skelcl::Matrix<float>(skelcl::MatrixSize(i, 2*i), 1.0f*i));
+  }
+
+  std::vector<skelcl::Matrix<float>> outputs;
+  m.batch(outputs, inputs);
+
+  ASSERT_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(inputs[i].size(), outputs[i].size());
+    for (size_t r = 0; r < inputs[i].rowCount(); ++r) {
+      for (size_t c = 0; c < inputs[i].columnCount(); ++c) {
+        EXPECT_EQ(-inputs[i][r][c], outputs[i][r][c]);
+      }
+    }
+  }
+}
+
+TEST_F(MapTest, BatchResizesReusedOutputs) {
+  skelcl::Map<float(float)> m("float func(float f){ return 2 * f; }");
+
+  std::vector<skelcl::Vector<float>> inputs;
+  inputs.push_back(skelcl::Vector<float>(3u, 1.0f));
+  inputs.push_back(skelcl::Vector<float>(5u, 2.0f));
+  inputs.push_back(skelcl::Vector<float>());
+
+  // outputs of a previous batch: too large, too small and not empty
+  std::vector<skelcl::Vector<float>> outputs;
+  outputs.push_back(skelcl::Vector<float>(10u, 9.0f));
+  outputs.push_back(skelcl::Vector<float>(1u, 9.0f));
+  outputs.push_back(skelcl::Vector<float>(4u, 9.0f));
+  outputs.push_back(skelcl::Vector<float>(4u, 9.0f));
+  m.batch(outputs, inputs);
+
+  ASSERT_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    ASSERT_EQ(inputs[i].size(), outputs[i].size());
+    for (size_t j = 0; j < inputs[i].size(); ++j) {
+      EXPECT_EQ(2 * inputs[i][j], outputs[i][j]);
+    }
+  }
+
+  // an empty batch leaves empty outputs
+  std::vector<skelcl::Vector<float>> empty(1);
+  m.batch(outputs, empty);
+  ASSERT_EQ(1, outputs.size());
+  EXPECT_TRUE(outputs[0].empty());
+}
+
+TEST_F(MapTest, BatchReshapesReusedMatrixOutputs) {
+  skelcl::Map<int(int)> m("int func(int x){ return x + 1; }");
+
+  std::vector<skelcl::Matrix<int>> inputs(1);
+  inputs[0] = skelcl::Matrix<int>(skelcl::MatrixSize(2, 3));
+  for (size_t r = 0; r < 2; ++r) {
+    for (size_t c = 0; c < 3; ++c) {
+      inputs[0][r][c] = static_cast<int>(r * 3 + c);
+    }
+  }
+
+  // same number of elements, but a different shape
+  std::vector<skelcl::Matrix<int>> outputs(1);
+  outputs[0] = skelcl::Matrix<int>(skelcl::MatrixSize(3, 2), -1);
+  m.batch(outputs, inputs);
+
+  EXPECT_EQ(skelcl::MatrixSize(2, 3), outputs[0].size());
+  for (size_t r = 0; r < 2; ++r) {
+    for (size_t c = 0; c < 3; ++c) {
+      EXPECT_EQ(inputs[0][r][c] + 1, outputs[0][r][c]);
+    }
+  }
+}
+
 /// \endcond
 
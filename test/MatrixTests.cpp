@@ -35,6 +35,9 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <cstdio>
+#include <fstream>
+
 #include <pvsutil/Logger.h>
 
 #include <SkelCL/Distributions.h>
@@ -98,5 +101,47 @@ TEST_F(MatrixTest, CreateMatrixFrom2DVector) {
 
 }
 
+TEST_F(MatrixTest, MoveFromStdVectorAndRelease) {
+  std::vector<int> vec(100);
+  for (unsigned int i = 0; i < 100; ++i) {
+    vec[i] = i;
+  }
+  auto data = vec.data();
+
+  skelcl::Matrix<int> mi(std::move(vec), skelcl::MatrixSize(10, 10));
+
+  EXPECT_EQ(100, mi.size().elemCount());
+  EXPECT_EQ(data, mi.hostData());
+  EXPECT_EQ(23, mi[2][3]);
+
+  std::vector<int> released = mi.release();
+
+  EXPECT_TRUE(mi.empty());
+  EXPECT_EQ(data, released.data());
+  EXPECT_EQ(100, released.size());
+}
+
+TEST_F(MatrixTest, MapFile) {
+  const char* path = "MatrixTest_MapFile.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    for (int i = 0; i < 100; ++i) {
+      file.write(reinterpret_cast<const char*>(&i), sizeof(int));
+    }
+  }
+
+  skelcl::Matrix<int> mi = skelcl::Matrix<int>::mapFile(path, 10, 10);
+
+  EXPECT_EQ(skelcl::MatrixSize(10, 10), mi.size());
+  for (size_t i = 0; i < 10; ++i) {
+    for (size_t j = 0; j < 10; ++j) {
+      EXPECT_EQ(i*10+j, mi({i,j}));
+    }
+  }
+
+  mi.clear();
+  std::remove(path);
+}
+
 /// \endcond
 
@@ -37,9 +37,12 @@
 ///
 
 #include <fstream>
+#include <cstdlib>
+#include <vector>
 
 #include <pvsutil/Logger.h>
 
+#include <SkelCL/Distributions.h>
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Vector.h>
 #include <SkelCL/Reduce.h>
@@ -169,5 +172,81 @@ TEST_F(ReduceTest, nSizesReduce2)
   }
 }
 
+TEST_F(ReduceTest, MaxWithoutIdentityPadding)
+{
+  // the identity 0 must not be used to pad partially filled work-groups
+  skelcl::Reduce<int(int)> r("int func(int x, int y){ return max(x, y); }");
+
+  skelcl::Vector<int> input(10007);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = -static_cast<int>(i) - 5;
+  }
+
+  skelcl::Vector<int> output = r(input);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(-5, output[0]);
+}
+
+TEST_F(ReduceTest, StreamingReduce)
+{
+  // force streaming in chunks of 10000 elements
+  setenv("SKELCL_CHUNK_SIZE", "10000", 1);
+
+  skelcl::Reduce<int(int)> r("int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> input(100500);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+
+  skelcl::Vector<int> output = r(input);
+
+  unsetenv("SKELCL_CHUNK_SIZE");
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(100500, output[0]);
+}
+
+TEST_F(ReduceTest, BlockDistributedReduce)
+{
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::Reduce<int(int)> r("int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> input(100003);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+  input.setDistribution(skelcl::detail::BlockDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> output = r(input);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(100003, output[0]);
+}
+
+TEST_F(ReduceTest, BatchOfVectors)
+{
+  skelcl::Reduce<int(int)> r("int func(int x, int y, int a){ return a*(x+y); }",
+                             "0");
+
+  std::vector<skelcl::Vector<int>> inputs;
+  for (int i = 0; i < 50; ++i) {
+    inputs.push_back(skelcl::Vector<int>(static_cast<size_t>(i * 97 + 1), i));
+  }
+  inputs.push_back(skelcl::Vector<int>());
+
+  skelcl::Vector<int> output;
+  r.batch(skelcl::out(output), inputs, 1);
+
+  ASSERT_EQ(inputs.size(), output.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(inputs[i].size() * i), output[i]);
+  }
+}
+
 /// \endcond
 
@@ -35,12 +35,15 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <algorithm>
 #include <fstream>
 
 #include <cstdio>
+#include <cstdlib>
 
 #include <pvsutil/Logger.h>
 
+#include <SkelCL/Distributions.h>
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Vector.h>
 #include <SkelCL/Scan.h>
@@ -106,5 +109,121 @@ TEST_F(ScanTest, SmallScan) {
   }
 }
 
+TEST_F(ScanTest, InclusiveScan) {
+  skelcl::Scan<int(int)> s{ "int func(int x, int y){ return x+y; }", "0",
+                            "func", skelcl::detail::ScanMode::INCLUSIVE };
+
+  skelcl::Vector<int> input(5000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+
+  skelcl::Vector<int> output = s(input);
+
+  EXPECT_EQ(5000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(i+1, output[i]);
+  }
+}
+
+TEST_F(ScanTest, AdditionalArgScan) {
+  // saturating addition
+  skelcl::Scan<int(int)> s{
+      "int func(int x, int y, int limit){ return min(x+y, limit); }" };
+
+  skelcl::Vector<int> input(5000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+
+  skelcl::Vector<int> output = s(input, 1000);
+
+  EXPECT_EQ(5000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(std::min<size_t>(i, 1000), output[i]);
+  }
+}
+
+TEST_F(ScanTest, SegmentedScan) {
+  skelcl::Scan<int(int)> s{ "int func(int x, int y){ return x+y; }" };
+
+  // segments of length 1000
+  skelcl::Vector<int> input(5000);
+  skelcl::Vector<int> flags(5000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+    flags[i] = (i % 1000 == 0);
+  }
+
+  skelcl::Vector<int> output = s.segmented(input, flags);
+
+  EXPECT_EQ(5000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(i % 1000, output[i]);
+  }
+}
+
+TEST_F(ScanTest, InclusiveSegmentedScan) {
+  skelcl::Scan<int(int)> s{ "int func(int x, int y){ return x+y; }", "0",
+                            "func", skelcl::detail::ScanMode::INCLUSIVE };
+
+  // segments of length 7
+  skelcl::Vector<int> input(5000);
+  skelcl::Vector<int> flags(5000);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+    flags[i] = (i % 7 == 0);
+  }
+
+  skelcl::Vector<int> output = s.segmented(input, flags);
+
+  EXPECT_EQ(5000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(i % 7 + 1, output[i]);
+  }
+}
+
+TEST_F(ScanTest, SinglePassScan) {
+  // force the decoupled look-back scan
+  setenv("SKELCL_SCAN_SINGLE_PASS", "1", 1);
+
+  skelcl::Scan<int(int)> s{ "int func(int x, int y){ return x+y; }" };
+
+  skelcl::Vector<int> input(100003);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+
+  skelcl::Vector<int> output = s(input);
+
+  unsetenv("SKELCL_SCAN_SINGLE_PASS");
+
+  EXPECT_EQ(100003, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(i, output[i]);
+  }
+}
+
+TEST_F(ScanTest, BlockDistributedScan) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::Scan<int(int)> s{ "int func(int x, int y){ return x+y; }" };
+
+  skelcl::Vector<int> input(100003);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1;
+  }
+  input.setDistribution(skelcl::detail::BlockDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> output = s(input);
+
+  EXPECT_EQ(100003, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(i, output[i]);
+  }
+}
+
 /// \endcond
 
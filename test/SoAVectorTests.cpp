@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/IndexVector.h>
+#include <SkelCL/Map.h>
+#include <SkelCL/SoAVector.h>
+#include <SkelCL/Vector.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class SoAVectorTest : public ::testing::Test {
+protected:
+  SoAVectorTest() {
+    pvsutil::defaultLogger.setLoggingLevel(pvsutil::Logger::Severity::Debug);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~SoAVectorTest() {
+    skelcl::terminate();
+  }
+};
+
+TEST_F(SoAVectorTest, CreateSoAVector) {
+  skelcl::SoAVector<float, int> v(10);
+
+  EXPECT_FALSE(v.empty());
+  EXPECT_EQ(10, v.size());
+  EXPECT_EQ(2, v.fieldCount());
+  EXPECT_EQ(10, v.field<0>().size());
+  EXPECT_EQ(10, v.field<1>().size());
+
+  v.get<0>(3) = 1.5f;
+  v.get<1>(3) = 7;
+  EXPECT_EQ(1.5f, v.field<0>()[3]);
+  EXPECT_EQ(7, v.field<1>()[3]);
+
+  v.resize(20);
+  EXPECT_EQ(20, v.size());
+  EXPECT_EQ(20, v.field<1>().size());
+}
+
+TEST_F(SoAVectorTest, CreateFromVectors) {
+  skelcl::Vector<float> x(5, 1.0f);
+  skelcl::Vector<float> y(5, 2.0f);
+
+  skelcl::SoAVector<float, float> v(std::move(x), std::move(y));
+
+  EXPECT_EQ(5, v.size());
+  for (size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(1.0f, v.get<0>(i));
+    EXPECT_EQ(2.0f, v.get<1>(i));
+  }
+}
+
+TEST_F(SoAVectorTest, MapWithFields) {
+  const size_t size = 1024;
+  skelcl::SoAVector<float, float> particles(size); // position and velocity
+  for (size_t i = 0; i < size; ++i) {
+    particles.get<0>(i) = i;
+    particles.get<1>(i) = 2.0f;
+  }
+
+  skelcl::Map<void(skelcl::Index)> step(
+      "void func(Index i, __global float* pos, __global float* vel, float dt)"
+      "{ pos[i] += vel[i] * dt; }");
+
+  step(skelcl::IndexVector(size), skelcl::out(particles), 0.5f);
+
+  for (size_t i = 0; i < size; ++i) {
+    EXPECT_EQ(i + 1.0f, particles.get<0>(i));
+    EXPECT_EQ(2.0f, particles.get<1>(i));
+  }
+}
+
+TEST_F(SoAVectorTest, MapSingleField) {
+  skelcl::SoAVector<float, int> v(100);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v.get<0>(i) = i;
+  }
+
+  skelcl::Map<float(float)> neg("float func(float f){ return -f; }");
+
+  neg(skelcl::out(v.field<0>()), v.field<0>());
+
+  for (size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(-static_cast<float>(i), v.get<0>(i));
+  }
+}
+
+/// \endcond
+
@@ -35,12 +35,19 @@
 /// \author Michel Steuwer <michel.steuwer@uni-muenster.de>
 ///
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
 #include <pvsutil/Logger.h>
 
 #include <SkelCL/Distributions.h>
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Vector.h>
 
+#include <SkelCL/detail/DeviceList.h>
+#include <SkelCL/detail/MemoryManager.h>
+
 #include "Test.h"
 /// \cond
 /// Don't show this test in doxygen
@@ -194,5 +201,135 @@ TEST_F(VectorTest, CompleteInitialization) {
   EXPECT_EQ(42,   positions[23*768+42]._y);
 }
 
+TEST_F(VectorTest, MoveFromStdVector) {
+  std::vector<int> v(10, 5);
+  auto data = v.data();
+
+  skelcl::Vector<int> vi(std::move(v));
+
+  EXPECT_EQ(10, vi.size());
+  EXPECT_EQ(data, vi.hostData());
+  for (unsigned i = 0; i < vi.size(); ++i) {
+    EXPECT_EQ(5, vi[i]);
+  }
+}
+
+TEST_F(VectorTest, Release) {
+  skelcl::Vector<int> vi(5u, 5);
+  vi.setDistribution(skelcl::detail::SingleDistribution< skelcl::Vector<int> >());
+  vi.createDeviceBuffers();
+  vi.copyDataToDevices();
+  vi.dataOnDeviceModified(); // fake modification on the device
+
+  std::vector<int> v = vi.release();
+
+  EXPECT_TRUE(vi.empty());
+  EXPECT_EQ(5, v.size());
+  for (unsigned i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(5, v[i]);
+  }
+}
+
+TEST_F(VectorTest, Wrap) {
+  int data[5] = { 1, 2, 3, 4, 5 };
+
+  skelcl::Vector<int> vi = skelcl::Vector<int>::wrap(data, 5);
+
+  EXPECT_EQ(5, vi.size());
+  EXPECT_EQ(data, vi.hostData());
+  EXPECT_EQ(3, vi[2]);
+
+  vi.setDistribution(skelcl::detail::SingleDistribution< skelcl::Vector<int> >());
+  vi.createDeviceBuffers();
+  vi.copyDataToDevices();
+
+  for (unsigned i = 0; i < 5; ++i) {
+    data[i] = 0;
+  }
+
+  vi.dataOnDeviceModified(); // fake modification on the device
+  vi.copyDataToHost();       // downloads directly into data
+
+  for (unsigned i = 0; i < 5; ++i) {
+    EXPECT_EQ(i+1, data[i]);
+  }
+
+  // accessing the host buffer ends the borrowing
+  vi.hostBuffer();
+  vi[0] = 42;
+  EXPECT_EQ(1, data[0]);
+  EXPECT_NE(data, vi.hostData());
+}
+
+TEST_F(VectorTest, MapFile) {
+  const char* path = "VectorTest_MapFile.bin";
+  {
+    auto vi = skelcl::Vector<int>::mapFile(path,
+                                           skelcl::detail::MapMode::CREATE,
+                                           10);
+    EXPECT_EQ(10, vi.size());
+    for (unsigned i = 0; i < vi.size(); ++i) {
+      vi[i] = i;
+    }
+  } // file is unmapped and written back
+
+  {
+    auto vi = skelcl::Vector<int>::mapFile(path);
+    EXPECT_EQ(10, vi.size());
+
+    vi.setDistribution(skelcl::detail::SingleDistribution< skelcl::Vector<int> >());
+    vi.createDeviceBuffers();
+    vi.copyDataToDevices();
+    vi.dataOnDeviceModified(); // fake modification on the device
+
+    for (unsigned i = 0; i < vi.size(); ++i) {
+      EXPECT_EQ(i, vi[i]);
+    }
+  }
+
+  std::remove(path);
+}
+
+TEST_F(VectorTest, EvictLeastRecentlyUsed) {
+  // allow only 1 MB per device
+  setenv("SKELCL_DEVICE_MEMORY_BUDGET", "1", 1);
+
+  auto& device = *skelcl::detail::globalDeviceList.front();
+  const size_t size = 128 * 1024; // 512 KB
+
+  skelcl::Vector<int> a(size, 1);
+  skelcl::Vector<int> b(size, 2);
+  for (auto v : { &a, &b }) {
+    v->setDistribution(skelcl::detail::SingleDistribution< skelcl::Vector<int> >());
+    v->createDeviceBuffers();
+    v->copyDataToDevices();
+    v->dataOnDeviceModified(); // fake modification on the device
+  }
+  // pretend a kernel using a and b has been enqueued
+  skelcl::detail::globalMemoryManager.kernelEnqueued();
+
+  skelcl::Vector<int> c(size, 3);
+  c.setDistribution(skelcl::detail::SingleDistribution< skelcl::Vector<int> >());
+  c.createDeviceBuffers(); // evicts a
+
+  EXPECT_GE(skelcl::detail::globalMemoryManager.budget(device),
+            skelcl::detail::globalMemoryManager.usedMemory(device));
+  EXPECT_TRUE(a.hostIsUpToDate());
+  EXPECT_FALSE(a.devicesAreUpToDate());
+  EXPECT_TRUE(b.devicesAreUpToDate());
+
+  // accessing the buffer of a recreates it (and evicts b)
+  EXPECT_TRUE(a.deviceBuffer(device).isValid());
+  EXPECT_TRUE(a.devicesAreUpToDate());
+  EXPECT_FALSE(b.devicesAreUpToDate());
+
+  unsetenv("SKELCL_DEVICE_MEMORY_BUDGET");
+
+  for (unsigned i = 0; i < size; ++i) {
+    ASSERT_EQ(1, a[i]);
+    ASSERT_EQ(2, b[i]);
+  }
+}
+
 /// \endcond
 
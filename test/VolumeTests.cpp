@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/Distributions.h>
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/Volume.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class VolumeTest : public ::testing::Test {
+protected:
+  VolumeTest() {
+    pvsutil::defaultLogger.setLoggingLevel(pvsutil::Logger::Severity::Debug);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~VolumeTest() {
+    skelcl::terminate();
+  }
+};
+
+TEST_F(VolumeTest, CreateEmptyVolume) {
+  skelcl::Volume<float> vi;
+
+  EXPECT_TRUE(vi.empty());
+  EXPECT_EQ(skelcl::VolumeSize(0, 0, 0), vi.size());
+}
+
+TEST_F(VolumeTest, CreateVolume) {
+  skelcl::Volume<int> vi( {4, 3, 2}, 5 );
+
+  EXPECT_FALSE(vi.empty());
+  EXPECT_EQ(24, vi.size().elemCount());
+  EXPECT_EQ(6, vi.size().sliceSize());
+  for (size_t z = 0; z < 4; ++z) {
+    for (size_t y = 0; y < 3; ++y) {
+      for (size_t x = 0; x < 2; ++x) {
+        EXPECT_EQ(5, vi(z, y, x));
+      }
+    }
+  }
+}
+
+TEST_F(VolumeTest, SlabDistribution) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::Volume<int> vi( {9, 4, 5} );
+  for (size_t z = 0; z < vi.sliceCount(); ++z) {
+    for (size_t y = 0; y < vi.rowCount(); ++y) {
+      for (size_t x = 0; x < vi.columnCount(); ++x) {
+        vi(z, y, x) = (z * 4 + y) * 5 + x;
+      }
+    }
+  }
+
+  vi.setDistribution(skelcl::detail::OLDistribution<skelcl::Volume<int>>(
+      2, skelcl::detail::Padding::NEUTRAL, -1));
+  vi.createDeviceBuffers();
+  vi.copyDataToDevices();
+  vi.dataOnDeviceModified(); // fake modification on the device
+
+  // the data is downloaded from the slabs of all devices
+  for (size_t z = 0; z < vi.sliceCount(); ++z) {
+    for (size_t y = 0; y < vi.rowCount(); ++y) {
+      for (size_t x = 0; x < vi.columnCount(); ++x) {
+        EXPECT_EQ((z * 4 + y) * 5 + x, vi(z, y, x));
+      }
+    }
+  }
+}
+
+/// \endcond
@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * Copyright (c) 2011-2012 The SkelCL Team as listed in CREDITS.txt          *
+ * http://skelcl.uni-muenster.de                                             *
+ *                                                                           *
+ * This file is part of SkelCL.                                              *
+ * SkelCL is available under multiple licenses.                              *
+ * The different licenses are subject to terms and condition as provided     *
+ * in the files specifying the license. See "LICENSE.txt" for details        *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * SkelCL is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU General Public License as published by      *
+ * the Free Software Foundation, either version 3 of the License, or         *
+ * (at your option) any later version. See "LICENSE-gpl.txt" for details.    *
+ *                                                                           *
+ * SkelCL is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the              *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * For non-commercial academic use see the license specified in the file     *
+ * "LICENSE-academic.txt".                                                   *
+ *                                                                           *
+ *****************************************************************************
+ *                                                                           *
+ * If you are interested in other licensing models, including a commercial-  *
+ * license, please contact the author at michel.steuwer@uni-muenster.de      *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <pvsutil/Logger.h>
+
+#include <SkelCL/Distributions.h>
+#include <SkelCL/SkelCL.h>
+#include <SkelCL/Vector.h>
+#include <SkelCL/ZipReduce.h>
+
+#include "Test.h"
+/// \cond
+/// Don't show this test in doxygen
+
+class ZipReduceTest : public ::testing::Test {
+protected:
+  ZipReduceTest() {
+    pvsutil::defaultLogger.setLoggingLevel(pvsutil::Logger::Severity::Debug);
+    skelcl::init(skelcl::nDevices(1));
+  }
+
+  ~ZipReduceTest() {
+    skelcl::terminate();
+  }
+};
+
+TEST_F(ZipReduceTest, DotProduct) {
+  skelcl::ZipReduce<int(int, int)> dot(
+      "int func(int x, int y){ return x*y; }",
+      "int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> left(1000);
+  skelcl::Vector<int> right(1000);
+  for (unsigned int i = 0; i < left.size(); ++i) {
+    left[i]  = i % 10;
+    right[i] = 2;
+  }
+
+  skelcl::Vector<int> output = dot(left, right);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(9000, output[0]); // 2 * 100 * (0 + 1 + ... + 9)
+}
+
+TEST_F(ZipReduceTest, DifferentTypesAndAdditionalArg) {
+  skelcl::ZipReduce<float(int, float)> zr(
+      "float func(int x, float y, float scale){ return x * y * scale; }",
+      "float func(float x, float y){ return x+y; }");
+
+  skelcl::Vector<int> left(100);
+  skelcl::Vector<float> right(100);
+  for (unsigned int i = 0; i < left.size(); ++i) {
+    left[i]  = i;
+    right[i] = 2.0f;
+  }
+
+  skelcl::Vector<float> output = zr(left, right, 0.5f);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(4950.0f, output[0]);
+}
+
+TEST_F(ZipReduceTest, EmptyInputsYieldIdentity) {
+  skelcl::ZipReduce<int(int, int)> zr(
+      "int func(int x, int y){ return x+y; }",
+      "int func(int x, int y){ return x*y; }",
+      "1");
+
+  skelcl::Vector<int> left;
+  skelcl::Vector<int> right;
+
+  skelcl::Vector<int> output = zr(left, right);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(1, output[0]);
+}
+
+TEST_F(ZipReduceTest, BlockDistributedZipReduce) {
+  // use all available devices
+  skelcl::terminate();
+  skelcl::init(skelcl::allDevices());
+
+  skelcl::ZipReduce<int(int, int)> dot(
+      "int func(int x, int y){ return x*y; }",
+      "int func(int x, int y){ return x+y; }");
+
+  skelcl::Vector<int> left(100003);
+  skelcl::Vector<int> right(100003);
+  for (unsigned int i = 0; i < left.size(); ++i) {
+    left[i]  = 1;
+    right[i] = 3;
+  }
+  left.setDistribution(skelcl::detail::BlockDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> output = dot(left, right);
+
+  EXPECT_LE(1, output.size());
+  EXPECT_EQ(300009, output[0]);
+}
+
+/// \endcond
+
@@ -36,11 +36,14 @@
 ///
 
 #include <fstream>
+#include <vector>
 
 #include <cstdio>
+#include <cstdlib>
 
 #include <pvsutil/Logger.h>
 
+#include <SkelCL/Distributions.h>
 #include <SkelCL/SkelCL.h>
 #include <SkelCL/Vector.h>
 #include <SkelCL/Zip.h>
@@ -213,5 +216,99 @@ TEST_F(ZipTest, VoidAddArgs) {
   }
 }
 
+TEST_F(ZipTest, StreamingZip) {
+  // force streaming in chunks of 100 elements
+  setenv("SKELCL_CHUNK_SIZE", "100", 1);
+
+  skelcl::Zip<float(float, float)> z(
+      "float func(float x, float y, float add){ return x+y+add; }");
+
+  skelcl::Vector<float> left(1050);
+  skelcl::Vector<float> right(1050);
+  for (size_t i = 0; i < left.size(); ++i) {
+    left[i]  = i * 2.5f;
+    right[i] = i * 7.5f;
+  }
+
+  auto output = z(left, right, 1.0f);
+
+  unsetenv("SKELCL_CHUNK_SIZE");
+
+  EXPECT_EQ(1050, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(left[i]+right[i]+1.0f, output[i]);
+  }
+}
+
+TEST_F(ZipTest, ThreeInputs) {
+  skelcl::Zip<float(float, int, float)> z(
+      "float func(float a, int b, float c){ return a*b+c; }");
+
+  skelcl::Vector<float> a(1000);
+  skelcl::Vector<int>   b(1000);
+  skelcl::Vector<float> c(1000);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = i * 0.5f;
+    b[i] = i % 3;
+    c[i] = 1.0f;
+  }
+
+  skelcl::Vector<float> output = z(a, b, c);
+
+  EXPECT_EQ(1000, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(a[i]*b[i]+c[i], output[i]);
+  }
+}
+
+TEST_F(ZipTest, FourInputsAddArgs) {
+  skelcl::Zip<int(int, int, int, int)> z(
+      "int func(int a, int b, int c, int d, int factor)"
+      "{ return factor*(a+b+c+d); }");
+
+  skelcl::Vector<int> a(100);
+  skelcl::Vector<int> b(100);
+  skelcl::Vector<int> c(100);
+  skelcl::Vector<int> d(100);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = 1; b[i] = 2; c[i] = 3; d[i] = 4;
+  }
+  // inputs with different distributions are redistributed
+  b.setDistribution(skelcl::detail::CopyDistribution<skelcl::Vector<int>>());
+
+  skelcl::Vector<int> output(100);
+  z(skelcl::out(output), a, b, c, d, 2);
+
+  EXPECT_EQ(100, output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(20, output[i]);
+  }
+}
+
+TEST_F(ZipTest, BatchOfVectors) {
+  skelcl::Zip<int(int, int)> zip("int func(int x, int y, int a){ return a*x + y; }");
+
+  std::vector<skelcl::Vector<int>> lefts;
+  std::vector<skelcl::Vector<int>> rights;
+  for (int i = 0; i < 50; ++i) {
+    auto size = static_cast<size_t>(i % 5 + 1);
+    lefts.push_back(skelcl::Vector<int>(size, i));
+    // right containers may be longer than the left ones
+    rights.push_back(skelcl::Vector<int>(size + i % 2, 1));
+  }
+
+  // a reused output with a different size
+  std::vector<skelcl::Vector<int>> outputs(1, skelcl::Vector<int>(100u, -1));
+  zip.batch(outputs, lefts, rights, 2);
+
+  ASSERT_EQ(lefts.size(), outputs.size());
+  for (size_t i = 0; i < lefts.size(); ++i) {
+    ASSERT_EQ(lefts[i].size(), outputs[i].size());
+    for (size_t j = 0; j < lefts[i].size(); ++j) {
+      EXPECT_EQ(2 * lefts[i][j] + 1, outputs[i][j]);
+    }
+  }
+}
+
 /// \endcond
 